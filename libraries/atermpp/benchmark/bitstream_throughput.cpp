@@ -0,0 +1,96 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "benchmark_shared.h"
+
+#include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/atermpp/aterm_io_binary.h"
+#include "mcrl2/utilities/bitstream.h"
+
+#include <random>
+#include <sstream>
+
+using namespace mcrl2::utilities;
+
+/// \brief Prints the throughput of an operation on the given number of bytes.
+static void report(const char* name, stopwatch& timer, std::size_t bytes)
+{
+  double seconds = timer.seconds();
+  std::cerr << name << ": " << seconds << " s, "
+    << static_cast<double>(bytes) / (1024 * 1024) / seconds << " MiB/s" << std::endl;
+}
+
+int main(int, char*[])
+{
+  std::size_t size = 10000000;
+
+  // Fields with the widths that occur in the binary aterm format: a packet header, a function symbol index and a
+  // number of term indices, interleaved with integers.
+  std::mt19937_64 generator(0);
+  std::vector<std::size_t> indices(size);
+  for (std::size_t& index : indices)
+  {
+    index = generator() % (std::size_t(1) << 20);
+  }
+
+  std::stringstream stream;
+  {
+    stopwatch timer;
+    obitstream output(stream);
+    for (std::size_t i = 0; i < size; i += 4)
+    {
+      output.write_bits(i % 4, 2);
+      output.write_bits(indices[i] % 1024, 10);
+      output.write_bits(indices.data() + i, 3, 20);
+      output.write_integer(indices[i + 3]);
+    }
+    report("write fields", timer, stream.tellp());
+  }
+
+  {
+    stopwatch timer;
+    ibitstream input(stream);
+    std::size_t arguments[3];
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i < size; i += 4)
+    {
+      sum += input.read_bits(2);
+      sum += input.read_bits(10);
+      input.read_bits(arguments, 3, 20);
+      sum += arguments[0] + arguments[1] + arguments[2];
+      sum += input.read_integer();
+    }
+    report("read fields", timer, stream.tellp());
+    std::cerr << "checksum: " << sum << std::endl;
+  }
+
+  // A term with many shared subterms and integers, written with the binary aterm format.
+  function_symbol f("f", 2);
+  aterm term = aterm_int(0);
+  for (std::size_t i = 0; i < size / 10; ++i)
+  {
+    term = aterm_appl(f, term, aterm_int(indices[i]));
+  }
+
+  std::stringstream term_stream;
+  {
+    stopwatch timer;
+    atermpp::binary_aterm_ostream(term_stream) << term;
+    report("write term", timer, term_stream.tellp());
+  }
+
+  {
+    stopwatch timer;
+    aterm result;
+    atermpp::binary_aterm_istream(term_stream) >> result;
+    report("read term", timer, term_stream.tellp());
+  }
+
+  return 0;
+}
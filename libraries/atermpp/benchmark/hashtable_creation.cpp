@@ -0,0 +1,99 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "benchmark_shared.h"
+
+#include "mcrl2/utilities/open_addressing_set.h"
+
+#include <random>
+
+/// \brief A binary function application, which is hash-consed in the same way as the terms of the term pool.
+struct node
+{
+  node(std::size_t symbol, const node* left, const node* right)
+    : symbol(symbol), left(left), right(right)
+  {}
+
+  std::size_t symbol;
+  const node* left;
+  const node* right;
+};
+
+struct node_hash
+{
+  using is_transparent = void;
+
+  std::size_t operator()(const node& n) const { return operator()(n.symbol, n.left, n.right); }
+
+  std::size_t operator()(std::size_t symbol, const node* left, const node* right) const
+  {
+    std::size_t hnr = symbol;
+    hnr = (hnr << 1) + (hnr >> 1) + reinterpret_cast<std::size_t>(left);
+    hnr = (hnr << 1) + (hnr >> 1) + reinterpret_cast<std::size_t>(right);
+    return hnr;
+  }
+};
+
+struct node_equals
+{
+  using is_transparent = void;
+
+  bool operator()(const node& n, const node& m) const { return operator()(n, m.symbol, m.left, m.right); }
+
+  bool operator()(const node& n, std::size_t symbol, const node* left, const node* right) const
+  {
+    return n.symbol == symbol && n.left == left && n.right == right;
+  }
+};
+
+/// \brief Creates random nodes from the nodes that were created before, of which part already exists, and looks
+///        them up again afterwards.
+template<typename Set>
+void benchmark_set(const char* name, std::size_t number_of_threads, std::size_t size)
+{
+  Set set(size);
+  const node* leaf = &*set.emplace(0, nullptr, nullptr).first;
+
+  std::cerr << name << " ";
+  benchmark_threads(number_of_threads, [&](std::size_t id) -> void
+    {
+      std::mt19937 generator(static_cast<std::mt19937::result_type>(id));
+      std::vector<const node*> nodes = { leaf };
+
+      for (std::size_t i = 0; i < size / number_of_threads; ++i)
+      {
+        const node* left = nodes[generator() % nodes.size()];
+        const node* right = nodes[generator() % nodes.size()];
+        nodes.push_back(&*set.emplace(generator() % 4, left, right).first);
+      }
+
+      for (const node* n : nodes)
+      {
+        set.emplace(n->symbol, n->left, n->right);
+      }
+    });
+}
+
+int main(int argc, char* argv[])
+{
+  std::size_t number_of_threads = 1;
+
+  // Accept one argument for the number of threads.
+  if (argc > 1)
+  {
+    number_of_threads = static_cast<std::size_t>(std::stoi(argv[1]));
+  }
+
+  std::size_t size = 4000000;
+
+  benchmark_set<mcrl2::utilities::unordered_set<node, node_hash, node_equals, std::allocator<node>, true, false>>("bucket lists", number_of_threads, size);
+  benchmark_set<mcrl2::utilities::open_addressing_set<node, node_hash, node_equals, std::allocator<node>, true, false>>("open addressing", number_of_threads, size);
+
+  return 0;
+}
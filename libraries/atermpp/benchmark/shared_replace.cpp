@@ -0,0 +1,57 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "benchmark_shared.h"
+
+#include "mcrl2/atermpp/algorithm.h"
+
+using namespace atermpp;
+
+int main(int, char*[])
+{
+  // A term in which every level refers twice to the level below it, so it has 2^depth paths to its only leaf.
+  std::size_t depth = 22;
+  function_symbol f("f", 2);
+  aterm_appl c(function_symbol("c", 0));
+  aterm_appl d(function_symbol("d", 0));
+
+  aterm_appl term = c;
+  for (std::size_t i = 0; i < depth; ++i)
+  {
+    term = aterm_appl(f, term, term);
+  }
+
+  // Replaces the leaf, so every level of the term is rebuilt.
+  auto replace_leaf = [&](const aterm_appl& x) -> aterm_appl
+    {
+      return x == c ? d : x;
+    };
+
+  aterm_appl result;
+  {
+    stopwatch timer;
+    result = replace(term, replace_leaf);
+    std::cerr << "replace: " << timer.seconds() << " s" << std::endl;
+  }
+
+  {
+    stopwatch timer;
+    std::unordered_map<aterm_appl, aterm> cache;
+    aterm_appl cached_result = replace(term, replace_leaf, cache);
+    std::cerr << "replace with cache: " << timer.seconds() << " s" << std::endl;
+
+    if (cached_result != result)
+    {
+      std::cerr << "the results differ" << std::endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -60,6 +60,51 @@ make_replace_aterm_builder(ReplaceFunction f)
   return replace_aterm_builder<Builder, ReplaceFunction>(f);
 }
 
+template <template <class> class Builder, class ReplaceFunction>
+struct cached_replace_aterm_builder: public Builder<cached_replace_aterm_builder<Builder, ReplaceFunction> >
+{
+  typedef Builder<cached_replace_aterm_builder<Builder, ReplaceFunction> > super;
+  using super::enter;
+  using super::leave;
+  using super::apply;
+  using super::derived;
+
+  ReplaceFunction f;
+  std::unordered_map<aterm_appl, aterm>& cache;
+
+  cached_replace_aterm_builder(ReplaceFunction f_, std::unordered_map<aterm_appl, aterm>& cache_)
+    : f(f_), cache(cache_)
+  {}
+
+  template <class T>
+  void apply(T& result, const aterm_appl& x)
+  {
+    auto i = cache.find(x);
+    if (i != cache.end())
+    {
+      result = static_cast<const T&>(i->second);
+      return;
+    }
+    const T fx(f(x));
+    if (x == fx)
+    {
+      super::apply(result, x);
+    }
+    else
+    {
+      result = fx;
+    }
+    cache[x] = result;
+  }
+};
+
+template <template <class> class Builder, class ReplaceFunction>
+cached_replace_aterm_builder<Builder, ReplaceFunction>
+make_cached_replace_aterm_builder(ReplaceFunction f, std::unordered_map<aterm_appl, aterm>& cache)
+{
+  return cached_replace_aterm_builder<Builder, ReplaceFunction>(f, cache);
+}
+
 template <template <class> class Builder, class ReplaceFunction>
 struct partial_replace_aterm_builder: public Builder<partial_replace_aterm_builder<Builder, ReplaceFunction> >
 {
@@ -250,6 +295,25 @@ Term replace(const Term& t, ReplaceFunction r)
   return result;
 }
 
+/// \brief Replaces each subterm x of t by r(x). The ReplaceFunction r has
+/// the following signature:
+/// aterm_appl x;
+/// aterm_appl result = r(x);
+/// The replacements are performed in top down order. Every distinct subterm
+/// is visited only once, which is much faster than replace(t, r) if t has
+/// many shared subterms, but requires that r(x) only depends on x.
+/// \param t A term
+/// \param r The replace function that is applied to subterms.
+/// \param cache A cache for the result of aterm_appl terms.
+/// \return The result of the replacement.
+template <typename Term, typename ReplaceFunction>
+Term replace(const Term& t, ReplaceFunction r, std::unordered_map<aterm_appl, aterm>& cache)
+{
+  Term result;
+  detail::make_cached_replace_aterm_builder<atermpp::builder>(r, cache).apply(result, t);
+  return result;
+}
+
 /// \brief Replaces each subterm in t that is equal to old_value with new_value.
 /// The replacements are performed in top down order. For example,
 /// replace(f(f(x)), f(x), x) returns f(x) and not x.
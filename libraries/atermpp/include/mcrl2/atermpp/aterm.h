@@ -14,6 +14,7 @@
 #include <assert.h>
 #include <sstream>
 #include "mcrl2/atermpp/detail/aterm.h"
+#include "mcrl2/atermpp/detail/term_arena.h"
 #include "mcrl2/atermpp/type_traits.h"
 
 /// \brief The main namespace for the aterm++ library.
@@ -31,7 +32,7 @@ class unprotected_aterm
   friend detail::_aterm* detail::address(const unprotected_aterm& t);
 
 protected:
-  const detail::_aterm* m_term;
+  detail::term_pointer m_term;
 
 public:
 
@@ -363,7 +364,7 @@ namespace detail
   /// \returns A pointer to the underlying aterm.
   inline _aterm* address(const unprotected_aterm& t)
   {
-    return const_cast<_aterm*>(t.m_term);
+    return const_cast<_aterm*>(static_cast<const _aterm*>(t.m_term));
   }
 }
 
@@ -31,7 +31,7 @@ protected:
    : aterm(reinterpret_cast<detail::_aterm*>(t))
   {
     static_assert(std::is_base_of<aterm, Term>::value,"Term must be derived from an aterm");
-    static_assert(sizeof(Term)==sizeof(std::size_t),"Term derived from an aterm must not have extra fields");
+    static_assert(sizeof(Term)==sizeof(aterm),"Term derived from an aterm must not have extra fields");
   }
 
 public:
@@ -70,7 +70,7 @@ public:
   {
     assert(type_is_appl());
     static_assert(std::is_base_of<aterm, Term>::value,"Term must be derived from an aterm");
-    static_assert(sizeof(Term)==sizeof(std::size_t),"Term derived from an aterm must not have extra fields");
+    static_assert(sizeof(Term)==sizeof(aterm),"Term derived from an aterm must not have extra fields");
   } 
 
   /// This class has user-declared copy constructor so declare default copy and move operators.
@@ -97,7 +97,7 @@ public:
   {
     detail::g_thread_term_pool().create_appl_dynamic(*this, sym, begin, end);
     static_assert((std::is_base_of<aterm, Term>::value),"Term must be derived from an aterm");
-    static_assert(sizeof(Term)==sizeof(std::size_t),"Term derived from an aterm must not have extra fields");
+    static_assert(sizeof(Term)==sizeof(aterm),"Term derived from an aterm must not have extra fields");
     static_assert(!std::is_same<typename ForwardIterator::iterator_category, std::input_iterator_tag>::value,
                   "A forward iterator has more requirements than an input iterator.");
     static_assert(!std::is_same<typename ForwardIterator::iterator_category, std::output_iterator_tag>::value,
@@ -120,7 +120,7 @@ public:
     : term_appl(sym, begin, end, [](const Term& term) -> const Term& { return term; } )
   {
     static_assert((std::is_base_of<aterm, Term>::value),"Term must be derived from an aterm");
-    static_assert(sizeof(Term)==sizeof(std::size_t),"Term derived from an aterm must not have extra fields");
+    static_assert(sizeof(Term)==sizeof(aterm),"Term derived from an aterm must not have extra fields");
     static_assert(std::is_same<typename InputIterator::iterator_category, std::input_iterator_tag>::value,
                   "The InputIterator is missing the input iterator tag.");
   }
@@ -143,7 +143,7 @@ public:
   {
     detail::g_thread_term_pool().create_appl_dynamic(*this, sym, converter, begin, end);
     static_assert(std::is_base_of<aterm, Term>::value,"Term must be derived from an aterm");
-    static_assert(sizeof(Term)==sizeof(std::size_t),"Term derived from an aterm must not have extra fields");
+    static_assert(sizeof(Term)==sizeof(aterm),"Term derived from an aterm must not have extra fields");
     static_assert(!std::is_same<typename InputIterator::iterator_category, std::output_iterator_tag>::value,
                   "The InputIterator has the output iterator tag.");
   }
@@ -154,7 +154,7 @@ public:
   {
     detail::g_thread_term_pool().create_term(*this, sym);
     static_assert(std::is_base_of<aterm, Term>::value,"Term must be derived from an aterm");
-    static_assert(sizeof(Term)==sizeof(std::size_t),"Term derived from an aterm must not have extra fields");
+    static_assert(sizeof(Term)==sizeof(aterm),"Term derived from an aterm must not have extra fields");
   }
 
   /// \brief Constructor for n-arity function application.
@@ -166,7 +166,7 @@ public:
     detail::g_thread_term_pool().create_appl<Term>(*this, symbol, arguments...);
     static_assert(detail::are_terms<Terms...>::value, "Arguments of function application should be terms.");
     static_assert(std::is_base_of<aterm, Term>::value,"Term must be derived from an aterm");
-    static_assert(sizeof(Term)==sizeof(std::size_t),"Term derived from an aterm must not have extra fields");
+    static_assert(sizeof(Term)==sizeof(aterm),"Term derived from an aterm must not have extra fields");
   }
 
   /// \brief Returns the function symbol belonging to an aterm_appl.
@@ -194,14 +194,14 @@ public:
   /// \return An iterator pointing to the first argument.
   const_iterator begin() const
   {
-    return const_iterator(reinterpret_cast<const Term*>(&(reinterpret_cast<const detail::_term_appl*>(m_term)->arg(0))));
+    return const_iterator(reinterpret_cast<const Term*>(&(reinterpret_cast<const detail::_term_appl*>(detail::address(*this))->arg(0))));
   }
 
   /// \brief Returns a const_iterator pointing past the last argument.
   /// \return A const_iterator pointing past the last argument.
   const_iterator end() const
   {
-    return const_iterator(reinterpret_cast<const Term*>(&reinterpret_cast<const detail::_term_appl*>(m_term)->arg(size())));
+    return const_iterator(reinterpret_cast<const Term*>(&reinterpret_cast<const detail::_term_appl*>(detail::address(*this))->arg(size())));
   }
 
   /// \brief Returns the largest possible number of arguments.
@@ -217,7 +217,7 @@ public:
   const Term& operator[](const size_type i) const
   {
     assert(i < size()); // Check the bounds.
-    return reinterpret_cast<const detail::_term_appl*>(m_term)->arg(i);
+    return reinterpret_cast<const detail::_term_appl*>(detail::address(*this))->arg(i);
   }
 };
 
@@ -244,7 +244,7 @@ void make_term_appl(Term& target,
   detail::g_thread_term_pool().create_appl_dynamic(target, sym, begin, end);
   
   static_assert((std::is_base_of<aterm, Term>::value),"Term must be derived from an aterm");
-  static_assert(sizeof(Term)==sizeof(std::size_t),"Term derived from an aterm must not have extra fields");
+  static_assert(sizeof(Term)==sizeof(aterm),"Term derived from an aterm must not have extra fields");
   static_assert(!std::is_same<typename ForwardIterator::iterator_category, std::input_iterator_tag>::value,
                 "A forward iterator has more requirements than an input iterator.");
   static_assert(!std::is_same<typename ForwardIterator::iterator_category, std::output_iterator_tag>::value,
@@ -272,7 +272,7 @@ void make_term_appl(Term& target,
   make_term_appl(target, sym, begin, end, [](const Term& term) -> const Term& { return term; } );
 
   static_assert((std::is_base_of<aterm, Term>::value),"Term must be derived from an aterm");
-  static_assert(sizeof(Term)==sizeof(std::size_t),"Term derived from an aterm must not have extra fields");
+  static_assert(sizeof(Term)==sizeof(aterm),"Term derived from an aterm must not have extra fields");
   static_assert(std::is_same<typename InputIterator::iterator_category, std::input_iterator_tag>::value,
                 "The InputIterator is missing the input iterator tag.");
 }
@@ -300,7 +300,7 @@ void make_term_appl(Term& target,
   detail::g_thread_term_pool().create_appl_dynamic(target, sym, converter, begin, end);
 
   static_assert(std::is_base_of<aterm, Term>::value,"Term must be derived from an aterm");
-  static_assert(sizeof(Term)==sizeof(std::size_t),"Term derived from an aterm must not have extra fields");
+  static_assert(sizeof(Term)==sizeof(aterm),"Term derived from an aterm must not have extra fields");
   static_assert(!std::is_same<typename InputIterator::iterator_category, std::output_iterator_tag>::value,
                 "The InputIterator has the output iterator tag.");
 }
@@ -315,7 +315,7 @@ void make_term_appl(Term& target,
   detail::g_thread_term_pool().create_term(target, sym);
 
   static_assert(std::is_base_of<aterm, Term>::value,"Term must be derived from an aterm");
-  static_assert(sizeof(Term)==sizeof(std::size_t),"Term derived from an aterm must not have extra fields");
+  static_assert(sizeof(Term)==sizeof(aterm),"Term derived from an aterm must not have extra fields");
 }
 
 /// \brief Make an aterm application for n-arity function application.
@@ -331,7 +331,7 @@ void make_term_appl(Term& target, const function_symbol& symbol, const Terms& ..
   // TODO: enable the static_assert below. Doesn't seem to work properly now. 
   // static_assert(detail::are_terms_or_functions<Terms...>::value, "Arguments of function application should be terms.");
   static_assert(std::is_base_of<aterm, Term>::value,"Term must be derived from an aterm");
-  static_assert(sizeof(Term)==sizeof(std::size_t),"Term derived from an aterm must not have extra fields");
+  static_assert(sizeof(Term)==sizeof(aterm),"Term derived from an aterm must not have extra fields");
 }
 
 /// \brief Constructor for n-arity function application with an index.
@@ -347,7 +347,7 @@ void make_term_appl_with_index(aterm& target, const function_symbol& symbol, con
   // TODO: enable the static_assert below. Doesn't seem to work properly now. 
   // static_assert(detail::are_terms_or_functions<Terms...>::value, "Arguments of function application should be terms.");
   static_assert(std::is_base_of<aterm, Term>::value,"Term must be derived from an aterm");
-  static_assert(sizeof(Term)==sizeof(std::size_t),"Term derived from an aterm must not have extra fields");
+  static_assert(sizeof(Term)==sizeof(aterm),"Term derived from an aterm must not have extra fields");
 }
 
 typedef term_appl<aterm> aterm_appl;
@@ -82,6 +82,10 @@ private:
 
   std::shared_ptr<mcrl2::utilities::ibitstream> m_stream;
 
+  bool m_chunked = false; ///< The stream is in the chunked format, of which the terms are read at once.
+  std::vector<aterm> m_chunked_terms; ///< The terms of a chunked stream and the end marker, read by the first get().
+  std::size_t m_next_chunked_term = 0; ///< The index in m_chunked_terms of the term that get() returns next.
+
   unsigned int m_term_index_width; ///< caches the result of term_index_width().
   unsigned int m_function_symbol_index_width; ///< caches the result of function_symbol_index_width().
 
@@ -89,6 +93,25 @@ private:
   std::deque<function_symbol> m_function_symbols; ///< An index of read function symbols.
 };
 
+/// \brief Writes the given terms in the chunked binary aterm format, which several threads encode at once.
+/// \details The chunked format extends the streamable format under its own version. After the header follow all
+///          function symbols, a prefix chunk that contains the subterms that occur in more than one chunk, and the
+///          other chunks. Each of these contains consecutive terms of the given terms and their other subterms,
+///          encoded with the packets of the streamable format, where the indices of a chunk continue after those of
+///          the prefix. Therefore, every chunk can be decoded independently once the prefix has been read. The
+///          division into chunks does not depend on the number of threads, so the output is always the same.
+///          A binary_aterm_istream reads the terms from a chunked stream in order, followed by the end of the stream.
+/// \param number_of_threads The number of threads that encode chunks.
+/// \param compress If true, every chunk is compressed with a fast block codec when that makes it smaller.
+void write_terms_to_chunked_binary_stream(std::ostream& os,
+  const std::vector<aterm>& terms,
+  std::size_t number_of_threads = 1,
+  bool compress = false);
+
+/// \brief Reads the terms from a stream in the chunked binary aterm format.
+/// \param number_of_threads The number of threads that decode chunks.
+void read_terms_from_chunked_binary_stream(std::istream& is, std::vector<aterm>& terms, std::size_t number_of_threads = 1);
+
 } // namespace atermpp
 
 bool is_a_binary_aterm(std::istream& is);
@@ -184,10 +184,14 @@ public:
   constexpr bool has_free_slots() const noexcept { return false; }
 
 private:
-  std::allocator<char> m_packed_allocator;
+  term_allocator<char> m_packed_allocator;
 };
 
+#ifdef MCRL2_ATERMPP_COMPRESSED_REFERENCES
+static_assert(sizeof(aterm) == sizeof(std::uint32_t), "Sanity check: compressed term reference size");
+#else
 static_assert(sizeof(_term_appl) == sizeof(_aterm) + sizeof(aterm), "Sanity check: aterm_appl size");
+#endif
 
 template < class Derived, class Base >
 term_appl_iterator<Derived> aterm_appl_iterator_cast(term_appl_iterator<Base> a,
@@ -12,6 +12,8 @@
 
 #include "mcrl2/utilities/configuration.h"
 
+#include <cstddef>
+
 namespace atermpp
 {
 namespace detail
@@ -27,9 +29,18 @@ constexpr static bool GlobalThreadSafe = false;
 /// \brief Enable garbage collection.
 constexpr static bool EnableGarbageCollection = true;
 
+/// \brief The minimal number of terms that are created between two collections of only the young terms, or zero
+///        to always collect all terms, see aterm_pool::set_nursery_size.
+constexpr static std::size_t DefaultNurserySize = 1 << 20;
+
 /// \brief Enable the block allocator for terms.
 constexpr static bool EnableBlockAllocator = false;
 
+/// \brief Use an open addressing hash table instead of a table of bucket lists to keep the terms unique.
+/// \details Open addressing is faster for terms that are looked up in random order, but bucket lists benefit
+///          more from the locality of the hashes of terms that are created after each other.
+constexpr static bool EnableOpenAddressing = false;
+
 /// \brief Enable to print garbage collection statistics.
 constexpr static bool EnableGarbageCollectionMetrics = false;
 
@@ -42,11 +53,23 @@ constexpr static bool EnableCreationMetrics = false;
 /// \brief Keep track of the number of variables registered.
 constexpr static bool EnableVariableRegistrationMetrics = false;
 
+/// \brief Allow the term pool to be profiled per function symbol, see atermpp::enable_term_profile.
+/// \details When disabled, the creation of a term no longer checks whether the profile is enabled.
+constexpr static bool EnableTermProfile = true;
+
 /// \brief Switch between reference counting and tracking term variables.
 /// \details This is a macro because for constexpr booleans we cannot change inheritance and remove members.
 ///          Outcomment to enable the protection set approach to protect aterms. 
 // #define MCRL2_ATERMPP_REFERENCE_COUNTED
 
+/// \brief Switch between addressing terms by pointers and by 32-bit references.
+/// \details With compressed references all terms are allocated in one reserved region of virtual memory, see
+///          term_arena, and terms refer to each other by their offset in this region. This halves the size of term
+///          references and of the arguments of terms, but it limits the memory of all terms together to 32 GiB.
+///          This is a macro because it changes the layout of terms. Outcomment, or define it for all compilation
+///          units, to enable compressed references.
+// #define MCRL2_ATERMPP_COMPRESSED_REFERENCES
+
 } // namespace detail
 } // namespace atermpp
 
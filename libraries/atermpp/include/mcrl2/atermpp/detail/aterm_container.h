@@ -261,14 +261,14 @@ public:
   operator T&()
   {
     static_assert(std::is_base_of<aterm, T>::value,"Term must be derived from an aterm");
-    static_assert(sizeof(T)==sizeof(std::size_t),"Term derived from an aterm must not have extra fields");
+    static_assert(sizeof(T)==sizeof(aterm),"Term derived from an aterm must not have extra fields");
     return reinterpret_cast<T&>(*this);
   }
 
   operator const T&() const
   {
     static_assert(std::is_base_of<aterm, T>::value,"Term must be derived from an aterm");
-    static_assert(sizeof(T)==sizeof(std::size_t),"Term derived from an aterm must not have extra fields");
+    static_assert(sizeof(T)==sizeof(aterm),"Term derived from an aterm must not have extra fields");
     return reinterpret_cast<const T&>(*this);
 
   }
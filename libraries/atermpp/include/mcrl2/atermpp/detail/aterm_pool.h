@@ -12,6 +12,14 @@
 
 #include "mcrl2/atermpp/detail/aterm_pool_storage.h"
 #include "mcrl2/atermpp/detail/function_symbol_pool.h"
+#include "mcrl2/atermpp/detail/term_profile.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 namespace atermpp
 {
@@ -36,8 +44,16 @@ class thread_aterm_pool_interface
 public:
   virtual ~thread_aterm_pool_interface() {}
 
-  /// \brief Mark the terms created by this thread to prevent them being garbage collected.
-  virtual void mark() = 0;
+  /// \brief Mark the terms referred to by the variables of this thread to prevent them being garbage collected.
+  virtual void mark_variables(std::stack<std::reference_wrapper<_aterm>>& todo) = 0;
+
+  /// \brief Mark the terms in the containers of this thread to prevent them being garbage collected.
+  /// \details Marking a container may create temporary terms, which are protected by the calling thread.
+  virtual void mark_containers(std::stack<std::reference_wrapper<_aterm>>& todo) = 0;
+
+  /// \returns The terms that this thread has created since the previous garbage collection, if the young
+  ///          terms are collected separately.
+  virtual std::vector<_aterm*>& young_terms() = 0;
 
   /// \brief Print performance statistics for data stored for this thread.
   virtual void print_local_performance_statistics() const = 0;
@@ -57,6 +73,20 @@ public:
 
 class thread_aterm_pool;
 
+/// \brief True iff the current thread is a helper thread of the garbage collection.
+inline thread_local bool g_is_collection_helper = false;
+
+/// \brief The terms that reside in memory that is not owned by the pool, such as a memory mapped file, see
+///        load_term_region. These terms are never garbage collected.
+struct term_region
+{
+  /// \brief The terms that have been constructed in the memory of the region.
+  std::vector<_aterm*> terms;
+
+  /// \brief The terms outside of the region that are used by the region.
+  std::vector<_aterm*> external_terms;
+};
+
 /// \brief The interface for the term library. Provides the storage of
 ///        of all classes of terms.
 /// \details Internally uses different storage objects to store specific
@@ -119,6 +149,42 @@ public:
 
   inline function_symbol_pool& get_symbol_pool() { return m_function_symbol_pool; }
 
+  /// \brief Sets the number of threads that mark and sweep the terms during garbage collection.
+  /// \details The default, zero, uses one thread for each registered thread aterm pool, but not more
+  ///          than the number of hardware threads.
+  inline void set_collection_threads(std::size_t number_of_threads) { m_collection_threads = number_of_threads; }
+
+  /// \brief Sets the minimal number of terms that are created between two collections of the young terms.
+  /// \details The terms that have been created since the previous garbage collection are young. They are
+  ///          collected separately, which only requires marking the young terms that are reachable.
+  ///          The surviving terms become old, and all terms are collected when the number of old terms has
+  ///          doubled. Zero disables the separate collection of young terms.
+  inline void set_nursery_size(std::size_t number_of_terms);
+
+  /// \returns True iff the young terms are collected separately.
+  bool collects_young_terms() const { return m_nursery_size != 0; }
+
+  /// \returns The number of bytes that a term with the given function symbol occupies in a term region.
+  inline std::size_t region_size(const function_symbol& symbol);
+
+  /// \brief Constructs a term in the memory of a term region, unless an equal term exists already.
+  /// \param arguments The arguments of a function application.
+  /// \param value The value of an integral term.
+  /// \details Requires exclusive access to the pool, see thread_aterm_pool::lock().
+  /// \returns The unique term, which resides in the given memory iff it did not exist before.
+  inline _aterm* adopt_term(char* memory, const function_symbol& symbol, const unprotected_aterm* arguments, std::size_t value);
+
+  /// \brief Adds a term region of which the terms are reachable until the end of the program.
+  /// \details Requires exclusive access to the pool.
+  void add_term_region(term_region&& region) { m_term_regions.emplace_back(std::move(region)); }
+
+  /// \brief Starts profiling the terms of this pool, and writes the profile to the given file.
+  /// \details Requires exclusive access to the pool, see thread_aterm_pool::lock().
+  inline void enable_profile(const std::string& filename);
+
+  /// \returns The profile of the terms of this pool, which only records anything when it is enabled.
+  term_profile& profile() noexcept { return m_profile; }
+
   // These functions of the aterm pool should be called through a thread_aterm_pool.
 private:
 
@@ -128,10 +194,47 @@ private:
   /// \threadsafe
   inline void created_term(bool allow_collect, thread_aterm_pool_interface* thread);
 
-  /// \brief Collect garbage on all storages.
+  /// \brief Collect garbage on all storages, or only the young terms if only the nursery is full.
   /// \threadsafe
   inline void collect_impl(thread_aterm_pool_interface* thread);
 
+  /// \brief Applies the function to the young terms of all thread pools.
+  template<typename Function>
+  inline void for_each_young_term(Function f);
+
+  /// \brief Marks the terms of the term regions, and the terms that they use, as reachable.
+  inline void mark_term_regions(bool young_collection);
+
+  /// \brief Destroys the young terms that have not been reached, and forgets the young terms.
+  /// \returns The number of young terms that survived.
+  inline std::size_t sweep_young_terms();
+
+  /// \brief Applies the function to the storage that contains the given term.
+  template<typename Function>
+  inline void for_storage_of(const _aterm& term, Function f);
+
+  /// \returns The number of threads that take part in the next garbage collection.
+  inline std::size_t collection_threads() const;
+
+  using mark_roots_function = void (thread_aterm_pool_interface::*)(std::stack<std::reference_wrapper<_aterm>>&);
+
+  /// \brief Marks the terms that are reachable from the given roots of all thread pools with the given number of threads.
+  inline void mark_in_parallel(std::size_t number_of_threads, mark_roots_function mark_roots);
+
+  /// \brief Sweeps the storages with the given number of threads.
+  inline void sweep_in_parallel(std::size_t number_of_threads);
+
+  /// \brief Runs the task on the calling thread and on number_of_threads - 1 helper threads, and
+  ///        waits until all of them are finished.
+  inline void run_collection_task(std::size_t number_of_threads, const std::function<void()>& task);
+
+  /// \brief The loop of the helper thread with the given index, which waits for the tasks after the given round.
+  inline void collection_helper(std::size_t index, std::size_t round);
+
+  /// \brief Applies the function to each of the storages.
+  template<typename Function>
+  inline void for_each_storage(Function f);
+
   /// \brief Creates a integral term with the given value.
   inline bool create_int(aterm& term, std::size_t val);
 
@@ -212,6 +315,45 @@ private:
 
   /// Represents an empty list.
   aterm m_empty_list;
+
+  /// A reusable todo stack for marking.
+  std::stack<std::reference_wrapper<_aterm>> m_todo;
+
+  /// The helper threads of the garbage collection. They are started when needed and wait for the tasks of
+  /// the next collection afterwards, and protect their own temporary terms, see g_is_collection_helper.
+  std::size_t m_collection_threads = 0;
+  std::size_t m_number_of_helpers = 0;
+  std::mutex m_helper_mutex;
+  std::condition_variable m_helper_start;
+  std::condition_variable m_helper_done;
+  const std::function<void()>* m_helper_task = nullptr;
+  std::size_t m_helper_round = 0;
+  std::size_t m_helper_participants = 0;
+  std::size_t m_helpers_active = 0;
+  std::exception_ptr m_helper_exception;
+
+  /// The young terms of thread pools that have been removed.
+  std::vector<_aterm*> m_orphaned_young_terms;
+
+  /// The term regions, of which the terms are never garbage collected.
+  std::vector<term_region> m_term_regions;
+
+  /// The configured and current number of terms that are created between two collections of the young terms.
+  std::size_t m_nursery_size = DefaultNurserySize;
+  std::size_t m_young_collection_threshold = DefaultNurserySize;
+  std::atomic<long> m_count_until_young_collection = DefaultNurserySize;
+
+  /// The number of garbage collections, and the total time spent in each of their phases.
+  std::size_t m_number_of_collections = 0;
+  std::size_t m_number_of_young_collections = 0;
+  std::size_t m_number_of_promoted_terms = 0;
+  std::chrono::duration<double, std::milli> m_mark_variables_time{0};
+  std::chrono::duration<double, std::milli> m_mark_containers_time{0};
+  std::chrono::duration<double, std::milli> m_sweep_time{0};
+  std::chrono::duration<double, std::milli> m_function_symbol_sweep_time{0};
+
+  /// The profile of the terms per function symbol, see atermpp::enable_term_profile.
+  term_profile m_profile;
 };
 
 } // namespace detail
@@ -11,9 +11,12 @@
 #define ATERMPP_DETAIL_ATERM_POOL_IMPLEMENTATION_H
 #pragma once
 
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include "aterm_pool.h"
 #include "aterm_pool_storage_implementation.h"   // For store_in_argument_array. 
+#include "mcrl2/utilities/memory_barrier.h"
 
 
 namespace atermpp
@@ -38,6 +41,15 @@ aterm_pool::aterm_pool() :
   m_count_until_collection = capacity();
   m_count_until_resize = m_int_storage.capacity();
   
+  // Profile the terms from the start if requested, such that the counts include all terms.
+  if (EnableTermProfile)
+  {
+    if (const char* filename = std::getenv("MCRL2_TERM_PROFILE"))
+    {
+      enable_profile(filename);
+    }
+  }
+
   // Initialize the empty list.
   create_appl(m_empty_list, m_function_symbol_pool.as_empty_list());
 }
@@ -94,6 +106,13 @@ void aterm_pool::collect()
 
 void aterm_pool::register_thread_aterm_pool(thread_aterm_pool_interface& pool)
 {
+  if (g_is_collection_helper)
+  {
+    // The helpers of the garbage collection only protect temporary terms during a collection, which
+    // refer to terms that are marked already. They register while the collecting thread holds m_mutex.
+    return;
+  }
+
   if constexpr (GlobalThreadSafe) { m_mutex.lock(); }
 #ifdef MCRL2_THREAD_SAFE
   mCRL2log(mcrl2::log::debug) << "Registered thread_local aterm pool\n";
@@ -105,6 +124,8 @@ void aterm_pool::register_thread_aterm_pool(thread_aterm_pool_interface& pool)
 
 void aterm_pool::remove_thread_aterm_pool(thread_aterm_pool_interface& pool)
 {
+  if (g_is_collection_helper) { return; }
+
   if constexpr (GlobalThreadSafe) { m_mutex.lock(); }
 
 #ifdef MCRL2_THREAD_SAFE
@@ -113,6 +134,9 @@ void aterm_pool::remove_thread_aterm_pool(thread_aterm_pool_interface& pool)
   auto it = std::find(m_thread_pools.begin(), m_thread_pools.end(), &pool);
   if (it != m_thread_pools.end())
   {
+    // The young terms of the pool remain young, as old terms must not refer to young terms.
+    m_orphaned_young_terms.insert(m_orphaned_young_terms.end(), pool.young_terms().begin(), pool.young_terms().end());
+
     m_thread_pools.erase(it);  // This only removes the pointer, not the underlying data
                                // structure, which only disappears when the thread is removed. 
   }
@@ -135,6 +159,17 @@ void aterm_pool::print_performance_statistics() const
 
   m_appl_dynamic_storage.print_performance_stats("arbitrary_function_application_storage");
 
+  if (EnableGarbageCollectionMetrics)
+  {
+    mCRL2log(mcrl2::log::info, "Performance") << "aterm_pool: " << m_number_of_collections + m_number_of_young_collections << " garbage collections took "
+      << m_mark_variables_time.count() << " ms to mark the variables, "
+      << m_mark_containers_time.count() << " ms to mark the containers, "
+      << m_sweep_time.count() << " ms to sweep the terms and "
+      << m_function_symbol_sweep_time.count() << " ms to sweep the function symbols, including "
+      << m_number_of_young_collections << " collections of the young terms, in which "
+      << m_number_of_promoted_terms << " terms survived.\n";
+  }
+
 #ifdef MCRL2_ATERMPP_REFERENCE_COUNTED
   if (mcrl2::utilities::EnableReferenceCountMetrics)
   {
@@ -182,14 +217,20 @@ std::size_t aterm_pool::size() const
 
 void aterm_pool::created_term(bool allow_collect, thread_aterm_pool_interface* thread)
 {
-  // Defer garbage collection when it happens too often.
-  if (m_count_until_collection.load(std::memory_order_relaxed) <= 0)
+  // Defer garbage collection when it happens too often. When the young terms are collected separately, only
+  // the terms that survive a collection of the young terms count towards a collection of all terms.
+  if (m_count_until_collection.load(std::memory_order_relaxed) <= 0
+      || (collects_young_terms() && m_count_until_young_collection.load(std::memory_order_relaxed) <= 0))
   {
     if (allow_collect)
     {
       collect_impl(thread);
     }
   }
+  else if (collects_young_terms())
+  {
+    m_count_until_young_collection.fetch_sub(1, std::memory_order_relaxed);
+  }
   else
   {
     m_count_until_collection.fetch_sub(1, std::memory_order_relaxed);
@@ -213,7 +254,8 @@ void aterm_pool::collect_impl(thread_aterm_pool_interface* thread)
   if (!m_enable_garbage_collection) { return; }
 
   lock(thread);
-  if (m_count_until_collection > 0)
+  const bool young_collection = m_count_until_collection > 0;
+  if (young_collection && (!collects_young_terms() || m_count_until_young_collection > 0))
   {
     // Another thread has performed garbage collection, so we can ignore it.
     unlock();
@@ -221,6 +263,21 @@ void aterm_pool::collect_impl(thread_aterm_pool_interface* thread)
   }
   auto timestamp = std::chrono::system_clock::now();
   std::size_t old_size = size();
+  const std::size_t number_of_threads = collection_threads();
+
+  std::size_t number_of_young_terms = 0;
+  if (young_collection)
+  {
+    // Mark the young terms, which are unmarked when they are reached.
+    for_each_young_term([&](_aterm& term)
+      {
+        term.mark();
+        ++number_of_young_terms;
+      });
+    g_young_collection = true;
+  }
+
+  mark_term_regions(young_collection);
 
 #ifdef MCRL2_ATERMPP_REFERENCE_COUNTED
   // Marks all terms that are reachable via any reachable term to
@@ -237,36 +294,69 @@ void aterm_pool::collect_impl(thread_aterm_pool_interface* thread)
   m_appl_dynamic_storage.mark();
 #endif // MCRL2_ATERMPP_REFERENCE_COUNTED
 
-  // Mark the terms referenced by all thread pools.
-  for (const auto& pool : m_thread_pools)
+  // Mark the terms referenced by all thread pools. Marking a container can protect temporary terms in the
+  // thread pool of the marking thread, so the variables of all thread pools are marked first.
+  if (number_of_threads > 1)
+  {
+    mark_in_parallel(number_of_threads, &thread_aterm_pool_interface::mark_variables);
+  }
+  else
+  {
+    for (const auto& pool : m_thread_pools)
+    {
+      pool->mark_variables(m_todo);
+    }
+  }
+
+  auto containers_timestamp = std::chrono::system_clock::now();
+  if (number_of_threads > 1)
   {
-    pool->mark();
+    mark_in_parallel(number_of_threads, &thread_aterm_pool_interface::mark_containers);
+  }
+  else
+  {
+    for (const auto& pool : m_thread_pools)
+    {
+      pool->mark_containers(m_todo);
+    }
   }
 
-  assert(std::get<0>(m_appl_storage).verify_mark());
-  assert(std::get<1>(m_appl_storage).verify_mark());
-  assert(std::get<2>(m_appl_storage).verify_mark());
-  assert(std::get<3>(m_appl_storage).verify_mark());
-  assert(std::get<4>(m_appl_storage).verify_mark());
-  assert(std::get<5>(m_appl_storage).verify_mark());
-  assert(std::get<6>(m_appl_storage).verify_mark());
-  assert(std::get<7>(m_appl_storage).verify_mark());
-  assert(m_appl_dynamic_storage.verify_mark());
+  assert(young_collection || std::get<0>(m_appl_storage).verify_mark());
+  assert(young_collection || std::get<1>(m_appl_storage).verify_mark());
+  assert(young_collection || std::get<2>(m_appl_storage).verify_mark());
+  assert(young_collection || std::get<3>(m_appl_storage).verify_mark());
+  assert(young_collection || std::get<4>(m_appl_storage).verify_mark());
+  assert(young_collection || std::get<5>(m_appl_storage).verify_mark());
+  assert(young_collection || std::get<6>(m_appl_storage).verify_mark());
+  assert(young_collection || std::get<7>(m_appl_storage).verify_mark());
+  assert(young_collection || m_appl_dynamic_storage.verify_mark());
 
   // Keep track of the duration for marking and reset for sweep.
-  auto mark_duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - timestamp).count();
-  timestamp = std::chrono::system_clock::now();
+  auto sweep_timestamp = std::chrono::system_clock::now();
   // Collect all terms that are not marked.
-  m_appl_dynamic_storage.sweep();
-  std::get<7>(m_appl_storage).sweep();
-  std::get<6>(m_appl_storage).sweep();
-  std::get<5>(m_appl_storage).sweep();
-  std::get<4>(m_appl_storage).sweep();
-  std::get<3>(m_appl_storage).sweep();
-  std::get<2>(m_appl_storage).sweep();
-  std::get<1>(m_appl_storage).sweep();
-  std::get<0>(m_appl_storage).sweep();
-  m_int_storage.sweep();
+  std::size_t number_of_promoted_terms = 0;
+  if (young_collection)
+  {
+    g_young_collection = false;
+    number_of_promoted_terms = sweep_young_terms();
+  }
+  else if (number_of_threads > 1)
+  {
+    sweep_in_parallel(number_of_threads);
+  }
+  else
+  {
+    m_appl_dynamic_storage.sweep();
+    std::get<7>(m_appl_storage).sweep();
+    std::get<6>(m_appl_storage).sweep();
+    std::get<5>(m_appl_storage).sweep();
+    std::get<4>(m_appl_storage).sweep();
+    std::get<3>(m_appl_storage).sweep();
+    std::get<2>(m_appl_storage).sweep();
+    std::get<1>(m_appl_storage).sweep();
+    std::get<0>(m_appl_storage).sweep();
+    m_int_storage.sweep();
+  }
 
   // Check that after sweeping the terms are consistent.
   assert(m_int_storage.verify_sweep());
@@ -280,24 +370,65 @@ void aterm_pool::collect_impl(thread_aterm_pool_interface* thread)
   assert(std::get<7>(m_appl_storage).verify_sweep());
   assert(m_appl_dynamic_storage.verify_sweep());
 
+  // Garbage collect function symbols.
+  auto function_symbol_timestamp = std::chrono::system_clock::now();
+  m_function_symbol_pool.sweep();
+
+  // Update the times of the phases.
+  auto end_timestamp = std::chrono::system_clock::now();
+  ++(young_collection ? m_number_of_young_collections : m_number_of_collections);
+  m_mark_variables_time += containers_timestamp - timestamp;
+  m_mark_containers_time += sweep_timestamp - containers_timestamp;
+  m_sweep_time += function_symbol_timestamp - sweep_timestamp;
+  m_function_symbol_sweep_time += end_timestamp - function_symbol_timestamp;
+
+  if (EnableTermProfile && m_profile.enabled())
+  {
+    m_profile.collected(end_timestamp - timestamp, young_collection);
+  }
+
   // Print some statistics.
   if (EnableGarbageCollectionMetrics)
   {
-    // Update the times
-    auto sweep_duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - timestamp).count();
+    auto mark_duration = std::chrono::duration_cast<std::chrono::milliseconds>(sweep_timestamp - timestamp).count();
+    auto sweep_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_timestamp - sweep_timestamp).count();
 
     // Print the relevant information.
-    mCRL2log(mcrl2::log::info, "Performance") << "g_term_pool(): Garbage collected " << old_size - size() << " terms, " << size() << " terms remaining in "
-      << mark_duration + sweep_duration << " ms (marking " << mark_duration << " ms + sweep " << sweep_duration << " ms).\n";
+    mCRL2log(mcrl2::log::info, "Performance") << "g_term_pool(): Garbage collected " << old_size - size()
+      << (young_collection ? " of " + std::to_string(number_of_young_terms) + " young terms, " : " terms, ") << size() << " terms remaining in "
+      << mark_duration + sweep_duration << " ms (marking " << mark_duration << " ms + sweep " << sweep_duration << " ms) using "
+      << number_of_threads << " thread(s).\n";
   }
 
-  // Garbage collect function symbols.
-  m_function_symbol_pool.sweep();
-
   print_performance_statistics();
 
   // Use some heuristics to determine when the next collect should be called automatically.
-  m_count_until_collection = size() + protection_set_size();
+  if (young_collection)
+  {
+    // The surviving young terms are old now. Adapt the size of the nursery to the fraction that survives, as
+    // a collection of the young terms is only cheap when most of them are garbage.
+    m_count_until_collection -= number_of_promoted_terms;
+    m_number_of_promoted_terms += number_of_promoted_terms;
+    if (number_of_promoted_terms > number_of_young_terms / 2)
+    {
+      m_young_collection_threshold *= 2;
+    }
+    else if (number_of_promoted_terms < number_of_young_terms / 8)
+    {
+      m_young_collection_threshold = std::max(m_nursery_size, m_young_collection_threshold / 2);
+    }
+  }
+  else
+  {
+    // All terms are old now.
+    for (const auto& pool : m_thread_pools)
+    {
+      pool->young_terms().clear();
+    }
+    m_orphaned_young_terms.clear();
+    m_count_until_collection = size() + protection_set_size();
+  }
+  m_count_until_young_collection = std::max(m_young_collection_threshold, protection_set_size());
 
   unlock();
 }
@@ -463,6 +594,10 @@ void aterm_pool::lock(thread_aterm_pool_interface* thread)
     }
   }
 
+  // Every thread that has not seen its forbidden flag has announced that it is busy after this barrier, which
+  // pairs with the light memory barrier in thread_aterm_pool::lock_shared.
+  mcrl2::utilities::heavy_memory_barrier();
+
   // Wait for all pools to indicate that they are not busy.
   for (const auto& pool : m_thread_pools)
   {
@@ -485,6 +620,375 @@ void aterm_pool::unlock()
   m_mutex.unlock();
 }
 
+std::size_t aterm_pool::collection_threads() const
+{
+#ifdef MCRL2_ATERMPP_REFERENCE_COUNTED
+  return 1;
+#else
+  if constexpr (!GlobalThreadSafe) { return 1; }
+
+  if (m_collection_threads != 0)
+  {
+    return m_collection_threads;
+  }
+  return std::max<std::size_t>(1, std::min<std::size_t>(m_thread_pools.size(), std::thread::hardware_concurrency()));
+#endif
+}
+
+void aterm_pool::mark_in_parallel(std::size_t number_of_threads, mark_roots_function mark_roots)
+{
+  mark_queue queue(number_of_threads);
+  std::atomic<std::size_t> next_pool = 0;
+
+  run_collection_task(number_of_threads, [&]()
+    {
+      std::stack<std::reference_wrapper<_aterm>> todo;
+      g_mark_queue = &queue;
+
+      // Take the roots of one thread pool at a time, and then help the other threads.
+      for (std::size_t i = next_pool++; i < m_thread_pools.size(); i = next_pool++)
+      {
+        (m_thread_pools[i]->*mark_roots)(todo);
+      }
+
+      while (queue.take(todo))
+      {
+        mark_todo(todo);
+      }
+
+      g_mark_queue = nullptr;
+    });
+}
+
+void aterm_pool::sweep_in_parallel(std::size_t number_of_threads)
+{
+  // The deletion hooks are called by the collecting thread, as they can protect and even create terms.
+  std::vector<std::function<void()>> sweeps_with_hooks;
+  std::vector<std::pair<std::size_t, std::function<void()>>> sweeps;
+  for_each_storage([&](auto& storage)
+    {
+      if (storage.has_deletion_hooks())
+      {
+        sweeps_with_hooks.emplace_back([&storage]() { storage.sweep(); });
+      }
+      else
+      {
+        sweeps.emplace_back(storage.size(), [&storage]() { storage.sweep(); });
+      }
+    });
+
+  // Sweep the largest storages first, such that the work is divided evenly.
+  std::sort(sweeps.begin(), sweeps.end(), [](const auto& x, const auto& y) { return x.first > y.first; });
+
+  std::atomic<std::size_t> next_sweep = 0;
+  run_collection_task(number_of_threads, [&]()
+    {
+      if (!g_is_collection_helper)
+      {
+        for (const auto& sweep : sweeps_with_hooks)
+        {
+          sweep();
+        }
+      }
+
+      for (std::size_t i = next_sweep++; i < sweeps.size(); i = next_sweep++)
+      {
+        sweeps[i].second();
+      }
+    });
+}
+
+void aterm_pool::run_collection_task(std::size_t number_of_threads, const std::function<void()>& task)
+{
+  std::unique_lock<std::mutex> lock(m_helper_mutex);
+  for (; m_number_of_helpers + 1 < number_of_threads; ++m_number_of_helpers)
+  {
+    // The helper threads are never stopped, as the global aterm pool is never destroyed.
+    std::thread(&aterm_pool::collection_helper, this, m_number_of_helpers, m_helper_round).detach();
+  }
+
+  m_helper_task = &task;
+  m_helper_participants = number_of_threads - 1;
+  m_helpers_active = number_of_threads - 1;
+  ++m_helper_round;
+  lock.unlock();
+  m_helper_start.notify_all();
+
+  std::exception_ptr exception;
+  try
+  {
+    task();
+  }
+  catch (...)
+  {
+    exception = std::current_exception();
+  }
+
+  lock.lock();
+  m_helper_done.wait(lock, [this]() { return m_helpers_active == 0; });
+  if (exception == nullptr)
+  {
+    std::swap(exception, m_helper_exception);
+  }
+  m_helper_exception = nullptr;
+
+  if (exception != nullptr)
+  {
+    std::rethrow_exception(exception);
+  }
+}
+
+void aterm_pool::collection_helper(std::size_t index, std::size_t round)
+{
+  g_is_collection_helper = true;
+
+  std::unique_lock<std::mutex> lock(m_helper_mutex);
+  while (true)
+  {
+    m_helper_start.wait(lock, [&]() { return m_helper_round != round; });
+    round = m_helper_round;
+
+    if (index < m_helper_participants)
+    {
+      lock.unlock();
+      try
+      {
+        (*m_helper_task)();
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> guard(m_helper_mutex);
+        m_helper_exception = std::current_exception();
+      }
+      lock.lock();
+
+      if (--m_helpers_active == 0)
+      {
+        m_helper_done.notify_one();
+      }
+    }
+  }
+}
+
+void aterm_pool::set_nursery_size(std::size_t number_of_terms)
+{
+  if constexpr (GlobalThreadSafe) { m_mutex.lock(); }
+  m_nursery_size = number_of_terms;
+  m_young_collection_threshold = number_of_terms;
+  m_count_until_young_collection = number_of_terms;
+  if constexpr (GlobalThreadSafe) { m_mutex.unlock(); }
+}
+
+template<typename Function>
+void aterm_pool::for_each_young_term(Function f)
+{
+  for (const auto& pool : m_thread_pools)
+  {
+    for (_aterm* term : pool->young_terms())
+    {
+      f(*term);
+    }
+  }
+
+  for (_aterm* term : m_orphaned_young_terms)
+  {
+    f(*term);
+  }
+}
+
+std::size_t aterm_pool::sweep_young_terms()
+{
+  // Deletion hooks may create terms, which are young terms of the next collection.
+  std::vector<_aterm*> young_terms;
+  std::swap(young_terms, m_orphaned_young_terms);
+  for (const auto& pool : m_thread_pools)
+  {
+    young_terms.insert(young_terms.end(), pool->young_terms().begin(), pool->young_terms().end());
+    pool->young_terms().clear();
+  }
+
+  // Keep the terms that have not been reached.
+  std::size_t number_of_promoted_terms = 0;
+  auto garbage_end = young_terms.begin();
+  for (_aterm* term : young_terms)
+  {
+    if (term->is_marked())
+    {
+      term->unmark();
+      *garbage_end++ = term;
+    }
+    else
+    {
+      ++number_of_promoted_terms;
+    }
+  }
+  young_terms.erase(garbage_end, young_terms.end());
+
+  // The young terms are not ordered such that a term is destroyed before its arguments, so all
+  // deletion hooks are called before any term is destroyed.
+  for (_aterm* term : young_terms)
+  {
+    for_storage_of(*term, [term](auto& storage) { storage.call_deletion_hook(term); });
+  }
+
+  for (_aterm* term : young_terms)
+  {
+    for_storage_of(*term, [term](auto& storage) { storage.erase_term(*term); });
+  }
+
+  return number_of_promoted_terms;
+}
+
+std::size_t aterm_pool::region_size(const function_symbol& symbol)
+{
+  switch (symbol.arity())
+  {
+  case 0:
+    return symbol == as_int() ? integer_term_storage::region_size(0) : term_storage::region_size(0);
+  case 1:
+    return function_application_storage<1>::region_size(1);
+  case 2:
+    return function_application_storage<2>::region_size(2);
+  case 3:
+    return function_application_storage<3>::region_size(3);
+  case 4:
+    return function_application_storage<4>::region_size(4);
+  case 5:
+    return function_application_storage<5>::region_size(5);
+  case 6:
+    return function_application_storage<6>::region_size(6);
+  case 7:
+    return function_application_storage<7>::region_size(7);
+  default:
+    return arbitrary_function_application_storage::region_size(symbol.arity());
+  }
+}
+
+void aterm_pool::enable_profile(const std::string& filename)
+{
+  if (m_profile.enabled())
+  {
+    return;
+  }
+
+  for_each_storage([this](auto& storage)
+    {
+      for (const auto& term : storage.m_term_set)
+      {
+        m_profile.existing(term.function());
+      }
+    });
+  m_profile.enable(filename, [this](const function_symbol& symbol) { return region_size(symbol); });
+}
+
+_aterm* aterm_pool::adopt_term(char* memory, const function_symbol& symbol, const unprotected_aterm* arguments, std::size_t value)
+{
+  const unprotected_aterm* end = arguments + symbol.arity();
+  switch (symbol.arity())
+  {
+  case 0:
+    if (symbol == as_int())
+    {
+      return m_int_storage.adopt(memory, value);
+    }
+    return std::get<0>(m_appl_storage).adopt(memory, symbol);
+  case 1:
+    return std::get<1>(m_appl_storage).adopt(memory, symbol, arguments, end);
+  case 2:
+    return std::get<2>(m_appl_storage).adopt(memory, symbol, arguments, end);
+  case 3:
+    return std::get<3>(m_appl_storage).adopt(memory, symbol, arguments, end);
+  case 4:
+    return std::get<4>(m_appl_storage).adopt(memory, symbol, arguments, end);
+  case 5:
+    return std::get<5>(m_appl_storage).adopt(memory, symbol, arguments, end);
+  case 6:
+    return std::get<6>(m_appl_storage).adopt(memory, symbol, arguments, end);
+  case 7:
+    return std::get<7>(m_appl_storage).adopt(memory, symbol, arguments, end);
+  default:
+    return m_appl_dynamic_storage.adopt(memory, symbol, arguments, end);
+  }
+}
+
+void aterm_pool::mark_term_regions(bool young_collection)
+{
+  for (const term_region& region : m_term_regions)
+  {
+    if (!young_collection)
+    {
+      // The terms of the region are reached without marking their arguments, which are in the region or used by
+      // it. In a collection of the young terms they are unmarked like all old terms, which is already the case.
+      for (_aterm* term : region.terms)
+      {
+        term->mark();
+      }
+    }
+
+    for (_aterm* term : region.external_terms)
+    {
+      mark_term(*term, m_todo);
+    }
+  }
+}
+
+template<typename Function>
+void aterm_pool::for_storage_of(const _aterm& term, Function f)
+{
+  const function_symbol& sym = term.function();
+  switch (sym.arity())
+  {
+  case 0:
+    if (sym == as_int())
+    {
+      f(m_int_storage);
+    }
+    else
+    {
+      f(std::get<0>(m_appl_storage));
+    }
+    break;
+  case 1:
+    f(std::get<1>(m_appl_storage));
+    break;
+  case 2:
+    f(std::get<2>(m_appl_storage));
+    break;
+  case 3:
+    f(std::get<3>(m_appl_storage));
+    break;
+  case 4:
+    f(std::get<4>(m_appl_storage));
+    break;
+  case 5:
+    f(std::get<5>(m_appl_storage));
+    break;
+  case 6:
+    f(std::get<6>(m_appl_storage));
+    break;
+  case 7:
+    f(std::get<7>(m_appl_storage));
+    break;
+  default:
+    f(m_appl_dynamic_storage);
+  }
+}
+
+template<typename Function>
+void aterm_pool::for_each_storage(Function f)
+{
+  f(m_int_storage);
+  f(std::get<0>(m_appl_storage));
+  f(std::get<1>(m_appl_storage));
+  f(std::get<2>(m_appl_storage));
+  f(std::get<3>(m_appl_storage));
+  f(std::get<4>(m_appl_storage));
+  f(std::get<5>(m_appl_storage));
+  f(std::get<6>(m_appl_storage));
+  f(std::get<7>(m_appl_storage));
+  f(m_appl_dynamic_storage);
+}
+
 std::size_t aterm_pool::protection_set_size() const
 {
   std::size_t result = 0;
@@ -11,7 +11,9 @@
 #define ATERMPP_DETAIL_ATERM_POOL_STORAGE_H
 
 #include "mcrl2/atermpp/detail/aterm_hash.h"
+#include "mcrl2/atermpp/detail/mark_queue.h"
 #include "mcrl2/utilities/cache_metric.h"
+#include "mcrl2/utilities/open_addressing_set.h"
 #include "mcrl2/utilities/unordered_set.h"
 
 #include <stack>
@@ -25,29 +27,47 @@ namespace detail
 // Forward declaration
 class aterm_pool;
 
+/// \brief True iff the current garbage collection only collects the young terms, i.e., the terms that have been
+///        created since the previous collection.
+/// \details In such a collection the young terms are marked beforehand, and a term is reached by unmarking it.
+///          As terms are immutable, the arguments of an old term are old, so marking stops at old terms.
+inline bool g_young_collection = false;
+
+/// \returns True iff the term has been reached in the current garbage collection.
+inline bool is_reached(const _aterm& term, bool young_collection)
+{
+  return term.is_marked() != young_collection;
+}
+
 /// \brief Marks a term and recursively all arguments that are not reachable.
 inline void mark_term(const _aterm& root, std::stack<std::reference_wrapper<_aterm>>& todo);
 
+/// \brief Marks all arguments that are not reachable of the terms on the todo stack, which have been marked already.
+/// \details If the current thread marks in parallel with other threads, see g_mark_queue, then part of the work is
+///          shared with the threads that have run out of work.
+inline void mark_todo(std::stack<std::reference_wrapper<_aterm>>& todo);
+
 /// \brief This class provides for all types of term storage. It also
 ///       provides garbage collection via its mark and sweep functions.
 /// \details Internally a hash set is used to ensure that the created terms are unique.
 template<typename Element,
          typename Hash = aterm_hasher<>,
          typename Equals = aterm_equals<>,
-         std::size_t N = DynamicNumberOfArguments>
+         std::size_t N = DynamicNumberOfArguments,
+         bool OpenAddressing = EnableOpenAddressing>
 class aterm_pool_storage : private mcrl2::utilities::noncopyable
 {
 public:
-  using unordered_set = mcrl2::utilities::unordered_set<
-    Element,
-    Hash,
-    Equals,
-    typename std::conditional<N == DynamicNumberOfArguments,
+  using allocator = typename std::conditional<N == DynamicNumberOfArguments,
       atermpp::detail::_aterm_appl_allocator<>,
-      typename std::conditional<EnableBlockAllocator, mcrl2::utilities::block_allocator<Element, 1024, GlobalThreadSafe>, std::allocator<Element>>::type
-      >::type,
-    GlobalThreadSafe,
-    false>;
+      typename std::conditional<EnableBlockAllocator, mcrl2::utilities::block_allocator<Element, 1024, GlobalThreadSafe>, term_allocator<Element>>::type
+      >::type;
+
+  /// \brief The hash table that keeps the terms unique, which uses open addressing or bucket lists.
+  using unordered_set = typename std::conditional<OpenAddressing,
+    mcrl2::utilities::open_addressing_set<Element, Hash, Equals, allocator, GlobalThreadSafe, false>,
+    mcrl2::utilities::unordered_set<Element, Hash, Equals, allocator, GlobalThreadSafe, false>
+    >::type;
   using iterator = typename unordered_set::iterator;
   using const_iterator = typename unordered_set::const_iterator;
 
@@ -142,6 +162,19 @@ public:
                            InputIterator end);   
 
 
+  /// \returns The number of bytes that a term of this storage with the given arity occupies in a term region.
+  static constexpr std::size_t region_size(std::size_t arity)
+  {
+    return unordered_set::external_key_offset + (N == DynamicNumberOfArguments ? sizeof(Element) + (arity - 1) * sizeof(aterm) : sizeof(Element));
+  }
+
+  /// \brief Constructs the term given by the arguments in the memory of a term region, unless it exists already.
+  /// \details The memory must be region_size(arity) bytes. The term is never destroyed, as it is always reachable.
+  ///          Requires exclusive access to the pool.
+  /// \returns The unique term, which resides in the given memory iff it did not exist before.
+  template<typename ...Args>
+  _aterm* adopt(char* memory, const Args&... args);
+
   /// \brief Prints various performance statistics for this storage.
   /// \param identifier A string to identify the printed message for this storage.
   void print_performance_stats(const char* identifier) const;
@@ -155,6 +188,13 @@ public:
   ///        mark() was called first.
   void sweep();
 
+  /// \brief Destroys the given term, which must be an unmarked term of this storage, without
+  ///        calling its deletion hook.
+  void erase_term(const _aterm& term);
+
+  /// \returns True iff deletion hooks have been added to this storage.
+  bool has_deletion_hooks() const { return !m_deletion_hooks.empty(); }
+
   /// \brief Resizes the hash table if necessary.
   void resize_if_needed();
 
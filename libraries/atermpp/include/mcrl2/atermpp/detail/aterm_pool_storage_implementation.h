@@ -83,43 +83,70 @@ inline std::array<unprotected_aterm, N> construct_arguments(InputIterator it, In
 
 void mark_term(const _aterm& root, std::stack<std::reference_wrapper<_aterm>>& todo)
 {
-  if (!root.is_marked())
+  if (!is_reached(root, g_young_collection))
   {
     // Do not use the stack, because this might run out of stack memory for large lists.
     todo.push(const_cast<_aterm&>(root));
+    mark_todo(todo);
+  }
+}
 
-    // Mark the term depth-first to reduce the maximum todo size required.
-    while (!todo.empty())
-    {
-      _aterm& term = todo.top();
-      todo.pop();
+void mark_todo(std::stack<std::reference_wrapper<_aterm>>& todo)
+{
+  mark_queue* queue = g_mark_queue;
+  const bool young_collection = g_young_collection;
 
-      // Each term should be marked.
+  // Mark the term depth-first to reduce the maximum todo size required.
+  while (!todo.empty())
+  {
+    _aterm& term = todo.top();
+    todo.pop();
+
+    // Each term should be marked. When marking in parallel two threads can both mark the same term,
+    // which does no harm as they write the same value and at worst explore its arguments twice.
+    if (young_collection)
+    {
+      term.unmark();
+    }
+    else
+    {
       term.mark();
-      // Determine the arity of the function application.
-      const std::size_t arity = term.function().arity();
-      _term_appl& term_appl = static_cast<_term_appl&>(term);
+    }
+    // Determine the arity of the function application.
+    const std::size_t arity = term.function().arity();
+    _term_appl& term_appl = static_cast<_term_appl&>(term);
 
-      for (std::size_t i = 0; i < arity; ++i)
+    for (std::size_t i = 0; i < arity; ++i)
+    {
+      // Marks all arguments that are not already (marked as) reachable, because the current
+      // term is reachable and as such its arguments are reachable as well.
+      _aterm& argument = *detail::address(term_appl.arg(i));
+      if (!is_reached(argument, young_collection))
       {
-        // Marks all arguments that are not already (marked as) reachable, because the current
-        // term is reachable and as such its arguments are reachable as well.
-        _aterm& argument = *detail::address(term_appl.arg(i));
-        if (!argument.is_marked())
+        if (young_collection)
+        {
+          argument.unmark();
+        }
+        else
         {
           argument.mark();
-
-          // Add the argument to be explored as well.
-          todo.push(argument);
         }
+
+        // Add the argument to be explored as well.
+        todo.push(argument);
       }
+    }
 
+    if (queue != nullptr && todo.size() > 1 && queue->hungry())
+    {
+      // Another thread has run out of work.
+      queue->share(todo);
     }
   }
 }
 
-#define ATERM_POOL_STORAGE_TEMPLATES template<typename Element, typename Hash, typename Equals, std::size_t N>
-#define ATERM_POOL_STORAGE aterm_pool_storage<Element, Hash, Equals, N>
+#define ATERM_POOL_STORAGE_TEMPLATES template<typename Element, typename Hash, typename Equals, std::size_t N, bool OpenAddressing>
+#define ATERM_POOL_STORAGE aterm_pool_storage<Element, Hash, Equals, N, OpenAddressing>
 
 ATERM_POOL_STORAGE_TEMPLATES
 ATERM_POOL_STORAGE::aterm_pool_storage(aterm_pool& pool) :
@@ -335,6 +362,36 @@ bool ATERM_POOL_STORAGE::create_appl_dynamic(aterm& term,
 }
  
 
+ATERM_POOL_STORAGE_TEMPLATES
+template<typename ...Args>
+_aterm* ATERM_POOL_STORAGE::adopt(char* memory, const Args&... args)
+{
+  auto it = m_term_set.find(args...);
+  if (it != m_term_set.end())
+  {
+    return const_cast<Element*>(&*it);
+  }
+
+  // The set uses the memory before the term for its own administration, see insert_external.
+  Element* term;
+  if constexpr (N == DynamicNumberOfArguments)
+  {
+    term = new (memory + unordered_set::external_key_offset) Element(args..., true);
+  }
+  else
+  {
+    term = new (memory + unordered_set::external_key_offset) Element(args...);
+  }
+
+  m_term_set.insert_external(*term);
+  m_term_set.rehash_if_needed();
+  if (EnableTermProfile && m_pool.profile().enabled())
+  {
+    m_pool.profile().created(term->function());
+  }
+  return term;
+}
+
 ATERM_POOL_STORAGE_TEMPLATES
 void ATERM_POOL_STORAGE::print_performance_stats(const char* identifier) const
 {
@@ -413,6 +470,17 @@ void ATERM_POOL_STORAGE::sweep()
   }
 }
 
+ATERM_POOL_STORAGE_TEMPLATES
+void ATERM_POOL_STORAGE::erase_term(const _aterm& term)
+{
+  assert(!term.is_marked());
+  if (EnableTermProfile && m_pool.profile().enabled())
+  {
+    m_pool.profile().destroyed(term.function());
+  }
+  m_term_set.erase(static_cast<const Element&>(term));
+}
+
 ATERM_POOL_STORAGE_TEMPLATES
 void ATERM_POOL_STORAGE::resize_if_needed()
 {
@@ -476,6 +544,11 @@ typename ATERM_POOL_STORAGE::iterator ATERM_POOL_STORAGE::destroy(iterator it)
   // Trigger the deletion hook before the term is actually destroyed.
   call_deletion_hook(&term);
 
+  if (EnableTermProfile && m_pool.profile().enabled())
+  {
+    m_pool.profile().destroyed(term.function());
+  }
+
   // Remove them from the hash table, will also destroy terms with fixed arity.
   return m_term_set.erase(it);
 }
@@ -505,6 +578,18 @@ bool ATERM_POOL_STORAGE::emplace(aterm& term, Args&&... args)
     m_term_metric.hit();
   }
 
+  if (EnableTermProfile && m_pool.profile().enabled())
+  {
+    if (added)
+    {
+      m_pool.profile().created(it->function());
+    }
+    else
+    {
+      m_pool.profile().found(it->function());
+    }
+  }
+
   return added;
 }
 
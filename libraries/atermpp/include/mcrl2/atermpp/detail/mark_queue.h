@@ -0,0 +1,107 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ATERMPP_DETAIL_MARK_QUEUE_H
+#define ATERMPP_DETAIL_MARK_QUEUE_H
+
+#include "mcrl2/atermpp/detail/aterm.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stack>
+#include <vector>
+
+namespace atermpp
+{
+namespace detail
+{
+
+/// \brief A queue of marked terms whose arguments must still be marked, which is used to share the
+///        work of marking between the threads that perform a garbage collection.
+/// \details Each thread marks the terms on its own todo stack. When another thread has run out of
+///          work, it sets the hungry flag, upon which the next thread that notices it moves half of
+///          its todo stack to the queue. The marking is finished when all threads wait for work
+///          while the queue is empty.
+class mark_queue
+{
+public:
+  /// \param number_of_threads The number of threads that take work from this queue.
+  explicit mark_queue(std::size_t number_of_threads)
+    : m_number_of_threads(number_of_threads)
+  {}
+
+  /// \returns True iff a thread is waiting for work.
+  bool hungry() const
+  {
+    return m_hungry.load(std::memory_order_relaxed);
+  }
+
+  /// \brief Moves half of the terms on the given todo stack to the queue.
+  void share(std::stack<std::reference_wrapper<_aterm>>& todo)
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    for (std::size_t i = todo.size() / 2; i > 0; --i)
+    {
+      m_terms.push_back(&todo.top().get());
+      todo.pop();
+    }
+
+    m_hungry.store(false, std::memory_order_relaxed);
+    m_condition.notify_all();
+  }
+
+  /// \brief Moves terms from the queue to the given todo stack, waiting until the queue is not empty.
+  /// \returns False iff all work has been done, in which case the todo stack is left empty.
+  bool take(std::stack<std::reference_wrapper<_aterm>>& todo)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    ++m_waiting;
+    while (m_terms.empty())
+    {
+      if (m_waiting == m_number_of_threads)
+      {
+        // No thread has any work left, so none can be shared anymore.
+        m_condition.notify_all();
+        return false;
+      }
+
+      m_hungry.store(true, std::memory_order_relaxed);
+      m_condition.wait(lock);
+    }
+    --m_waiting;
+
+    // Take a fair share of the queue, such that the other waiting threads get work as well.
+    std::size_t count = std::max<std::size_t>(1, m_terms.size() / (m_waiting + 1));
+    for (; count > 0; --count)
+    {
+      todo.push(*m_terms.back());
+      m_terms.pop_back();
+    }
+    return true;
+  }
+
+private:
+  std::size_t m_number_of_threads;
+  std::size_t m_waiting = 0;
+  std::vector<_aterm*> m_terms;
+
+  std::atomic<bool> m_hungry = false;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+};
+
+/// \brief The queue with which the current thread shares its marking work, or nullptr when it marks on its own.
+inline thread_local mark_queue* g_mark_queue = nullptr;
+
+} // namespace detail
+} // namespace atermpp
+
+#endif // ATERMPP_DETAIL_MARK_QUEUE_H
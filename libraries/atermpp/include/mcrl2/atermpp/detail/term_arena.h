@@ -0,0 +1,206 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef MCRL2_ATERMPP_DETAIL_TERM_ARENA_H
+#define MCRL2_ATERMPP_DETAIL_TERM_ARENA_H
+
+#include "mcrl2/atermpp/detail/aterm_configuration.h"
+#include "mcrl2/utilities/noncopyable.h"
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace atermpp
+{
+namespace detail
+{
+
+class _aterm;
+
+/// \brief A region of virtual memory in which all terms are allocated when terms are addressed by
+///        32-bit references, see MCRL2_ATERMPP_COMPRESSED_REFERENCES.
+/// \details The whole region is reserved when the arena is created, and it is committed in chunks
+///          when it is used. Freed memory is kept in a free list per size, as most terms have one of
+///          a few sizes, and it is never returned to the operating system.
+class term_arena : private mcrl2::utilities::noncopyable
+{
+public:
+  /// \brief The alignment of all allocations, which is also the unit of a compressed reference.
+  static constexpr std::size_t Alignment = 8;
+
+  /// \brief The number of bytes that can be addressed by a 32-bit reference.
+  static constexpr std::size_t ReservedSize = (std::size_t(1) << 32) * Alignment;
+
+  /// \brief Reserves the region, which throws std::bad_alloc when this is not possible.
+  term_arena();
+  ~term_arena();
+
+  /// \returns Memory for the given number of bytes that is aligned to Alignment.
+  /// \threadsafe
+  void* allocate(std::size_t size);
+
+  /// \brief Frees memory that was obtained by allocate(size).
+  /// \threadsafe
+  void deallocate(void* pointer, std::size_t size);
+
+  /// \returns The first byte of the region.
+  char* begin() const { return m_begin; }
+
+  /// \returns The number of bytes that have been allocated from the region, including the free memory.
+  std::size_t size() const { return m_end - m_begin; }
+
+private:
+  /// \brief The number of bytes that are committed at once.
+  static constexpr std::size_t ChunkSize = std::size_t(1) << 26;
+
+  std::mutex m_mutex;
+  char* m_begin;
+  char* m_end;       ///< The first byte that has not been allocated.
+  char* m_committed; ///< The first byte that has not been committed.
+
+  /// \brief The heads of the free lists, indexed by the size divided by the alignment. The first word
+  ///        of each free block points to the next block of the same size.
+  std::vector<void*> m_free_lists;
+};
+
+/// \brief The first byte of the arena in which the terms are allocated, or nullptr if it does not exist yet.
+extern char* g_term_arena_begin;
+
+/// \returns The arena in which the terms are allocated, which is created on first use and never destroyed.
+term_arena& g_term_arena();
+
+/// \brief An allocator that obtains its memory from the term arena.
+template<typename T>
+class term_arena_allocator
+{
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  template<class U>
+  struct rebind
+  {
+    typedef term_arena_allocator<U> other;
+  };
+
+  term_arena_allocator() = default;
+
+  template<typename U>
+  term_arena_allocator(const term_arena_allocator<U>&) noexcept
+  {}
+
+  T* allocate(size_type n)
+  {
+    static_assert(alignof(T) <= term_arena::Alignment, "The term arena does not support this alignment.");
+    return static_cast<T*>(g_term_arena().allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T* pointer, size_type n)
+  {
+    g_term_arena().deallocate(pointer, n * sizeof(T));
+  }
+
+  template<typename U>
+  bool operator==(const term_arena_allocator<U>&) const noexcept { return true; }
+
+  template<typename U>
+  bool operator!=(const term_arena_allocator<U>&) const noexcept { return false; }
+};
+
+/// \brief A 32-bit reference to a term in the term arena, which behaves as a pointer to the term.
+/// \details The reference is the offset of the term in the arena divided by the alignment, where zero
+///          is the null pointer.
+class compressed_term_pointer
+{
+public:
+  compressed_term_pointer() noexcept = default;
+
+  compressed_term_pointer(const _aterm* term) noexcept
+    : m_index(compress(term))
+  {}
+
+  compressed_term_pointer(std::nullptr_t) noexcept
+  {}
+
+  operator const _aterm*() const noexcept
+  {
+    return decompress(m_index);
+  }
+
+  const _aterm* operator->() const noexcept
+  {
+    return decompress(m_index);
+  }
+
+  const _aterm& operator*() const noexcept
+  {
+    return *decompress(m_index);
+  }
+
+  bool operator==(const compressed_term_pointer& other) const noexcept { return m_index == other.m_index; }
+  bool operator!=(const compressed_term_pointer& other) const noexcept { return m_index != other.m_index; }
+  bool operator<(const compressed_term_pointer& other) const noexcept { return m_index < other.m_index; }
+  bool operator>(const compressed_term_pointer& other) const noexcept { return m_index > other.m_index; }
+  bool operator<=(const compressed_term_pointer& other) const noexcept { return m_index <= other.m_index; }
+  bool operator>=(const compressed_term_pointer& other) const noexcept { return m_index >= other.m_index; }
+  bool operator==(std::nullptr_t) const noexcept { return m_index == 0; }
+  bool operator!=(std::nullptr_t) const noexcept { return m_index != 0; }
+
+private:
+  static std::uint32_t compress(const _aterm* term) noexcept
+  {
+    if (term == nullptr)
+    {
+      return 0;
+    }
+
+    const char* address = reinterpret_cast<const char*>(term);
+    assert(g_term_arena_begin < address && address < g_term_arena_begin + term_arena::ReservedSize);
+    return static_cast<std::uint32_t>(static_cast<std::size_t>(address - g_term_arena_begin) / term_arena::Alignment);
+  }
+
+  static const _aterm* decompress(std::uint32_t index) noexcept
+  {
+    if (index == 0)
+    {
+      return nullptr;
+    }
+
+    return reinterpret_cast<const _aterm*>(g_term_arena_begin + static_cast<std::size_t>(index) * term_arena::Alignment);
+  }
+
+  std::uint32_t m_index = 0;
+};
+
+#ifdef MCRL2_ATERMPP_COMPRESSED_REFERENCES
+/// \brief The type that terms use to refer to other terms.
+using term_pointer = compressed_term_pointer;
+
+/// \brief The allocator for the memory of terms.
+template<typename T>
+using term_allocator = term_arena_allocator<T>;
+
+static_assert(!EnableBlockAllocator, "The block allocator does not allocate its blocks in the term arena.");
+#else
+/// \brief The type that terms use to refer to other terms.
+using term_pointer = const _aterm*;
+
+/// \brief The allocator for the memory of terms.
+template<typename T>
+using term_allocator = std::allocator<T>;
+#endif
+
+} // namespace detail
+} // namespace atermpp
+
+#endif // MCRL2_ATERMPP_DETAIL_TERM_ARENA_H
@@ -0,0 +1,127 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef MCRL2_ATERMPP_DETAIL_TERM_PROFILE_H
+#define MCRL2_ATERMPP_DETAIL_TERM_PROFILE_H
+
+#include "mcrl2/atermpp/function_symbol.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+namespace atermpp
+{
+namespace detail
+{
+
+/// \brief Records, per function symbol, how many terms are created, found and destroyed, and how long the garbage
+///        collections take. Nothing is recorded until the profile is enabled.
+/// \details The counters are protected by a mutex, as terms are created and swept by several threads. This makes
+///          profiling expensive, which is why it must be enabled explicitly, see atermpp::enable_term_profile.
+class term_profile
+{
+public:
+  /// \brief The counters of the terms with one function symbol.
+  struct symbol_counters
+  {
+    std::size_t existing = 0;   ///< The number of terms that existed when the profile was enabled.
+    std::size_t created = 0;    ///< The number of terms that were added to the pool.
+    std::size_t found = 0;      ///< The number of times that a term to be created existed already.
+    std::size_t destroyed = 0;  ///< The number of terms that were garbage collected.
+    std::size_t peak = 0;       ///< The largest number of live terms after a garbage collection.
+    std::size_t candidates = 0; ///< The sum of the number of live terms before each garbage collection.
+    std::size_t survived = 0;   ///< The sum of the number of live terms after each garbage collection.
+    std::size_t destroyed_before_collection = 0; ///< The number of destroyed terms before the last collection.
+
+    /// \returns The number of terms with this function symbol that exist.
+    std::size_t live() const { return existing + created - destroyed; }
+  };
+
+  /// \brief The number of buckets of the histogram of pause times, where bucket i counts the pauses shorter than 2^i
+  ///        microseconds, and the last bucket all longer pauses.
+  static constexpr std::size_t NumberOfPauseBuckets = 32;
+
+  /// \returns True iff the profile records the events of the term pool.
+  bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+  /// \brief Starts recording, and writes the profile to the given file at exit and on request, see
+  ///        atermpp::enable_term_profile. The terms that exist already must be passed to existing().
+  /// \param size_of_term A function that returns the number of bytes of a term with the given function symbol.
+  void enable(const std::string& filename, std::function<std::size_t(const function_symbol&)> size_of_term);
+
+  /// \brief Records a term that exists when the profile is enabled.
+  void existing(const function_symbol& symbol)
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    ++m_symbols[symbol].existing;
+  }
+
+  /// \brief Records that a term with the given function symbol was added to the pool.
+  void created(const function_symbol& symbol)
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    ++m_symbols[symbol].created;
+  }
+
+  /// \brief Records that a term with the given function symbol was found in the pool when it was created.
+  void found(const function_symbol& symbol)
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    ++m_symbols[symbol].found;
+  }
+
+  /// \brief Records that a term with the given function symbol was garbage collected.
+  void destroyed(const function_symbol& symbol)
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    ++m_symbols[symbol].destroyed;
+  }
+
+  /// \brief Records a garbage collection that took the given time, and writes the profile if it was requested.
+  /// \details Requires exclusive access to the term pool.
+  void collected(std::chrono::duration<double, std::micro> pause, bool young_collection);
+
+  /// \brief Writes the profile to the given stream as a JSON object.
+  void write_json(std::ostream& stream);
+
+  /// \brief Writes the profile to its file.
+  void write_file();
+
+  /// \brief Requests the profile to be written at the end of the next garbage collection.
+  /// \details This only sets a flag, so it can be called by a signal handler.
+  static void request_write() { g_write_requested = 1; }
+
+private:
+  std::atomic<bool> m_enabled = false;
+  std::string m_filename;
+  std::function<std::size_t(const function_symbol&)> m_size_of_term;
+  std::mutex m_mutex;
+  std::unordered_map<function_symbol, symbol_counters> m_symbols;
+  std::chrono::steady_clock::time_point m_start;
+
+  std::size_t m_number_of_collections = 0;
+  std::size_t m_number_of_young_collections = 0;
+  std::array<std::size_t, NumberOfPauseBuckets> m_pause_histogram{};
+  std::chrono::duration<double, std::micro> m_total_pause{0};
+  std::chrono::duration<double, std::micro> m_longest_pause{0};
+
+  static inline volatile std::sig_atomic_t g_write_requested = 0;
+};
+
+} // namespace detail
+} // namespace atermpp
+
+#endif // MCRL2_ATERMPP_DETAIL_TERM_PROFILE_H
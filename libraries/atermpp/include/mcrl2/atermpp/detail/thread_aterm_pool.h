@@ -104,7 +104,9 @@ public:
   inline void deregister_container(_aterm_container* variable);
 
   // Implementation of thread_aterm_pool_interface
-  inline void mark() override;
+  inline void mark_variables(std::stack<std::reference_wrapper<_aterm>>& todo) override;
+  inline void mark_containers(std::stack<std::reference_wrapper<_aterm>>& todo) override;
+  inline std::vector<_aterm*>& young_terms() override { return m_young_terms; }
   inline void print_local_performance_statistics() const override;
   inline bool is_busy() const override;
   inline void wait_for_busy() const override;
@@ -165,7 +167,17 @@ private:
   ///        actually perform un/locking at the root.
   std::size_t m_lock_depth = 0;
 
-  std::stack<std::reference_wrapper<_aterm>> m_todo; ///< A reusable todo stack.
+  /// \brief The terms that this thread has created since the previous garbage collection, see aterm_pool::set_nursery_size.
+  std::vector<_aterm*> m_young_terms;
+
+  /// \brief Records that the given term has been created by this thread, which must hold the shared lock.
+  void created(const aterm& term)
+  {
+    if (m_pool.collects_young_terms())
+    {
+      m_young_terms.push_back(detail::address(term));
+    }
+  }
 
   bool m_is_main_thread = false;
 };
@@ -15,6 +15,7 @@
 
 #include "thread_aterm_pool.h"
 #include "mcrl2/atermpp/detail/index_traits.h"
+#include "mcrl2/utilities/memory_barrier.h"
 
 
 namespace atermpp
@@ -50,6 +51,7 @@ void thread_aterm_pool::create_int(aterm& term, size_t val)
   try
   {
     bool added = m_pool.create_int(term, val);
+    if (added) { created(term); }
     unlock_shared();
     if (added) { m_pool.created_term(m_lock_depth == 0, this); }
   }
@@ -66,6 +68,7 @@ void thread_aterm_pool::create_term(aterm& term, const atermpp::function_symbol&
   try
   {
     bool added = m_pool.create_term(term, sym);
+    if (added) { created(term); }
     unlock_shared();
     if (added) { m_pool.created_term(m_lock_depth == 0, this); }
   }
@@ -83,6 +86,7 @@ void thread_aterm_pool::create_appl(aterm& term, const function_symbol& sym, con
   try
   {
     bool added = m_pool.create_appl(term, sym, arguments...);
+    if (added) { created(term); }
     unlock_shared();
     if (added) { m_pool.created_term(m_lock_depth == 0, this); }
   }
@@ -128,6 +132,8 @@ void thread_aterm_pool::create_appl_index(aterm& term, const function_symbol& sy
       added = m_pool.create_appl(term, sym, argument_array[0], argument_array[1], term);
     }
 
+    // The integer index is not recorded as young term, so it is only collected when all terms are collected.
+    if (added) { created(term); }
     unlock_shared();
 
     if (added) { m_pool.created_term(m_lock_depth == 0, this); }
@@ -149,6 +155,7 @@ void thread_aterm_pool::create_appl_dynamic(aterm& term,
   try
   {
     bool added = m_pool.create_appl_dynamic(term, sym, begin, end);
+    if (added) { created(term); }
     unlock_shared();
     
     if (added) { m_pool.created_term(m_lock_depth == 0, this); }
@@ -171,6 +178,7 @@ void thread_aterm_pool::create_appl_dynamic(aterm& term,
   try
   {
     bool added = m_pool.create_appl_dynamic(term, sym, convert_to_aterm, begin, end);
+    if (added) { created(term); }
     unlock_shared();
 
     if (added) { m_pool.created_term(m_lock_depth == 0, this); }
@@ -269,7 +277,7 @@ void thread_aterm_pool::deregister_container(_aterm_container* container)
   }
 }
 
-void thread_aterm_pool::mark()
+void thread_aterm_pool::mark_variables([[maybe_unused]] std::stack<std::reference_wrapper<_aterm>>& todo)
 {
 
 #ifndef MCRL2_ATERMPP_REFERENCE_COUNTED
@@ -279,21 +287,24 @@ void thread_aterm_pool::mark()
     {
       // Mark all terms (and their subterms) that are reachable, i.e the root set.
       _aterm* term = detail::address(*variable);
-      if (term != nullptr && !term->is_marked())
+      if (term != nullptr)
       {
-        // This variable is not a default term and that term has not been marked.
-        mark_term(*term, m_todo);
+        // This variable is not a default term, and mark_term skips the term if it has been marked.
+        mark_term(*term, todo);
       }
     }
   }
 #endif // NOT MCRL2_ATERMPP_REFERENCE_COUNTED
+}
 
+void thread_aterm_pool::mark_containers(std::stack<std::reference_wrapper<_aterm>>& todo)
+{
   for (const _aterm_container* container : *m_containers)
   {
     if (container != nullptr)
     {
       // The container marks the contained terms itself.
-      container->mark(m_todo);
+      container->mark(todo);
     }
   }
 }
@@ -309,12 +320,15 @@ void thread_aterm_pool::print_local_performance_statistics() const
 
 void thread_aterm_pool::wait_for_busy() const
 {
-  while (m_busy_flag.load());
+  while (m_busy_flag.load(std::memory_order_acquire))
+  {
+    std::this_thread::yield();
+  }
 }
 
 bool thread_aterm_pool::is_busy() const
 {
-  return m_busy_flag.load();
+  return m_busy_flag.load(std::memory_order_acquire);
 }
 
 void thread_aterm_pool::lock_shared()
@@ -322,14 +336,19 @@ void thread_aterm_pool::lock_shared()
   if (GlobalThreadSafe && m_lock_depth == 0)
   {
     assert(!m_busy_flag);
-    m_busy_flag.store(true);
+    m_busy_flag.store(true, std::memory_order_relaxed);
+
+    // The store of the busy flag must be visible before the forbidden flag is read, which is guaranteed by the
+    // heavy memory barrier in aterm_pool::lock. This avoids a full memory barrier for every shared lock.
+    mcrl2::utilities::light_memory_barrier();
 
     // Wait for the forbidden flag to become false.
-    while (m_forbidden_flag.load())
+    while (m_forbidden_flag.load(std::memory_order_acquire))
     {
-      m_busy_flag = false;
+      m_busy_flag.store(false, std::memory_order_release);
       m_pool.wait();
-      m_busy_flag = true;
+      m_busy_flag.store(true, std::memory_order_relaxed);
+      mcrl2::utilities::light_memory_barrier();
     }
   }
 
@@ -348,14 +367,16 @@ void inline lock_shared(std::atomic<bool>* busy_flag,
   if (GlobalThreadSafe && *lock_depth == 0)
   {
     assert(!*busy_flag);
-    busy_flag->store(true);
+    busy_flag->store(true, std::memory_order_relaxed);
+    mcrl2::utilities::light_memory_barrier();
 
     // Wait for the forbidden flag to become false.
-    while (forbidden_flag->load())
+    while (forbidden_flag->load(std::memory_order_acquire))
     {
-      *busy_flag = false;
+      busy_flag->store(false, std::memory_order_release);
       atermpp::detail::g_thread_term_pool().wait();
-      *busy_flag = true;
+      busy_flag->store(true, std::memory_order_relaxed);
+      mcrl2::utilities::light_memory_barrier();
     }
   }
 
@@ -407,7 +428,8 @@ void thread_aterm_pool::wait()
 
 void thread_aterm_pool::set_forbidden(bool value)
 {
-  m_forbidden_flag.store(value);
+  // Releasing the forbidden flag publishes the changes of the exclusive section to this thread.
+  m_forbidden_flag.store(value, std::memory_order_release);
 }
 
 std::size_t thread_aterm_pool::protection_set_size() const
@@ -0,0 +1,35 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef MCRL2_ATERMPP_TERM_PROFILE_H
+#define MCRL2_ATERMPP_TERM_PROFILE_H
+
+#include <ostream>
+#include <string>
+
+namespace atermpp
+{
+
+/// \brief Starts recording, per function symbol, the number of live, created and destroyed terms, how often a term
+///        that is created exists already, and which fraction of the terms survives the garbage collections. It also
+///        records a histogram of the durations of the garbage collections.
+/// \details The profile is written as a JSON object to the given file when the program exits, and at the end of the
+///          next garbage collection after the signal SIGUSR1 has been received. It lists the function symbols in the
+///          order of their number of live terms, and the symbols of which the live terms use the most memory.
+///          Setting the environment variable MCRL2_TERM_PROFILE to a file name enables the profile for any tool.
+///          The function symbols that occur in the profile are never garbage collected, and profiling slows down
+///          the creation of terms considerably.
+void enable_term_profile(const std::string& filename);
+
+/// \brief Writes the profile that was enabled by enable_term_profile to the given stream as a JSON object.
+void write_term_profile(std::ostream& stream);
+
+} // namespace atermpp
+
+#endif // MCRL2_ATERMPP_TERM_PROFILE_H
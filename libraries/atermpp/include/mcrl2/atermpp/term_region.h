@@ -0,0 +1,35 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef MCRL2_ATERMPP_TERM_REGION_H
+#define MCRL2_ATERMPP_TERM_REGION_H
+
+#include "mcrl2/atermpp/aterm.h"
+
+#include <string>
+#include <vector>
+
+namespace atermpp
+{
+
+/// \brief Writes the given terms, and all their subterms, to a file that can be mapped into memory by load_term_region.
+/// \details The terms are stored in the layout of the term pool, so the file can only be loaded by a program that
+///          uses the same configuration of the term library on the same platform.
+void save_term_region(const std::string& filename, const std::vector<aterm>& terms);
+
+/// \brief Maps a file that was written by save_term_region into memory and uses its terms directly.
+/// \details The terms of the file that do not exist yet are constructed in place in the mapped memory, instead of
+///          being copied into the term pool, and they are never garbage collected. The pages are mapped copy-on-write,
+///          so only the pages of which terms are adopted become private to this process.
+/// \returns The terms that were passed to save_term_region, in the same order.
+std::vector<aterm> load_term_region(const std::string& filename);
+
+} // namespace atermpp
+
+#endif // MCRL2_ATERMPP_TERM_REGION_H
@@ -8,7 +8,16 @@
 //
 
 #include "mcrl2/atermpp/aterm_io_binary.h"
+#include "mcrl2/atermpp/aterm_int.h"
 #include "mcrl2/atermpp/standard_containers/stack.h"
+#include "mcrl2/utilities/block_compression.h"
+
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 
 namespace atermpp
@@ -38,6 +47,10 @@ static constexpr std::uint16_t BAF_MAGIC = 0x8baf;
 ///                                                compact by not storing states with a default probability 1)
 static constexpr std::uint16_t BAF_VERSION = 0x8307;
 
+/// \brief The version of the chunked extension of the format with version BAF_VERSION, see
+///        write_terms_to_chunked_binary_stream.
+static constexpr std::uint16_t BAF_CHUNKED_VERSION = BAF_VERSION | 0x4000;
+
 /// \brief Each packet has a header consisting of a type.
 /// \details Either indicates a function symbol, a term (either shared or output) or an arbitrary integer.
 enum class packet_type
@@ -51,6 +64,336 @@ enum class packet_type
 /// \brief The number of bits needed to store an element of packet_type.
 static constexpr unsigned int packet_bits = 2;
 
+namespace
+{
+
+/// \brief The maximum number of chunks, apart from the prefix, in the chunked format.
+constexpr std::size_t MaximumNumberOfChunks = 64;
+
+/// \returns The number of bits needed to index the given number of elements.
+unsigned int index_width(std::size_t size)
+{
+  unsigned int width = 0;
+  while (size != 0)
+  {
+    size >>= 1;
+    ++width;
+  }
+  return width;
+}
+
+/// \brief Calls f(i) for every 0 <= i < n on the given number of threads.
+/// \details The first exception thrown by f is rethrown after all threads have finished.
+template<typename F>
+void parallel_for(std::size_t n, std::size_t number_of_threads, F f)
+{
+  std::atomic<std::size_t> next(0);
+  std::exception_ptr exception;
+  std::mutex exception_mutex;
+
+  auto worker = [&]()
+    {
+      try
+      {
+        for (std::size_t i = next++; i < n; i = next++)
+        {
+          f(i);
+        }
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> guard(exception_mutex);
+        if (!exception)
+        {
+          exception = std::current_exception();
+        }
+        next = n;
+      }
+    };
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < std::min(number_of_threads, n); ++i)
+  {
+    threads.emplace_back(worker);
+  }
+  worker();
+
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+
+  if (exception)
+  {
+    std::rethrow_exception(exception);
+  }
+}
+
+/// \brief A consecutive part of the terms that are written in the chunked format.
+struct write_chunk
+{
+  std::size_t begin = 0; ///< The index of the first term of the chunk.
+  std::size_t end = 0;   ///< The index after the last term of the chunk.
+
+  /// \brief The distinct proper subterms of the terms in the chunk, such that arguments precede their terms.
+  std::vector<unprotected_aterm> subterms;
+
+  std::vector<std::uint8_t> bytes; ///< The encoded chunk.
+  std::size_t size = 0;            ///< The number of bytes of the chunk before compression.
+  bool compressed = false;
+};
+
+/// \brief Determines the distinct proper subterms of the given terms in post order.
+void collect_subterms(const std::vector<aterm>& terms, write_chunk& chunk)
+{
+  std::unordered_set<unprotected_aterm> visited;
+  std::vector<std::pair<unprotected_aterm, std::size_t>> stack;
+
+  for (std::size_t i = chunk.begin; i < chunk.end; ++i)
+  {
+    if (terms[i].type_is_int())
+    {
+      continue;
+    }
+
+    // The term itself is only a subterm when it is reached as an argument.
+    const aterm_appl& root = down_cast<aterm_appl>(terms[i]);
+    for (const aterm& argument : root)
+    {
+      stack.emplace_back(argument, 0);
+      while (!stack.empty())
+      {
+        const aterm& term = static_cast<const aterm&>(stack.back().first);
+        const std::size_t next_argument = stack.back().second;
+
+        if (visited.count(term) != 0)
+        {
+          stack.pop_back();
+        }
+        else if (!term.type_is_int() && next_argument < term.function().arity())
+        {
+          ++stack.back().second;
+          stack.emplace_back(down_cast<aterm_appl>(term)[next_argument], 0);
+        }
+        else
+        {
+          visited.insert(term);
+          chunk.subterms.push_back(term);
+          stack.pop_back();
+        }
+      }
+    }
+  }
+}
+
+/// \brief Writes a term as a packet of the streamable format, of which all arguments have an index.
+template<typename IndexOf>
+void write_term_packet(mcrl2::utilities::obitstream& stream,
+  const aterm& term,
+  bool is_output,
+  const mcrl2::utilities::indexed_set<function_symbol>& function_symbols,
+  unsigned int term_index_width,
+  IndexOf index_of)
+{
+  // The function symbols are indexed from one onwards, index zero ends a chunk.
+  const unsigned int symbol_index_width = index_width(function_symbols.size() + 1);
+
+  if (term.type_is_int())
+  {
+    if (is_output)
+    {
+      stream.write_bits(static_cast<std::size_t>(packet_type::aterm_int_output), packet_bits);
+    }
+    else
+    {
+      stream.write_bits(static_cast<std::size_t>(packet_type::aterm), packet_bits);
+      stream.write_bits(function_symbols.index(term.function()) + 1, symbol_index_width);
+    }
+    stream.write_integer(down_cast<aterm_int>(term).value());
+  }
+  else
+  {
+    stream.write_bits(static_cast<std::size_t>(is_output ? packet_type::aterm_output : packet_type::aterm), packet_bits);
+    stream.write_bits(function_symbols.index(term.function()) + 1, symbol_index_width);
+    for (const aterm& argument : down_cast<aterm_appl>(term))
+    {
+      stream.write_bits(index_of(argument), term_index_width);
+    }
+  }
+}
+
+/// \brief Encodes a chunk, and compresses it if requested and beneficial.
+template<typename Encode>
+void encode_chunk(write_chunk& chunk,
+  const mcrl2::utilities::indexed_set<function_symbol>& function_symbols,
+  bool compress,
+  Encode encode)
+{
+  std::ostringstream output;
+  {
+    mcrl2::utilities::obitstream stream(output);
+    encode(stream);
+
+    // The term with function symbol index 0 ends the chunk.
+    stream.write_bits(static_cast<std::size_t>(packet_type::aterm), packet_bits);
+    stream.write_bits(0, index_width(function_symbols.size() + 1));
+  }
+
+  const std::string bytes = output.str();
+  chunk.size = bytes.size();
+  if (compress)
+  {
+    chunk.bytes = mcrl2::utilities::compress_block(reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size());
+    chunk.compressed = chunk.bytes.size() < bytes.size();
+  }
+
+  if (!chunk.compressed)
+  {
+    chunk.bytes.assign(bytes.begin(), bytes.end());
+  }
+}
+
+/// \brief Decodes the packets of a chunk.
+/// \param prefix The terms of the prefix, which precede the terms of the chunk in the index.
+/// \param terms The terms that are indexed in this chunk.
+/// \param output The output terms of this chunk.
+void decode_chunk(const std::vector<std::uint8_t>& bytes,
+  const std::deque<function_symbol>& function_symbols,
+  const std::vector<aterm>& prefix,
+  std::vector<aterm>& terms,
+  std::vector<aterm>& output,
+  aterm_transformer* transformer)
+{
+  std::istringstream input(std::string(bytes.begin(), bytes.end()));
+  mcrl2::utilities::ibitstream stream(input);
+
+  const unsigned int symbol_index_width = index_width(function_symbols.size());
+  std::vector<aterm> arguments;
+
+  while (true)
+  {
+    packet_type packet = static_cast<packet_type>(stream.read_bits(packet_bits));
+    if (packet == packet_type::aterm_int_output)
+    {
+      output.emplace_back(aterm_int(stream.read_integer()));
+    }
+    else if (packet == packet_type::aterm || packet == packet_type::aterm_output)
+    {
+      std::size_t symbol_index = stream.read_bits(symbol_index_width);
+      if (symbol_index == 0)
+      {
+        return;
+      }
+      else if (symbol_index >= function_symbols.size())
+      {
+        throw mcrl2::runtime_error("Error while reading: the chunked stream is corrupt.");
+      }
+
+      const function_symbol& symbol = function_symbols[symbol_index];
+      if (symbol == detail::g_as_int)
+      {
+        terms.emplace_back(aterm_int(stream.read_integer()));
+        continue;
+      }
+
+      const std::size_t number_of_terms = prefix.size() + terms.size();
+      const unsigned int term_index_width = index_width(number_of_terms);
+      arguments.resize(symbol.arity());
+      for (aterm& argument : arguments)
+      {
+        std::size_t index = stream.read_bits(term_index_width);
+        if (index >= number_of_terms)
+        {
+          throw mcrl2::runtime_error("Error while reading: the chunked stream is corrupt.");
+        }
+        argument = index < prefix.size() ? prefix[index] : terms[index - prefix.size()];
+      }
+
+      aterm transformed = transformer(aterm_appl(symbol, arguments.begin(), arguments.end()));
+      if (packet == packet_type::aterm_output)
+      {
+        output.emplace_back(transformed);
+      }
+      else
+      {
+        terms.emplace_back(transformed);
+      }
+    }
+    else
+    {
+      throw mcrl2::runtime_error("Error while reading: the chunked stream is corrupt.");
+    }
+  }
+}
+
+/// \brief Reads the terms of a chunked stream, of which the header has been read.
+void read_chunked_terms(mcrl2::utilities::ibitstream& stream,
+  std::vector<aterm>& terms,
+  std::size_t number_of_threads,
+  aterm_transformer* transformer)
+{
+  if (!detail::GlobalThreadSafe)
+  {
+    number_of_threads = 1;
+  }
+
+  // Index zero is the function symbol of the end of a chunk.
+  std::deque<function_symbol> function_symbols(1);
+  const std::size_t number_of_symbols = stream.read_integer();
+  for (std::size_t i = 0; i < number_of_symbols; ++i)
+  {
+    std::string name = stream.read_string();
+    std::size_t arity = stream.read_integer();
+    function_symbols.emplace_back(name, arity);
+  }
+
+  // Read all chunks, the first chunk is the prefix.
+  const std::size_t number_of_chunks = stream.read_integer();
+  std::vector<std::vector<std::uint8_t>> chunks(number_of_chunks);
+  std::vector<std::size_t> sizes(number_of_chunks);
+  std::vector<bool> compressed(number_of_chunks);
+  for (std::size_t i = 0; i < number_of_chunks; ++i)
+  {
+    compressed[i] = stream.read_integer() != 0;
+    sizes[i] = stream.read_integer();
+    chunks[i].resize(compressed[i] ? stream.read_integer() : sizes[i]);
+    stream.read(chunks[i].size(), chunks[i].data());
+  }
+
+  parallel_for(number_of_chunks, number_of_threads, [&](std::size_t i)
+    {
+      if (compressed[i])
+      {
+        std::vector<std::uint8_t> bytes(sizes[i]);
+        mcrl2::utilities::decompress_block(chunks[i].data(), chunks[i].size(), bytes.data(), bytes.size());
+        chunks[i] = std::move(bytes);
+      }
+    });
+
+  if (number_of_chunks == 0)
+  {
+    throw mcrl2::runtime_error("Error while reading: the chunked stream has no prefix.");
+  }
+
+  std::vector<aterm> prefix;
+  std::vector<aterm> prefix_output;
+  decode_chunk(chunks[0], function_symbols, {}, prefix, prefix_output, transformer);
+
+  std::vector<std::vector<aterm>> outputs(number_of_chunks);
+  parallel_for(number_of_chunks - 1, number_of_threads, [&](std::size_t i)
+    {
+      std::vector<aterm> local_terms;
+      decode_chunk(chunks[i + 1], function_symbols, prefix, local_terms, outputs[i + 1], transformer);
+    });
+
+  for (std::vector<aterm>& output : outputs)
+  {
+    terms.insert(terms.end(), output.begin(), output.end());
+  }
+}
+
+} // namespace
+
 binary_aterm_ostream::binary_aterm_ostream(std::shared_ptr<mcrl2::utilities::obitstream> stream)
   : m_stream(stream)
 {
@@ -203,7 +546,11 @@ binary_aterm_istream::binary_aterm_istream(std::shared_ptr<mcrl2::utilities::ibi
   }
 
   std::size_t version = m_stream->read_bits(16);
-  if (version != BAF_VERSION)
+  if (version == BAF_CHUNKED_VERSION)
+  {
+    m_chunked = true;
+  }
+  else if (version != BAF_VERSION)
   {
     throw mcrl2::runtime_error("The BAF version (" + std::to_string(version) + ") of the input file is incompatible with the version (" + std::to_string(BAF_VERSION) +
                                ") of this tool. The input file must be regenerated. ");
@@ -238,6 +585,21 @@ std::size_t binary_aterm_ostream::write_function_symbol(const function_symbol& s
 
 void binary_aterm_istream::get(aterm& t)
 {
+  if (m_chunked)
+  {
+    if (m_chunked_terms.empty())
+    {
+      // The transformer might not be thread safe, so a single thread decodes the chunks.
+      read_chunked_terms(*m_stream, m_chunked_terms, 1, m_transformer);
+      m_chunked_terms.emplace_back();
+    }
+
+    // After the last term, the end of the stream is returned repeatedly.
+    t = m_chunked_terms[m_next_chunked_term];
+    m_next_chunked_term = std::min(m_next_chunked_term + 1, m_chunked_terms.size() - 1);
+    return;
+  }
+
   while(true)
   {
     // Determine the type of the next packet.
@@ -318,6 +680,160 @@ unsigned int binary_aterm_istream::function_symbol_index_width()
   return m_function_symbol_index_width;
 }
 
+void write_terms_to_chunked_binary_stream(std::ostream& os,
+  const std::vector<aterm>& terms,
+  std::size_t number_of_threads,
+  bool compress)
+{
+  if (!detail::GlobalThreadSafe)
+  {
+    number_of_threads = 1;
+  }
+
+  // Divide the terms into chunks of consecutive terms, independently of the number of threads. The first chunk is
+  // the prefix.
+  std::vector<write_chunk> chunks(1);
+  const std::size_t terms_per_chunk = std::max<std::size_t>(1, (terms.size() + MaximumNumberOfChunks - 1) / MaximumNumberOfChunks);
+  for (std::size_t begin = 0; begin < terms.size(); begin += terms_per_chunk)
+  {
+    chunks.emplace_back();
+    chunks.back().begin = begin;
+    chunks.back().end = std::min(begin + terms_per_chunk, terms.size());
+  }
+
+  parallel_for(chunks.size() - 1, number_of_threads, [&](std::size_t i)
+    {
+      collect_subterms(terms, chunks[i + 1]);
+    });
+
+  // Determine the subterms that occur in more than one chunk, and the first chunk in which they occur.
+  struct occurrence
+  {
+    std::size_t chunk;
+    bool shared;
+  };
+
+  std::unordered_map<unprotected_aterm, occurrence> occurrences;
+  mcrl2::utilities::indexed_set<function_symbol> function_symbols;
+  for (std::size_t i = 1; i < chunks.size(); ++i)
+  {
+    for (const unprotected_aterm& subterm : chunks[i].subterms)
+    {
+      auto [it, inserted] = occurrences.emplace(subterm, occurrence{i, false});
+      if (inserted)
+      {
+        function_symbols.insert(static_cast<const aterm&>(subterm).function());
+      }
+      else if (it->second.chunk != i)
+      {
+        it->second.shared = true;
+      }
+    }
+
+    for (std::size_t j = chunks[i].begin; j < chunks[i].end; ++j)
+    {
+      if (!terms[j].type_is_int())
+      {
+        function_symbols.insert(terms[j].function());
+      }
+    }
+  }
+
+  // The shared subterms form the prefix, in the order of the chunk in which they occur first. Since the arguments of
+  // a shared subterm are shared as well, they precede it.
+  std::unordered_map<unprotected_aterm, std::size_t> prefix;
+  for (std::size_t i = 1; i < chunks.size(); ++i)
+  {
+    for (const unprotected_aterm& subterm : chunks[i].subterms)
+    {
+      const occurrence& o = occurrences[subterm];
+      if (o.shared && o.chunk == i)
+      {
+        prefix.emplace(subterm, prefix.size());
+        chunks[0].subterms.push_back(subterm);
+      }
+    }
+  }
+  occurrences.clear();
+
+  parallel_for(chunks.size(), number_of_threads, [&](std::size_t i)
+    {
+      encode_chunk(chunks[i], function_symbols, compress, [&](mcrl2::utilities::obitstream& stream)
+        {
+          // The terms of this chunk are indexed after the prefix, the terms of the prefix itself are in the prefix.
+          std::unordered_map<unprotected_aterm, std::size_t> local;
+          auto index_of = [&](const aterm& term) -> std::size_t
+            {
+              auto it = prefix.find(term);
+              return it != prefix.end() ? it->second : local.at(term);
+            };
+
+          std::size_t number_of_terms = i == 0 ? 0 : prefix.size();
+          for (const unprotected_aterm& subterm : chunks[i].subterms)
+          {
+            if (i == 0 || prefix.count(subterm) == 0)
+            {
+              const aterm& term = static_cast<const aterm&>(subterm);
+              write_term_packet(stream, term, false, function_symbols, index_width(number_of_terms), index_of);
+              if (i != 0)
+              {
+                local.emplace(term, number_of_terms);
+              }
+              ++number_of_terms;
+            }
+          }
+
+          for (std::size_t j = chunks[i].begin; j < chunks[i].end; ++j)
+          {
+            write_term_packet(stream, terms[j], true, function_symbols, index_width(number_of_terms), index_of);
+          }
+        });
+    });
+
+  // Write the header, the function symbols and the chunks.
+  mcrl2::utilities::obitstream stream(os);
+  stream.write_bits(0, 8);
+  stream.write_bits(BAF_MAGIC, 16);
+  stream.write_bits(BAF_CHUNKED_VERSION, 16);
+
+  stream.write_integer(function_symbols.size());
+  for (const function_symbol& symbol : function_symbols)
+  {
+    stream.write_string(symbol.name());
+    stream.write_integer(symbol.arity());
+  }
+
+  stream.write_integer(chunks.size());
+  for (const write_chunk& chunk : chunks)
+  {
+    stream.write_integer(chunk.compressed ? 1 : 0);
+    stream.write_integer(chunk.size);
+    if (chunk.compressed)
+    {
+      stream.write_integer(chunk.bytes.size());
+    }
+    stream.write(chunk.bytes.data(), chunk.bytes.size());
+  }
+}
+
+void read_terms_from_chunked_binary_stream(std::istream& is, std::vector<aterm>& terms, std::size_t number_of_threads)
+{
+  mcrl2::utilities::ibitstream stream(is);
+  if (stream.read_bits(8) != 0 || stream.read_bits(16) != BAF_MAGIC)
+  {
+    throw mcrl2::runtime_error("Error while reading: missing the BAF_MAGIC control sequence.");
+  }
+
+  std::size_t version = stream.read_bits(16);
+  if (version != BAF_CHUNKED_VERSION)
+  {
+    throw mcrl2::runtime_error("The BAF version (" + std::to_string(version) + ") of the input file is not the chunked version (" + std::to_string(BAF_CHUNKED_VERSION) +
+                               ") of this tool.");
+  }
+
+  read_chunked_terms(stream, terms, number_of_threads, identity);
+}
+
 void write_term_to_binary_stream(const aterm& t, std::ostream& os)
 {
   binary_aterm_ostream(os) << t;
@@ -0,0 +1,134 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "mcrl2/atermpp/detail/term_arena.h"
+
+#include <algorithm>
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+using namespace atermpp::detail;
+
+char* atermpp::detail::g_term_arena_begin = nullptr;
+
+/// \brief Reserves the given number of bytes of address space, without committing memory.
+static char* reserve_memory(std::size_t size)
+{
+#ifdef _WIN32
+  void* result = VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+  return static_cast<char*>(result);
+#else
+  void* result = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  return result == MAP_FAILED ? nullptr : static_cast<char*>(result);
+#endif
+}
+
+/// \brief Commits the given part of reserved address space.
+static bool commit_memory(char* begin, std::size_t size)
+{
+#ifdef _WIN32
+  return VirtualAlloc(begin, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+  return mprotect(begin, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+term_arena::term_arena()
+{
+  m_begin = reserve_memory(ReservedSize);
+  if (m_begin == nullptr)
+  {
+    throw std::bad_alloc();
+  }
+
+  // The offset zero represents the null pointer, so it is never allocated.
+  m_end = m_begin + Alignment;
+  m_committed = m_begin;
+  g_term_arena_begin = m_begin;
+}
+
+term_arena::~term_arena()
+{
+#ifdef _WIN32
+  VirtualFree(m_begin, 0, MEM_RELEASE);
+#else
+  munmap(m_begin, ReservedSize);
+#endif
+}
+
+void* term_arena::allocate(std::size_t size)
+{
+  const std::size_t units = std::max<std::size_t>(1, (size + Alignment - 1) / Alignment);
+
+  std::unique_lock<std::mutex> lock(m_mutex, std::defer_lock);
+  if constexpr (GlobalThreadSafe)
+  {
+    lock.lock();
+  }
+
+  if (units < m_free_lists.size() && m_free_lists[units] != nullptr)
+  {
+    void* result = m_free_lists[units];
+    m_free_lists[units] = *static_cast<void**>(result);
+    return result;
+  }
+
+  if (units * Alignment > static_cast<std::size_t>(m_begin + ReservedSize - m_end))
+  {
+    throw std::bad_alloc();
+  }
+
+  char* result = m_end;
+  m_end += units * Alignment;
+  if (m_end > m_committed)
+  {
+    // Commit enough chunks to contain this allocation.
+    std::size_t size = ((m_end - m_committed + ChunkSize - 1) / ChunkSize) * ChunkSize;
+    size = std::min(size, static_cast<std::size_t>(m_begin + ReservedSize - m_committed));
+    if (!commit_memory(m_committed, size))
+    {
+      m_end = result;
+      throw std::bad_alloc();
+    }
+    m_committed += size;
+  }
+
+  return result;
+}
+
+void term_arena::deallocate(void* pointer, std::size_t size)
+{
+  const std::size_t units = std::max<std::size_t>(1, (size + Alignment - 1) / Alignment);
+
+  std::unique_lock<std::mutex> lock(m_mutex, std::defer_lock);
+  if constexpr (GlobalThreadSafe)
+  {
+    lock.lock();
+  }
+
+  if (units >= m_free_lists.size())
+  {
+    m_free_lists.resize(units + 1, nullptr);
+  }
+
+  *static_cast<void**>(pointer) = m_free_lists[units];
+  m_free_lists[units] = pointer;
+}
+
+term_arena& atermpp::detail::g_term_arena()
+{
+  // The arena is never destroyed, as terms can be used until the very end of the program.
+  static term_arena* instance = new term_arena();
+  return *instance;
+}
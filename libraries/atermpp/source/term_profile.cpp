@@ -0,0 +1,225 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "mcrl2/atermpp/term_profile.h"
+
+#include "mcrl2/atermpp/detail/global_aterm_pool.h"
+#include "mcrl2/utilities/exception.h"
+#include "mcrl2/utilities/logger.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
+using namespace atermpp;
+using namespace atermpp::detail;
+
+namespace
+{
+
+/// \brief The number of function symbols that are listed as the largest retainers of memory.
+constexpr std::size_t NumberOfRetainers = 20;
+
+/// \brief Writes the string as a JSON string, with the quotes and control characters escaped.
+void write_json_string(std::ostream& stream, const std::string& text)
+{
+  stream << '"';
+  for (char c : text)
+  {
+    if (c == '"' || c == '\\')
+    {
+      stream << '\\' << c;
+    }
+    else if (static_cast<unsigned char>(c) < 0x20)
+    {
+      stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+    }
+    else
+    {
+      stream << c;
+    }
+  }
+  stream << '"';
+}
+
+/// \returns The ratio of the two numbers, or zero if the denominator is zero.
+double ratio(std::size_t numerator, std::size_t denominator)
+{
+  return denominator == 0 ? 0.0 : static_cast<double>(numerator) / static_cast<double>(denominator);
+}
+
+void write_profile_at_exit()
+{
+  g_term_pool().profile().write_file();
+}
+
+#ifdef SIGUSR1
+extern "C" void request_profile(int)
+{
+  term_profile::request_write();
+}
+#endif
+
+} // namespace
+
+void term_profile::enable(const std::string& filename, std::function<std::size_t(const function_symbol&)> size_of_term)
+{
+  m_filename = filename;
+  m_size_of_term = std::move(size_of_term);
+  m_start = std::chrono::steady_clock::now();
+  m_enabled = true;
+
+  std::atexit(write_profile_at_exit);
+#ifdef SIGUSR1
+  std::signal(SIGUSR1, request_profile);
+#endif
+}
+
+void term_profile::collected(std::chrono::duration<double, std::micro> pause, bool young_collection)
+{
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    ++(young_collection ? m_number_of_young_collections : m_number_of_collections);
+
+    std::size_t bucket = 0;
+    while (bucket + 1 < NumberOfPauseBuckets && pause.count() >= static_cast<double>(std::size_t(1) << bucket))
+    {
+      ++bucket;
+    }
+    ++m_pause_histogram[bucket];
+    m_total_pause += pause;
+    m_longest_pause = std::max(m_longest_pause, pause);
+
+    for (auto& [symbol, counters] : m_symbols)
+    {
+      const std::size_t live = counters.live();
+      counters.candidates += live + counters.destroyed - counters.destroyed_before_collection;
+      counters.survived += live;
+      counters.destroyed_before_collection = counters.destroyed;
+      counters.peak = std::max(counters.peak, live);
+    }
+  }
+
+  if (g_write_requested != 0)
+  {
+    g_write_requested = 0;
+    write_file();
+  }
+}
+
+void term_profile::write_json(std::ostream& stream)
+{
+  std::lock_guard<std::mutex> guard(m_mutex);
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+
+  std::vector<std::pair<function_symbol, symbol_counters>> symbols(m_symbols.begin(), m_symbols.end());
+  std::sort(symbols.begin(), symbols.end(), [](const auto& x, const auto& y) { return x.second.live() > y.second.live(); });
+
+  stream << "{\n"
+         << "  \"seconds\": " << seconds << ",\n"
+         << "  \"collections\": " << m_number_of_collections << ",\n"
+         << "  \"young_collections\": " << m_number_of_young_collections << ",\n"
+         << "  \"total_pause_ms\": " << m_total_pause.count() / 1000 << ",\n"
+         << "  \"longest_pause_ms\": " << m_longest_pause.count() / 1000 << ",\n"
+         << "  \"pause_histogram\": [";
+  bool first = true;
+  for (std::size_t i = 0; i < NumberOfPauseBuckets; ++i)
+  {
+    if (m_pause_histogram[i] != 0)
+    {
+      stream << (first ? "\n" : ",\n") << "    { \"below_us\": ";
+      if (i + 1 < NumberOfPauseBuckets)
+      {
+        stream << (std::size_t(1) << i);
+      }
+      else
+      {
+        stream << "null";
+      }
+      stream << ", \"count\": " << m_pause_histogram[i] << " }";
+      first = false;
+    }
+  }
+  stream << (first ? "],\n" : "\n  ],\n");
+
+  stream << "  \"function_symbols\": [";
+  first = true;
+  for (const auto& [symbol, counters] : symbols)
+  {
+    stream << (first ? "\n" : ",\n") << "    { \"name\": ";
+    write_json_string(stream, symbol.name());
+    stream << ", \"arity\": " << symbol.arity()
+           << ", \"live\": " << counters.live()
+           << ", \"peak_live\": " << std::max(counters.peak, counters.live())
+           << ", \"created\": " << counters.created
+           << ", \"created_per_second\": " << (seconds > 0 ? static_cast<double>(counters.created) / seconds : 0.0)
+           << ", \"found\": " << counters.found
+           << ", \"hit_ratio\": " << ratio(counters.found, counters.found + counters.created)
+           << ", \"destroyed\": " << counters.destroyed
+           << ", \"survival_ratio\": " << ratio(counters.survived, counters.candidates)
+           << " }";
+    first = false;
+  }
+  stream << (first ? "],\n" : "\n  ],\n");
+
+  // The function symbols of which the live terms occupy the most memory.
+  std::vector<std::pair<std::size_t, const function_symbol*>> retainers;
+  for (const auto& [symbol, counters] : symbols)
+  {
+    retainers.emplace_back(counters.live() * m_size_of_term(symbol), &symbol);
+  }
+  std::sort(retainers.begin(), retainers.end(), [](const auto& x, const auto& y) { return x.first > y.first; });
+  retainers.resize(std::min(retainers.size(), NumberOfRetainers));
+
+  stream << "  \"retainers\": [";
+  first = true;
+  for (const auto& [bytes, symbol] : retainers)
+  {
+    stream << (first ? "\n" : ",\n") << "    { \"name\": ";
+    write_json_string(stream, symbol->name());
+    stream << ", \"arity\": " << symbol->arity() << ", \"bytes\": " << bytes << " }";
+    first = false;
+  }
+  stream << (first ? "]\n" : "\n  ]\n") << "}\n";
+}
+
+void term_profile::write_file()
+{
+  std::ofstream stream(m_filename);
+  if (!stream)
+  {
+    mCRL2log(mcrl2::log::error) << "Could not write the term profile to " << m_filename << "." << std::endl;
+    return;
+  }
+  write_json(stream);
+  mCRL2log(mcrl2::log::verbose) << "Wrote the term profile to " << m_filename << "." << std::endl;
+}
+
+void atermpp::enable_term_profile(const std::string& filename)
+{
+  if (!EnableTermProfile)
+  {
+    throw mcrl2::runtime_error("The term library was compiled without support for profiles.");
+  }
+
+  g_thread_term_pool().lock();
+  g_term_pool().enable_profile(filename);
+  g_thread_term_pool().unlock();
+}
+
+void atermpp::write_term_profile(std::ostream& stream)
+{
+  if (!g_term_pool().profile().enabled())
+  {
+    throw mcrl2::runtime_error("The term profile has not been enabled.");
+  }
+  g_term_pool().profile().write_json(stream);
+}
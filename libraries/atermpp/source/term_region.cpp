@@ -0,0 +1,365 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "mcrl2/atermpp/term_region.h"
+#include "mcrl2/atermpp/aterm_appl.h"
+#include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/utilities/exception.h"
+#include "mcrl2/utilities/platform.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#ifdef MCRL2_PLATFORM_WINDOWS
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace atermpp
+{
+
+/// \details A term region file consists of 64-bit words in the byte order of the platform. It starts with a header
+///          that consists of the magic value, the version, the layout of the terms, the number of function symbols,
+///          the number of roots and the number of terms. This is followed by every function symbol as its arity, the
+///          length of its name and its name padded to a multiple of eight bytes, and then by the index of every root.
+///          Finally, there is one record for every term, such that the arguments of a term precede it. A record
+///          consists of the index of its function symbol, followed by the indices of its arguments or the value of an
+///          integral term, and is padded to the size of the term in the region. On loading, the records are
+///          overwritten by the terms themselves.
+static constexpr std::uint64_t TERM_REGION_MAGIC = 0x6e6f696765526d54; // "TmRegion"
+static constexpr std::uint64_t TERM_REGION_VERSION = 1;
+
+namespace
+{
+
+/// \returns A value that identifies the layout of the terms in a region, which must be equal between writing and
+///          reading a term region.
+std::uint64_t term_region_layout(detail::aterm_pool& pool)
+{
+  std::uint64_t layout = sizeof(std::size_t);
+  layout = layout * 257 + sizeof(aterm);
+  layout = layout * 257 + pool.region_size(pool.as_int());
+  for (std::size_t arity = 0; arity <= 8; ++arity)
+  {
+    layout = layout * 257 + pool.region_size(function_symbol("", arity));
+  }
+  return layout;
+}
+
+/// \returns The number of bytes of the record of a term with the given function symbol.
+std::size_t record_size(detail::aterm_pool& pool, const function_symbol& symbol)
+{
+  const std::size_t fields = 1 + (symbol == pool.as_int() ? 1 : symbol.arity());
+  const std::size_t size = std::max(pool.region_size(symbol), fields * sizeof(std::uint64_t));
+  return (size + sizeof(std::uint64_t) - 1) & ~(sizeof(std::uint64_t) - 1);
+}
+
+/// \returns Memory that contains the given file, which is writable without affecting the file.
+/// \details The memory is never released, because the terms that are constructed in it are never destroyed.
+char* map_term_region(const std::string& filename, std::size_t& size)
+{
+#ifdef MCRL2_ATERMPP_COMPRESSED_REFERENCES
+  // Terms must be addressable by a reference into the term arena, so the file is read into the arena instead.
+  std::ifstream stream(filename, std::ios::binary | std::ios::ate);
+  if (!stream)
+  {
+    throw mcrl2::runtime_error("Could not open term region " + filename + ".");
+  }
+  size = static_cast<std::size_t>(stream.tellg());
+  char* memory = static_cast<char*>(detail::g_term_arena().allocate(size));
+  stream.seekg(0);
+  stream.read(memory, static_cast<std::streamsize>(size));
+  if (!stream)
+  {
+    throw mcrl2::runtime_error("Could not read term region " + filename + ".");
+  }
+  return memory;
+#elif defined(MCRL2_PLATFORM_WINDOWS)
+  HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    throw mcrl2::runtime_error("Could not open term region " + filename + ".");
+  }
+
+  LARGE_INTEGER file_size;
+  GetFileSizeEx(file, &file_size);
+  size = static_cast<std::size_t>(file_size.QuadPart);
+
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr)
+  {
+    throw mcrl2::runtime_error("Could not map term region " + filename + ".");
+  }
+
+  void* memory = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+  CloseHandle(mapping);
+  if (memory == nullptr)
+  {
+    throw mcrl2::runtime_error("Could not map term region " + filename + ".");
+  }
+  return static_cast<char*>(memory);
+#else
+  int file = open(filename.c_str(), O_RDONLY);
+  if (file < 0)
+  {
+    throw mcrl2::runtime_error("Could not open term region " + filename + ".");
+  }
+
+  struct stat status;
+  if (fstat(file, &status) != 0 || status.st_size == 0)
+  {
+    close(file);
+    throw mcrl2::runtime_error("Could not read term region " + filename + ".");
+  }
+  size = static_cast<std::size_t>(status.st_size);
+
+  // A private mapping can be written to, which copies only the pages that are written.
+  void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+  close(file);
+  if (memory == MAP_FAILED)
+  {
+    throw mcrl2::runtime_error("Could not map term region " + filename + ".");
+  }
+  return static_cast<char*>(memory);
+#endif
+}
+
+} // namespace
+
+void save_term_region(const std::string& filename, const std::vector<aterm>& terms)
+{
+  detail::aterm_pool& pool = detail::g_term_pool();
+
+  std::vector<function_symbol> symbols;
+  std::unordered_map<function_symbol, std::uint64_t> symbol_indices;
+  std::unordered_map<unprotected_aterm, std::uint64_t> term_indices;
+  std::vector<std::uint64_t> records;
+
+  // Number the terms in post order, such that the arguments of a term are numbered before the term itself.
+  std::vector<std::pair<unprotected_aterm, std::size_t>> stack;
+  for (const aterm& root : terms)
+  {
+    stack.emplace_back(root, 0);
+    while (!stack.empty())
+    {
+      const aterm term(detail::address(stack.back().first));
+      const std::size_t argument = stack.back().second;
+
+      if (term_indices.count(term) != 0)
+      {
+        stack.pop_back();
+      }
+      else if (!term.type_is_int() && argument < term.function().arity())
+      {
+        ++stack.back().second;
+        stack.emplace_back(down_cast<aterm_appl>(term)[argument], 0);
+      }
+      else
+      {
+        const function_symbol& symbol = term.function();
+        auto [symbol_index, inserted] = symbol_indices.emplace(symbol, symbols.size());
+        if (inserted)
+        {
+          symbols.push_back(symbol);
+        }
+
+        const std::size_t begin = records.size();
+        records.push_back(symbol_index->second);
+        if (term.type_is_int())
+        {
+          records.push_back(down_cast<aterm_int>(term).value());
+        }
+        else
+        {
+          for (const aterm& subterm : down_cast<aterm_appl>(term))
+          {
+            records.push_back(term_indices[subterm]);
+          }
+        }
+        records.resize(begin + record_size(pool, symbol) / sizeof(std::uint64_t), 0);
+
+        term_indices.emplace(term, term_indices.size());
+        stack.pop_back();
+      }
+    }
+  }
+
+  std::vector<std::uint64_t> header = { TERM_REGION_MAGIC,
+    TERM_REGION_VERSION,
+    term_region_layout(pool),
+    symbols.size(),
+    terms.size(),
+    term_indices.size() };
+
+  for (const function_symbol& symbol : symbols)
+  {
+    const std::string& name = symbol.name();
+    header.push_back(symbol.arity());
+    header.push_back(name.size());
+
+    const std::size_t begin = header.size();
+    header.resize(begin + (name.size() + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t), 0);
+    std::memcpy(header.data() + begin, name.data(), name.size());
+  }
+
+  for (const aterm& root : terms)
+  {
+    header.push_back(term_indices[root]);
+  }
+
+  std::ofstream stream(filename, std::ios::binary | std::ios::trunc);
+  stream.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size() * sizeof(std::uint64_t)));
+  stream.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(std::uint64_t)));
+  if (!stream)
+  {
+    throw mcrl2::runtime_error("Could not write term region " + filename + ".");
+  }
+}
+
+std::vector<aterm> load_term_region(const std::string& filename)
+{
+  detail::aterm_pool& pool = detail::g_term_pool();
+
+  std::size_t size = 0;
+  char* memory = map_term_region(filename, size);
+  const std::uint64_t* words = reinterpret_cast<const std::uint64_t*>(memory);
+  const std::uint64_t* end = words + size / sizeof(std::uint64_t);
+
+  auto read = [&]() -> std::uint64_t
+  {
+    if (words == end)
+    {
+      throw mcrl2::runtime_error("The term region " + filename + " is truncated.");
+    }
+    return *words++;
+  };
+
+  if (read() != TERM_REGION_MAGIC)
+  {
+    throw mcrl2::runtime_error("The file " + filename + " is not a term region.");
+  }
+  if (read() != TERM_REGION_VERSION || read() != term_region_layout(pool))
+  {
+    throw mcrl2::runtime_error("The term region " + filename + " was written by an incompatible version of the toolset.");
+  }
+
+  const std::size_t number_of_symbols = read();
+  const std::size_t number_of_roots = read();
+  const std::size_t number_of_terms = read();
+
+  // The function symbols are created before the pool is locked, because that can trigger a garbage collection.
+  std::vector<function_symbol> symbols;
+  for (std::size_t i = 0; i < number_of_symbols; ++i)
+  {
+    const std::size_t arity = read();
+    const std::size_t length = read();
+    const std::size_t padded_length = (length + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+    if (static_cast<std::size_t>(end - words) < padded_length)
+    {
+      throw mcrl2::runtime_error("The term region " + filename + " is truncated.");
+    }
+
+    symbols.emplace_back(std::string(reinterpret_cast<const char*>(words), length), arity);
+    words += padded_length;
+  }
+
+  std::vector<std::uint64_t> roots;
+  for (std::size_t i = 0; i < number_of_roots; ++i)
+  {
+    roots.push_back(read());
+  }
+
+  std::vector<detail::_aterm*> region_terms(number_of_terms);
+  std::vector<unprotected_aterm> arguments;
+  detail::term_region region;
+
+  detail::g_thread_term_pool().lock();
+  try
+  {
+    for (std::size_t i = 0; i < number_of_terms; ++i)
+    {
+      char* record = const_cast<char*>(reinterpret_cast<const char*>(words));
+      const std::uint64_t symbol_index = read();
+      if (symbol_index >= symbols.size())
+      {
+        throw mcrl2::runtime_error("The term region " + filename + " is corrupt.");
+      }
+
+      const function_symbol& symbol = symbols[symbol_index];
+      const std::size_t size = record_size(pool, symbol);
+      if (static_cast<std::size_t>(reinterpret_cast<const char*>(end) - record) < size)
+      {
+        throw mcrl2::runtime_error("The term region " + filename + " is truncated.");
+      }
+
+      // The fields are read before the record is overwritten by the term.
+      std::size_t value = 0;
+      arguments.clear();
+      if (symbol == pool.as_int())
+      {
+        value = read();
+      }
+      else
+      {
+        for (std::size_t j = 0; j < symbol.arity(); ++j)
+        {
+          const std::uint64_t index = read();
+          if (index >= i)
+          {
+            throw mcrl2::runtime_error("The term region " + filename + " is corrupt.");
+          }
+          arguments.emplace_back(region_terms[index]);
+        }
+      }
+
+      detail::_aterm* term = pool.adopt_term(record, symbol, arguments.data(), value);
+      region_terms[i] = term;
+      if (reinterpret_cast<char*>(term) >= record && reinterpret_cast<char*>(term) < record + size)
+      {
+        region.terms.push_back(term);
+      }
+      else
+      {
+        region.external_terms.push_back(term);
+      }
+
+      words = reinterpret_cast<const std::uint64_t*>(record + size);
+    }
+
+    pool.add_term_region(std::move(region));
+  }
+  catch (...)
+  {
+    // The terms that have been adopted so far are valid, and must remain reachable.
+    pool.add_term_region(std::move(region));
+    detail::g_thread_term_pool().unlock();
+    throw;
+  }
+  detail::g_thread_term_pool().unlock();
+
+  std::vector<aterm> result;
+  for (std::uint64_t root : roots)
+  {
+    if (root >= number_of_terms)
+    {
+      throw mcrl2::runtime_error("The term region " + filename + " is corrupt.");
+    }
+    result.emplace_back(region_terms[root]);
+  }
+  return result;
+}
+
+} // namespace atermpp
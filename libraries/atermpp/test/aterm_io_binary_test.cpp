@@ -104,3 +104,58 @@ BOOST_AUTO_TEST_CASE(transitions_test)
     BOOST_CHECK_EQUAL(t, sequence[index]);
   }
 }
+
+BOOST_AUTO_TEST_CASE(chunked_test)
+{
+  // Many terms that share subterms within and between chunks, integral terms and a term with a large arity.
+  std::vector<aterm> sequence;
+  function_symbol f("f", 2);
+  function_symbol g("g", 9);
+  aterm shared = aterm_appl(function_symbol("shared", 1), aterm_int(42));
+  for (std::size_t index = 0; index < 1000; ++index)
+  {
+    aterm local = aterm_appl(f, aterm_int(index), shared);
+    sequence.push_back(aterm_appl(f, local, index % 3 == 0 ? shared : local));
+    if (index % 100 == 0)
+    {
+      sequence.push_back(aterm_int(index));
+      sequence.push_back(aterm_appl(g, local, local, shared, local, shared, aterm_int(1), local, local, local));
+      sequence.push_back(shared);
+    }
+  }
+
+  for (bool compress : { false, true })
+  {
+    for (std::size_t number_of_threads : { 1, 4 })
+    {
+      std::stringstream stream;
+      write_terms_to_chunked_binary_stream(stream, sequence, number_of_threads, compress);
+      std::string bytes = stream.str();
+
+      std::vector<aterm> terms;
+      read_terms_from_chunked_binary_stream(stream, terms, number_of_threads);
+      BOOST_CHECK(terms == sequence);
+
+      // The binary aterm stream reads the terms in order, followed by the end of the stream.
+      std::stringstream input_stream(bytes);
+      binary_aterm_istream input(input_stream);
+      for (const aterm& term : sequence)
+      {
+        aterm t;
+        input.get(t);
+        BOOST_CHECK_EQUAL(t, term);
+      }
+
+      aterm end;
+      input.get(end);
+      BOOST_CHECK(!end.defined());
+    }
+  }
+
+  // An empty sequence of terms.
+  std::stringstream stream;
+  write_terms_to_chunked_binary_stream(stream, {});
+  std::vector<aterm> terms;
+  read_terms_from_chunked_binary_stream(stream, terms);
+  BOOST_CHECK(terms.empty());
+}
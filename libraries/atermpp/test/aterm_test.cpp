@@ -14,6 +14,9 @@
 
 #include "mcrl2/atermpp/aterm_io.h"
 #include "mcrl2/atermpp/aterm_string.h"
+#include "mcrl2/atermpp/standard_containers/vector.h"
+
+#include <thread>
 
 using namespace atermpp;
 
@@ -78,3 +81,77 @@ BOOST_AUTO_TEST_CASE(test_several_aterm_io)
   test_aterm_io("[a,b,[]]");
   test_aterm_io("f([a,f(x),[]],2,[g,g(34566)])"); 
 }
+
+BOOST_AUTO_TEST_CASE(test_young_collection)
+{
+  // Collect the young terms after every 1000 created terms.
+  detail::g_term_pool().set_nursery_size(1000);
+  function_symbol f("f", 2);
+
+  // Young terms that are created by a thread that has finished are referred to by the young terms of this thread.
+  aterm_list orphans;
+#ifdef MCRL2_THREAD_SAFE
+  std::thread([&]()
+    {
+      aterm_list list;
+      for (std::size_t i = 0; i < 500; ++i)
+      {
+        list.push_front(aterm_int(1000000 + i));
+      }
+      orphans = list;
+    }).join();
+#endif
+
+  atermpp::vector<aterm> kept;
+  aterm survivor = orphans;
+  for (std::size_t i = 0; i < 100000; ++i)
+  {
+    // Most of the terms are garbage immediately.
+    aterm garbage = aterm_appl(f, aterm_int(i), aterm_int(i + 1));
+    if (i % 100 == 0)
+    {
+      survivor = aterm_appl(f, survivor, garbage);
+      kept.push_back(aterm_appl(f, garbage, survivor));
+    }
+  }
+
+  // Check that the surviving terms are intact.
+  for (std::size_t i = kept.size(); i > 0; --i)
+  {
+    const aterm_appl& t = down_cast<aterm_appl>(static_cast<const aterm&>(kept[i - 1]));
+    BOOST_CHECK_EQUAL(down_cast<aterm_int>(down_cast<aterm_appl>(t[0])[0]).value(), 100 * (i - 1));
+    BOOST_CHECK(t[1] == survivor);
+    survivor = down_cast<aterm_appl>(survivor)[0];
+  }
+  BOOST_CHECK(survivor == orphans);
+  BOOST_CHECK_EQUAL(down_cast<aterm_list>(survivor).size(), orphans.size());
+
+  // The garbage has been collected without collecting all terms.
+  BOOST_CHECK(detail::g_term_pool().size() < 50000);
+  detail::g_term_pool().set_nursery_size(detail::DefaultNurserySize);
+}
+
+BOOST_AUTO_TEST_CASE(test_term_references)
+{
+  function_symbol f("f", 2);
+  aterm_int one(1);
+  aterm t = aterm_appl(f, one, aterm_appl(f, one, one));
+  aterm_list l({ t, one });
+  BOOST_CHECK_EQUAL(down_cast<aterm_appl>(down_cast<aterm_appl>(t)[1])[0], one);
+  BOOST_CHECK_EQUAL(l.front(), t);
+  BOOST_CHECK_EQUAL(l.tail().front(), one);
+  BOOST_CHECK(!aterm().defined());
+
+#ifdef MCRL2_ATERMPP_COMPRESSED_REFERENCES
+  BOOST_CHECK_EQUAL(sizeof(aterm), sizeof(std::uint32_t));
+
+  // Freed memory is reused for terms of the same size.
+  detail::term_arena& arena = detail::g_term_arena();
+  void* block = arena.allocate(24);
+  arena.deallocate(block, 24);
+  BOOST_CHECK_EQUAL(arena.allocate(24), block);
+  arena.deallocate(block, 24);
+#else
+  BOOST_CHECK_EQUAL(sizeof(aterm), sizeof(void*));
+#endif
+}
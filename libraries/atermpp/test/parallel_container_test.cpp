@@ -12,6 +12,7 @@
 
 #include "mcrl2/utilities/configuration.h"
 #include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/atermpp/aterm_list.h"
 #include "mcrl2/atermpp/standard_containers/vector.h"
 #include "mcrl2/atermpp/detail/global_aterm_pool.h"
 
@@ -56,3 +57,59 @@ BOOST_AUTO_TEST_CASE(parallel_vector)
 #endif
 }
 
+
+BOOST_AUTO_TEST_CASE(parallel_garbage_collection)
+{
+#ifdef MCRL2_THREAD_SAFE
+  // Several threads create terms, and keep some of them in variables and containers, while the garbage
+  // collection marks and sweeps with several threads.
+  atermpp::detail::g_term_pool().set_collection_threads(4);
+
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < 3; ++t)
+  {
+    threads.emplace_back([t]()
+    {
+      atermpp::function_symbol f("f", 2);
+      atermpp::vector<atermpp::aterm> vector;
+      for (std::size_t i = 0; i < 100; ++i)
+      {
+        atermpp::term_list<atermpp::aterm_int> list;
+        for (std::size_t j = 0; j < 1000; ++j)
+        {
+          list.push_front(atermpp::aterm_int(t * 1000000 + i * 1000 + j));
+        }
+        vector.push_back(atermpp::aterm_appl(f, list, atermpp::aterm_int(i)));
+
+        if (i % 10 == 0)
+        {
+          atermpp::detail::g_term_pool().collect();
+        }
+      }
+
+      // All terms in the container must have survived the garbage collections.
+      for (std::size_t i = 0; i < 100; ++i)
+      {
+        const atermpp::aterm_appl& term = atermpp::down_cast<atermpp::aterm_appl>(static_cast<const atermpp::aterm&>(vector[i]));
+        BOOST_CHECK_EQUAL(atermpp::down_cast<atermpp::aterm_int>(term[1]).value(), i);
+
+        const atermpp::term_list<atermpp::aterm_int>& list = atermpp::down_cast<atermpp::term_list<atermpp::aterm_int>>(term[0]);
+        BOOST_CHECK_EQUAL(list.size(), 1000u);
+        BOOST_CHECK_EQUAL(list.front().value(), t * 1000000 + i * 1000 + 999);
+      }
+    });
+  }
+
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    atermpp::detail::g_term_pool().collect();
+  }
+
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+
+  atermpp::detail::g_term_pool().set_collection_threads(0);
+#endif
+}
@@ -267,3 +267,26 @@ BOOST_AUTO_TEST_CASE(cached_bottom_up_replace_test)
   BOOST_CHECK(cache.size() == 4);
 }
 
+
+BOOST_AUTO_TEST_CASE(cached_replace_test)
+{
+  std::unordered_map<aterm_appl, aterm> cache;
+  atermpp::aterm t  = atermpp::read_term_from_string("h(g(f(x),f(x)),g(f(x),f(x)))");
+  atermpp::aterm t1 = atermpp::replace(t, fg_replacer(), cache);
+  BOOST_CHECK(t1 == atermpp::replace(t, fg_replacer()));
+  BOOST_CHECK(t1 == atermpp::read_term_from_string("h(f(f(x),f(x)),f(f(x),f(x)))"));
+
+  // Replacing g(...) stops the traversal, so f(x) and x are not visited.
+  BOOST_CHECK(cache.size() == 2);
+
+  // A term in which the number of paths to x doubles with every level.
+  aterm_appl u = read_appl_from_string("x");
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    u = aterm_appl(f2(), u, u);
+  }
+  cache.clear();
+  aterm_appl u1 = atermpp::replace(u, replace_f(), cache);
+  BOOST_CHECK(u1 == u);
+  BOOST_CHECK(cache.size() == 101);
+}
@@ -0,0 +1,52 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "mcrl2/atermpp/aterm_appl.h"
+#include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/atermpp/term_profile.h"
+
+#define BOOST_AUTO_TEST_MAIN
+#include <boost/test/included/unit_test.hpp>
+
+#include <sstream>
+
+using namespace atermpp;
+
+BOOST_AUTO_TEST_CASE(test_term_profile)
+{
+  function_symbol f("profiled", 2);
+  aterm kept = aterm_appl(f, aterm_int(0), aterm_int(0));
+
+  enable_term_profile("term_profile_test.json");
+
+  // Terms of which one in ten is kept, and each is created twice.
+  std::vector<aterm> terms;
+  for (std::size_t i = 1; i <= 1000; ++i)
+  {
+    aterm t = aterm_appl(f, aterm_int(i), aterm_int(0));
+    aterm u = aterm_appl(f, aterm_int(i), aterm_int(0));
+    BOOST_CHECK(t == u);
+    if (i % 10 == 0)
+    {
+      terms.push_back(t);
+    }
+  }
+  detail::g_term_pool().collect();
+
+  std::stringstream stream;
+  write_term_profile(stream);
+  const std::string profile = stream.str();
+
+  BOOST_CHECK(profile.find("\"collections\": 1,") != std::string::npos);
+  BOOST_CHECK(profile.find("\"pause_histogram\": [\n") != std::string::npos);
+  BOOST_CHECK(profile.find("{ \"name\": \"profiled\", \"arity\": 2, \"live\": 101, \"peak_live\": 101, \"created\": 1000, ")
+    != std::string::npos);
+  BOOST_CHECK(profile.find("\"found\": 1000, \"hit_ratio\": 0.5, \"destroyed\": 900, ") != std::string::npos);
+  BOOST_CHECK(profile.find("\"retainers\": [\n    { \"name\": ") != std::string::npos);
+}
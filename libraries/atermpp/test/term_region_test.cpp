@@ -0,0 +1,86 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "mcrl2/atermpp/aterm_appl.h"
+#include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/atermpp/aterm_list.h"
+#include "mcrl2/atermpp/term_region.h"
+
+#define BOOST_AUTO_TEST_MAIN
+#include <boost/test/included/unit_test.hpp>
+
+#include <cstdio>
+
+using namespace atermpp;
+
+/// \returns The terms that are stored in the region, which are created anew on every call.
+static std::vector<aterm> region_terms(const aterm& kept)
+{
+  function_symbol f("f", 2);
+  function_symbol g("g", 9);
+  aterm a = aterm_appl(function_symbol("a", 0));
+
+  aterm nested = aterm_appl(f, aterm_int(1), a);
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    nested = aterm_appl(f, nested, aterm_int(i));
+  }
+
+  aterm wide = aterm_appl(g, a, aterm_int(2), nested, kept, a, a, aterm_int(3), nested, kept);
+  aterm_list list({ wide, a, aterm_int(4) });
+  return { nested, wide, list, kept, a };
+}
+
+BOOST_AUTO_TEST_CASE(test_term_region)
+{
+  const std::string filename = "term_region_test.trg";
+
+  // A term that exists before the region is loaded, which the region must use instead of its own copy.
+  aterm kept = aterm_appl(function_symbol("f", 2), aterm_int(100), aterm_int(200));
+  save_term_region(filename, region_terms(kept));
+  detail::g_term_pool().collect();
+
+  std::vector<aterm> loaded = load_term_region(filename);
+  std::remove(filename.c_str());
+
+  // The loaded terms are the unique representation of these terms.
+  std::vector<aterm> expected = region_terms(kept);
+  BOOST_CHECK_EQUAL(loaded.size(), expected.size());
+  for (std::size_t i = 0; i < loaded.size(); ++i)
+  {
+    BOOST_CHECK(loaded[i] == expected[i]);
+  }
+  BOOST_CHECK(loaded[3] == kept);
+
+  std::vector<const detail::_aterm*> addresses;
+  for (const aterm& term : loaded)
+  {
+    addresses.push_back(detail::address(term));
+  }
+
+  // The terms of the region survive the garbage collections, and can be used to build new terms.
+  loaded.clear();
+  expected.clear();
+  detail::g_term_pool().set_nursery_size(1000);
+  function_symbol h("h", 2);
+  aterm built = aterm_int(0);
+  for (std::size_t i = 0; i < 10000; ++i)
+  {
+    built = aterm_appl(h, region_terms(kept)[i % 3], i % 100 == 0 ? built : aterm_int(i));
+  }
+  detail::g_term_pool().collect();
+  detail::g_term_pool().set_nursery_size(detail::DefaultNurserySize);
+
+  expected = region_terms(kept);
+  for (std::size_t i = 0; i < expected.size(); ++i)
+  {
+    BOOST_CHECK(detail::address(expected[i]) == addresses[i]);
+  }
+  BOOST_CHECK(down_cast<aterm_appl>(built)[0] == expected[9999 % 3]);
+}
@@ -12,6 +12,7 @@
 #ifndef MCRL2_CORE_BUILDER_H
 #define MCRL2_CORE_BUILDER_H
 
+#include <unordered_map>
 #include "mcrl2/atermpp/aterm_list.h"
 
 namespace mcrl2
@@ -97,6 +98,52 @@ struct builder
 };
 
 
+/**
+ * \brief Adds memoisation of the subterms of type Term to a builder. The result of
+ * apply(result, x) is computed only once for every distinct term x, which is
+ * much faster if the traversed terms have many shared subterms. The results
+ * are stored until the builder is destroyed, hence they are valid for the
+ * traversals of a single builder object.
+ *
+ * This is only correct if the result for x does not depend on the context of x,
+ * so the builder must not keep state in enter and leave, as is for example done
+ * for bound variables.
+ *
+ * Types:
+ *  \arg Builder the builder to which memoisation is added
+ *  \arg Term the type of the terms of which the results are memoised
+ *
+ **/
+template <template <class> class Builder, class Term>
+struct add_memoisation
+{
+  template <typename Derived>
+  struct builder: public Builder<Derived>
+  {
+    typedef Builder<Derived> super;
+    using super::enter;
+    using super::leave;
+    using super::apply;
+    using super::update;
+
+    /// \brief Maps the traversed terms onto their results. The terms are hashed on their address.
+    std::unordered_map<atermpp::aterm, atermpp::aterm> memo;
+
+    template <class T>
+    void apply(T& result, const Term& x)
+    {
+      auto i = memo.find(x);
+      if (i != memo.end())
+      {
+        result = atermpp::down_cast<T>(i->second);
+        return;
+      }
+      super::apply(result, x);
+      memo.emplace(x, result);
+    }
+  };
+};
+
 // apply a builder without additional template arguments
 template <template <class> class Builder>
 class apply_builder: public Builder<apply_builder<Builder> >
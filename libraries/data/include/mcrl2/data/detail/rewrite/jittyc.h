@@ -42,7 +42,8 @@ typedef std::vector < sort_expression_list> sort_list_vector;
 class normal_form_cache
 {
   private:
-    std::set<data_expression> m_lookup;
+    std::map<data_expression, std::size_t> m_lookup;
+    std::vector<const data_expression*> m_terms;
   public:
     normal_form_cache()
     { 
@@ -59,17 +60,30 @@ class normal_form_cache
   ///        that is a C++ representation of the stored normal form. This string can
   ///        be used by the generated rewriter as long as the cache object is alive,
   ///        and its clear() method has not been called.
+  /// \details The string refers to the term by its position in the cache, such that the
+  ///          generated code does not depend on the addresses of terms in the current process.
+  ///          The generated code looks up the terms in a table that is filled from terms().
   /// \param t The term to normalize.
   /// \return A C++ string that evaluates to the cached normal form of t.
   ///
   std::string insert(const data_expression& t)
   {
     std::stringstream ss;
-    const data_expression* cached_term = &*(m_lookup.insert(t).first);
-    ss << "*reinterpret_cast<const data_expression*>(" << (void*)(cached_term) << ")";
+    auto i = m_lookup.insert(std::make_pair(t, m_terms.size()));
+    if (i.second)
+    {
+      m_terms.push_back(&i.first->first);
+    }
+    ss << "(*jittyc_normal_forms[" << i.first->second << "])";
     return ss.str();
   }
 
+  /// \brief The cached terms, in the order in which they were inserted.
+  const std::vector<const data_expression*>& terms() const
+  {
+    return m_terms;
+  }
+
   /// \brief Checks whether the cache is empty.
   /// \return A boolean indicating whether the cache is empty. 
   bool empty() const
@@ -142,6 +156,20 @@ class RewriterCompilingJitty: public Rewriter
     // The following vector is to store normal forms of constants, indexed by the sequence number in a constant. 
     std::vector<data_expression> normal_forms_for_constants;
 
+    // The function symbols that are used by the generated code. The generated code refers to a function
+    // symbol by its position in this vector, and not by its address or index, such that the generated code
+    // does not depend on the current process and a compiled rewriter can be reused by other processes.
+    std::vector<function_symbol> generated_function_symbols;
+    std::map<function_symbol, std::size_t> generated_function_symbol_positions;
+    std::size_t generated_function_symbol_position(const function_symbol& f);
+    std::size_t generated_function_symbol_index(std::size_t position) const;
+
+    // The normal forms that are used by the generated code, see normal_form_cache.
+    const data_expression* generated_normal_form(std::size_t position) const
+    {
+      return m_nf_cache->terms()[position];
+    }
+
     // Standard assignment operator.
     RewriterCompilingJitty& operator=(const RewriterCompilingJitty& other)=delete;
 
@@ -189,6 +217,8 @@ class RewriterCompilingJitty: public Rewriter
     void CleanupRewriteSystem();
     void BuildRewriteSystem();
     void generate_code(const std::string& filename);
+    bool load_cached_rewriter(const std::string& cpp_file, const std::string& compile_script);
+    void store_cached_rewriter(const std::string& cpp_file, const std::string& compile_script);
     void generate_rewr_functions(std::ostream& s, const data::function_symbol& func, const data_equation_list& eqs);
     bool lift_rewrite_rule_to_right_arity(data_equation& e, const std::size_t requested_arity);
     sort_list_vector get_residual_sorts(const sort_expression& s, const std::size_t actual_arity, const std::size_t requested_arity);
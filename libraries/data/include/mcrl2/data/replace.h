@@ -304,6 +304,29 @@ T replace_free_variables(const T& x,
 }
 //--- end generated data replace code ---//
 
+/// \brief Applies the substitution sigma to the variables in x, and visits every distinct data expression only once.
+/// \details The result is the same as that of replace_variables(x, sigma), but shared data expressions are rebuilt once
+///          instead of once per occurrence.
+template <typename T, typename Substitution>
+void memoising_replace_variables(T& x,
+                                 const Substitution& sigma,
+                                 typename std::enable_if<!std::is_base_of<atermpp::aterm, T>::value>::type* = nullptr
+                                )
+{
+  core::make_update_apply_builder<core::add_memoisation<data::data_expression_builder, data::data_expression>::builder>(sigma).update(x);
+}
+
+template <typename T, typename Substitution>
+T memoising_replace_variables(const T& x,
+                              const Substitution& sigma,
+                              typename std::enable_if<std::is_base_of<atermpp::aterm, T>::value>::type* = nullptr
+                             )
+{
+  T result;
+  core::make_update_apply_builder<core::add_memoisation<data::data_expression_builder, data::data_expression>::builder>(sigma).apply(result, x);
+  return result;
+}
+
 template <typename T, typename Substitution>
 void substitute_sorts(T& x,
                       const Substitution& sigma,
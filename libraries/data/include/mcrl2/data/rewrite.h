@@ -14,6 +14,8 @@
 
 #include "mcrl2/data/builder.h"
 
+#include <unordered_map>
+
 namespace mcrl2 {
 
 namespace data {
@@ -50,6 +52,41 @@ make_rewrite_data_expressions_builder(Rewriter R)
   return rewrite_data_expressions_builder<Builder, Rewriter>(R);
 }
 
+template <template <class> class Builder, class Rewriter>
+struct memoising_rewrite_data_expressions_builder: public Builder<memoising_rewrite_data_expressions_builder<Builder, Rewriter> >
+{
+  typedef Builder<memoising_rewrite_data_expressions_builder<Builder, Rewriter> > super;
+  using super::enter;
+  using super::leave;
+  using super::apply;
+  using super::update;
+
+  Rewriter R;
+  std::unordered_map<data_expression, data_expression> cache;
+
+  memoising_rewrite_data_expressions_builder(Rewriter R_)
+    : R(R_)
+  {}
+
+  template <class T>
+  void apply(T& result, const data_expression& x)
+  {
+    auto i = cache.find(x);
+    if (i == cache.end())
+    {
+      i = cache.emplace(x, R(x)).first;
+    }
+    result = i->second;
+  }
+};
+
+template <template <class> class Builder, class Rewriter>
+memoising_rewrite_data_expressions_builder<Builder, Rewriter>
+make_memoising_rewrite_data_expressions_builder(Rewriter R)
+{
+  return memoising_rewrite_data_expressions_builder<Builder, Rewriter>(R);
+}
+
 template <template <class> class Builder, class Rewriter, class Substitution>
 struct rewrite_data_expressions_with_substitution_builder: public Builder<rewrite_data_expressions_with_substitution_builder<Builder, Rewriter, Substitution> >
 {
@@ -144,6 +181,35 @@ T rewrite(const T& x,
 }
 //--- end generated data rewrite code ---//
 
+/// \brief Rewrites all embedded expressions in an object x, and rewrites every distinct expression only once
+/// \details The result is the same as that of rewrite(x, R), but rewriting is much faster if x has many shared data
+///          expressions. The rewriter must not depend on the context in which an expression occurs.
+/// \param x an object containing expressions
+/// \param R a rewriter
+template <typename T, typename Rewriter>
+void memoising_rewrite(T& x,
+                       Rewriter R,
+                       typename std::enable_if<!std::is_base_of<atermpp::aterm, T>::value>::type* = nullptr
+                      )
+{
+  data::detail::make_memoising_rewrite_data_expressions_builder<data::data_expression_builder>(R).update(x);
+}
+
+/// \brief Rewrites all embedded expressions in an object x, and rewrites every distinct expression only once
+/// \param x an object containing expressions
+/// \param R a rewriter
+/// \return the rewrite result
+template <typename T, typename Rewriter>
+T memoising_rewrite(const T& x,
+                    Rewriter R,
+                    typename std::enable_if<std::is_base_of<atermpp::aterm, T>::value>::type* = nullptr
+                   )
+{
+  T result;
+  data::detail::make_memoising_rewrite_data_expressions_builder<data::data_expression_builder>(R).apply(result, x);
+  return result;
+}
+
 } // namespace data
 
 } // namespace mcrl2
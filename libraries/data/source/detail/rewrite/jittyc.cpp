@@ -14,6 +14,8 @@
 
 #define NAME "rewr_jittyc"
 
+#include <filesystem>
+#include <iomanip>
 #include <unistd.h>
 #include <sys/stat.h>
 #include "mcrl2/utilities/basename.h"
@@ -806,6 +808,24 @@ std::size_t RewriterCompilingJitty::binding_variable_list_index(const variable_l
   return index_for_vl;
 }
 
+// This function assigns a unique position to function symbol f and stores f
+// at this position in the vector generated_function_symbols. The generated code
+// refers to function symbols by these positions.
+std::size_t RewriterCompilingJitty::generated_function_symbol_position(const function_symbol& f)
+{
+  auto i = generated_function_symbol_positions.insert(std::make_pair(f, generated_function_symbols.size()));
+  if (i.second)
+  {
+    generated_function_symbols.push_back(f);
+  }
+  return i.first->second;
+}
+
+std::size_t RewriterCompilingJitty::generated_function_symbol_index(std::size_t position) const
+{
+  return atermpp::detail::index_traits<data::function_symbol, function_symbol_key_type, 2>::index(generated_function_symbols[position]);
+}
+
 // Put the sorts with indices between actual arity and requested arity in a vector.
 sort_list_vector RewriterCompilingJitty::get_residual_sorts(const sort_expression& s1, std::size_t actual_arity, std::size_t requested_arity)
 {
@@ -979,10 +999,11 @@ class rewr_function_spec
     const function_symbol m_fs;
     const std::size_t m_arity;
     const bool m_delayed;
+    const std::size_t m_position; // The position of m_fs in the generated function symbols of the rewriter.
 
   public:
-    rewr_function_spec(function_symbol fs, std::size_t arity, const bool delayed)
-      : m_fs(fs), m_arity(arity), m_delayed(delayed)
+    rewr_function_spec(function_symbol fs, std::size_t arity, const bool delayed, std::size_t position)
+      : m_fs(fs), m_arity(arity), m_delayed(delayed), m_position(position)
     { }
 
     bool operator<(const rewr_function_spec& other) const
@@ -1002,6 +1023,11 @@ class rewr_function_spec
       return m_arity;
     }
 
+    std::size_t position() const
+    {
+      return m_position;
+    }
+
     bool delayed() const
     {
       return m_delayed;
@@ -1019,8 +1045,7 @@ class rewr_function_spec
       {
         name << "delayed_";
       }
-      name << "rewr_" << atermpp::detail::index_traits<data::function_symbol,function_symbol_key_type, 2>::index(m_fs)
-           << "_" << m_arity;
+      name << "rewr_" << m_position << "_" << m_arity;
       return name.str();
     }
 };
@@ -1098,7 +1123,7 @@ class RewriterCompilingJitty::ImplementTree
   inline
   const std::string rewr_function_name(const function_symbol& f, std::size_t arity)
   {
-    rewr_function_spec spec(f, arity, false);
+    rewr_function_spec spec(f, arity, false, m_rewriter.generated_function_symbol_position(f));
     if (m_rewr_functions_implemented.insert(spec).second)
     {
       m_rewr_functions.push(spec);
@@ -1109,7 +1134,7 @@ class RewriterCompilingJitty::ImplementTree
   inline
   const std::string delayed_rewr_function_name(const function_symbol& f, std::size_t arity)
   {
-    rewr_function_spec spec(f, arity, true);
+    rewr_function_spec spec(f, arity, true, m_rewriter.generated_function_symbol_position(f));
     if (m_rewr_functions_implemented.insert(spec).second)
     {
       m_rewr_functions.push(spec);
@@ -1918,7 +1943,7 @@ class RewriterCompilingJitty::ImplementTree
              std::map<variable,std::string>& type_of_code_variables)
   {
     bool reset_current_data_parameters=false;
-    const void* func = (void*)(atermpp::detail::address(tree.function()));
+    const std::string func = "jittyc_function_symbols[" + std::to_string(m_rewriter.generated_function_symbol_position(tree.function())) + "]";
     m_stream << m_padding;
     brackets.bracket_nesting_level++;
     if (level == 0)
@@ -2545,9 +2570,9 @@ public:
     else
     {
       std::stringstream ss;
-      ss << "this_rewriter->normal_forms_for_constants[" 
-         << atermpp::detail::index_traits<data::function_symbol, function_symbol_key_type, 2>::index(opid) 
-         << "]";
+      ss << "this_rewriter->normal_forms_for_constants[jittyc_function_symbol_indices[" 
+         << m_rewriter.generated_function_symbol_position(opid)
+         << "]]";
       rewr_function_finish_term(m_stream, arity, ss.str(), down_cast<function_sort>(opid.sort()));
     } 
   }
@@ -2595,7 +2620,7 @@ public:
     bracket_level_data brackets;
     std::stack<std::string> auxiliary_code_fragments;
 
-    std::size_t index = atermpp::detail::index_traits<data::function_symbol, function_symbol_key_type, 2>::index(func);
+    std::size_t index = m_rewriter.generated_function_symbol_position(func);
     m_stream << m_padding << "// [" << index << "] " << func << ": " << func.sort() << "\n";
     rewr_function_signature(m_stream, index, arity, brackets);
     m_stream << m_padding << "{\n"
@@ -2646,7 +2671,7 @@ public:
 
   void generate_delayed_normal_form_generating_function(std::ostream& m_stream, const data::function_symbol& func, std::size_t arity)
   {
-    std::size_t index = atermpp::detail::index_traits<data::function_symbol, function_symbol_key_type, 2>::index(func);
+    std::size_t index = m_rewriter.generated_function_symbol_position(func);
     m_stream << m_padding << "// [" << index << "] " << func << ": " << func.sort() << "\n";
     if (arity>0)
     {
@@ -2783,6 +2808,77 @@ static std::string generate_cpp_filename(std::size_t unique)
   return filename.str();
 }
 
+///
+/// \brief jittyc_cache_directory returns the directory in which compiled rewriters are cached.
+/// \return The directory given by MCRL2_COMPILECACHE, or otherwise the directory mcrl2 in the
+///         cache directory of the user. An empty string indicates that compiled rewriters are
+///         not cached.
+///
+static std::string jittyc_cache_directory()
+{
+  const char* env_dir = std::getenv("MCRL2_COMPILECACHE");
+  if (env_dir != nullptr)
+  {
+    return env_dir;
+  }
+  const char* xdg_dir = std::getenv("XDG_CACHE_HOME");
+  if (xdg_dir != nullptr && *xdg_dir != '\0')
+  {
+    return std::string(xdg_dir) + "/mcrl2";
+  }
+  const char* home_dir = std::getenv("HOME");
+  if (home_dir != nullptr && *home_dir != '\0')
+  {
+    return std::string(home_dir) + "/.cache/mcrl2";
+  }
+  return std::string();
+}
+
+///
+/// \brief read_file returns the contents of a file, or an empty string if it cannot be read.
+///
+static std::string read_file(const std::string& filename)
+{
+  std::ifstream in(filename, std::ios::binary);
+  std::stringstream contents;
+  contents << in.rdbuf();
+  return contents.str();
+}
+
+///
+/// \brief jittyc_cache_name returns the name under which a compiled rewriter is stored in the cache.
+/// \details The name is a hash of the generated code, the toolset version and the compiler that is
+///          used, which is determined by the compile script and the CXX environment variable. As the
+///          generated code does not depend on the current process, the same name is obtained for the
+///          same rewrite system in each run.
+/// \param source The generated code.
+/// \param compile_script The script that is used to compile the generated code.
+///
+static std::string jittyc_cache_name(const std::string& source, const std::string& compile_script)
+{
+  // FNV-1a is used, as the hash must be the same in all processes.
+  std::uint64_t hash = 14695981039346656037ULL;
+  auto add = [&](const std::string& s)
+  {
+    for (unsigned char c: s)
+    {
+      hash = (hash ^ c) * 1099511628211ULL;
+    }
+    hash = (hash ^ 0xff) * 1099511628211ULL; // Separates the strings.
+  };
+
+  const char* env_cxx = std::getenv("CXX");
+  add(mcrl2::utilities::get_toolset_version());
+  add(compile_script);
+  add(read_file(compile_script));
+  add(env_cxx == nullptr ? "" : env_cxx);
+  add(source);
+
+  std::ostringstream name;
+  name << "jittyc_" << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return name.str();
+}
+
 ///
 /// \brief filter_function_symbols selects the function symbols from source for which filter
 ///        returns true, and copies them to dest.
@@ -2806,6 +2902,7 @@ void RewriterCompilingJitty::generate_code(const std::string& filename)
 {
   std::ofstream cpp_file(filename);
   std::stringstream rewr_code;
+  std::stringstream delayed_application_code;
   // arity_bound is one larger than the maximal arity. 
   arity_bound = 1+std::max(calc_max_arity(m_data_specification_for_enumeration.constructors()),
                            calc_max_arity(m_data_specification_for_enumeration.mappings()));
@@ -2816,10 +2913,9 @@ void RewriterCompilingJitty::generate_code(const std::string& filename)
   filter_function_symbols(m_data_specification_for_enumeration.mappings(), function_symbols, data_equation_selector);
 
 
-  // The rewrite functions are first stored in a separate buffer (rewrite_functions),
-  // because during the generation process, new function symbols are created. This
-  // affects the value that the macro INDEX_BOUND should have before loading
-  // jittycpreamble.h.
+  // The rewrite functions are first stored in separate buffers, because the tables
+  // with function symbols and normal forms that are declared before them are only
+  // known after the generation process.
   ImplementTree code_generator(*this, function_symbols);
 
   index_bound = atermpp::detail::index_traits<data::function_symbol, function_symbol_key_type, 2>::max_index() + 1;
@@ -2827,14 +2923,29 @@ void RewriterCompilingJitty::generate_code(const std::string& filename)
   functions_when_arguments_are_not_in_normal_form = std::vector<rewriter_function>(arity_bound * index_bound);
   functions_when_arguments_are_in_normal_form = std::vector<rewriter_function>(arity_bound * index_bound);
 
-  cpp_file << "#define INDEX_BOUND__ " << index_bound << "// These values are not used anymore.\n"
-              "#define ARITY_BOUND__ " << arity_bound << "// These values are not used anymore.\n";
+  rewr_code << "  // We're declaring static members in a struct rather than simple functions in\n"
+               "  // the global scope, so that we don't have to worry about forward declarations.\n";
+  code_generator.generate_rewr_functions(rewr_code,m_data_specification_for_enumeration);
+  rewr_code << "};\n"
+               "} // namespace\n";
+
+  code_generator.generate_delayed_application_functions(delayed_application_code);
+
+  // The generated code does not contain addresses or indices of terms, such that the same code is
+  // generated in another process for the same rewrite system, and the compiled code can be cached.
+  cpp_file << "#define ARITY_BOUND__ " << arity_bound << "// These values are not used anymore.\n";
   cpp_file << "#include \"mcrl2/data/detail/rewrite/jittycpreamble.h\"\n";
 
   cpp_file << "namespace {\n"
                "// Anonymous namespace so the compiler uses internal linkage for the generated\n"
                "// rewrite code.\n"
                "\n"
+               "// The addresses and indices of the function symbols, and the normal forms, that are\n"
+               "// used by the rewrite code. They are set when the rewriter is loaded.\n"
+               "uintptr_t jittyc_function_symbols[" << std::max<std::size_t>(1, generated_function_symbols.size()) << "];\n"
+               "std::size_t jittyc_function_symbol_indices[" << std::max<std::size_t>(1, generated_function_symbols.size()) << "];\n"
+               "const data_expression* jittyc_normal_forms[" << std::max<std::size_t>(1, m_nf_cache->terms().size()) << "];\n"
+               "\n"
                "struct rewr_functions\n"
                "{\n"
 
@@ -2866,20 +2977,22 @@ void RewriterCompilingJitty::generate_code(const std::string& filename)
                "  }\n"
                "\n";
 
-  rewr_code << "  // We're declaring static members in a struct rather than simple functions in\n"
-               "  // the global scope, so that we don't have to worry about forward declarations.\n";
-  code_generator.generate_rewr_functions(rewr_code,m_data_specification_for_enumeration);
-  rewr_code << "};\n"
-               "} // namespace\n";
-
-  code_generator.generate_delayed_application_functions(cpp_file);
+  cpp_file << delayed_application_code.str();
 
   cpp_file << rewr_code.str();
 
   cpp_file << "void set_the_precompiled_rewrite_functions_in_a_lookup_table(RewriterCompilingJitty* this_rewriter)\n"
               "{\n";
-  cpp_file << "  assert(&this_rewriter->functions_when_arguments_are_not_in_normal_form == (void *)" << &functions_when_arguments_are_not_in_normal_form << ");  // Check that this table matches the one rewriter is actually using.\n";
-  cpp_file << "  assert(&this_rewriter->functions_when_arguments_are_in_normal_form == (void *)" << &functions_when_arguments_are_in_normal_form << ");  // Check that this table matches the one rewriter is actually using.\n";
+  cpp_file << "  assert(this_rewriter->generated_function_symbols.size() == " << generated_function_symbols.size() << ");\n"
+           << "  for (std::size_t i = 0; i < this_rewriter->generated_function_symbols.size(); ++i)\n"
+           << "  {\n"
+           << "    jittyc_function_symbols[i] = uint_address(this_rewriter->generated_function_symbols[i]);\n"
+           << "    jittyc_function_symbol_indices[i] = this_rewriter->generated_function_symbol_index(i);\n"
+           << "  }\n";
+  for (std::size_t i = 0; i < m_nf_cache->terms().size(); ++i)
+  {
+    cpp_file << "  jittyc_normal_forms[" << i << "] = this_rewriter->generated_normal_form(" << i << ");\n";
+  }
   cpp_file << "  for(rewriter_function& f: this_rewriter->functions_when_arguments_are_not_in_normal_form)\n"
            << "  {\n"
            << "    f = nullptr;\n"
@@ -2889,22 +3002,32 @@ void RewriterCompilingJitty::generate_code(const std::string& filename)
            << "    f = nullptr;\n"
            << "  }\n";
 
-  // Fill tables with the rewrite functions
+  // Fill tables with the rewrite functions, in the order of the positions of the function symbols.
+  std::vector<const rewr_function_spec*> implemented_rewrs;
+  for (const rewr_function_spec& f: code_generator.implemented_rewrs())
+  {
+    implemented_rewrs.push_back(&f);
+  }
+  std::sort(implemented_rewrs.begin(), implemented_rewrs.end(), [](const rewr_function_spec* f, const rewr_function_spec* g)
+    {
+      return std::make_tuple(f->position(), f->arity(), f->delayed()) < std::make_tuple(g->position(), g->arity(), g->delayed());
+    });
   RewriterCompilingJitty::substitution_type sigma;
   normal_forms_for_constants.clear();
-  for (const rewr_function_spec& f: code_generator.implemented_rewrs())
+  for (const rewr_function_spec* p: implemented_rewrs)
   {
+    const rewr_function_spec& f = *p;
     if (!f.delayed())
     {
       std::size_t index = atermpp::detail::index_traits<data::function_symbol, function_symbol_key_type, 2>::index(f.fs());
       if (f.arity()>0)
       {
         cpp_file << "  this_rewriter->functions_when_arguments_are_not_in_normal_form[this_rewriter->arity_bound * "
-                 << index
+                 << "jittyc_function_symbol_indices[" << f.position() << "]"
                  << " + " << f.arity() << "] = rewr_functions::"
                  << f.name() << "_term;\n";
         cpp_file << "  this_rewriter->functions_when_arguments_are_in_normal_form[this_rewriter->arity_bound * "
-                 << index
+                 << "jittyc_function_symbol_indices[" << f.position() << "]"
                  << " + " << f.arity() << "] = rewr_functions::"
                  << f.name() << "_term_arg_in_normal_form;\n";
       }
@@ -2924,6 +3047,76 @@ void RewriterCompilingJitty::generate_code(const std::string& filename)
   cpp_file.close();
 }
 
+bool RewriterCompilingJitty::load_cached_rewriter(const std::string& cpp_file, const std::string& compile_script)
+{
+  const std::string directory = jittyc_cache_directory();
+  if (directory.empty())
+  {
+    return false;
+  }
+
+  // The source in the cache is compared as well, such that a collision of the hash cannot lead to a wrong rewriter.
+  const std::string source = read_file(cpp_file);
+  const std::string cached = directory + "/" + jittyc_cache_name(source, compile_script);
+  std::error_code ec;
+  if (!std::filesystem::exists(cached + ".so", ec) || read_file(cached + ".cpp") != source)
+  {
+    mCRL2log(verbose) << "no compiled rewriter found in the cache " << directory << "." << std::endl;
+    return false;
+  }
+
+  // The library is copied, as a process loads a library at most once, while the tables of the generated
+  // code belong to a single rewriter.
+  const std::string library = cpp_file.substr(0, cpp_file.rfind('.')) + ".so";
+  std::filesystem::copy_file(cached + ".so", library, std::filesystem::copy_options::overwrite_existing, ec);
+  if (ec)
+  {
+    mCRL2log(warning) << "Could not copy the compiled rewriter " << cached << ".so: " << ec.message() << std::endl;
+    return false;
+  }
+  rewriter_so->use_precompiled(cpp_file, library);
+  mCRL2log(verbose) << "using compiled rewriter " << cached << ".so from the cache." << std::endl;
+  return true;
+}
+
+void RewriterCompilingJitty::store_cached_rewriter(const std::string& cpp_file, const std::string& compile_script)
+{
+  const std::string directory = jittyc_cache_directory();
+  if (directory.empty())
+  {
+    return;
+  }
+
+  const std::string cached = directory + "/" + jittyc_cache_name(read_file(cpp_file), compile_script);
+  const std::string unique = "." + std::to_string(getpid()) + "_" + std::to_string(reinterpret_cast<std::size_t>(this)) + ".tmp";
+  std::error_code ec;
+  std::filesystem::create_directories(directory, ec);
+
+  // The files are copied under a unique name and then renamed, which is atomic, such that tools that start at the
+  // same time never load a partially written library. The source is stored first, as a library is only used if
+  // its source is present.
+  for (const auto& [from, to]: { std::make_pair(cpp_file, cached + ".cpp"), std::make_pair(rewriter_so->filename(), cached + ".so") })
+  {
+    if (!ec)
+    {
+      std::filesystem::copy_file(from, to + unique, std::filesystem::copy_options::overwrite_existing, ec);
+    }
+    if (!ec)
+    {
+      std::filesystem::rename(to + unique, to, ec);
+    }
+  }
+  if (ec)
+  {
+    std::error_code ignored;
+    std::filesystem::remove(cached + ".cpp" + unique, ignored);
+    std::filesystem::remove(cached + ".so" + unique, ignored);
+    mCRL2log(warning) << "Could not store the compiled rewriter in the cache " << directory << ": " << ec.message() << std::endl;
+    return;
+  }
+  mCRL2log(verbose) << "stored compiled rewriter " << cached << ".so in the cache." << std::endl;
+}
+
 void RewriterCompilingJitty::BuildRewriteSystem()
 {
   CleanupRewriteSystem();
@@ -2969,17 +3162,21 @@ void RewriterCompilingJitty::BuildRewriteSystem()
   mCRL2log(verbose) << "generated " << cpp_file << " in " << time.time() << "ms, compiling..." << std::endl;
   time.reset();
 
-  try
+  if (!load_cached_rewriter(cpp_file, compile_script))
   {
-    rewriter_so->compile(cpp_file);
-  }
-  catch(std::runtime_error& e)
-  {
-    rewriter_so->leave_files();
-    throw mcrl2::runtime_error(std::string("Could not compile rewriter: ") + e.what());
-  }
+    try
+    {
+      rewriter_so->compile(cpp_file);
+    }
+    catch(std::runtime_error& e)
+    {
+      rewriter_so->leave_files();
+      throw mcrl2::runtime_error(std::string("Could not compile rewriter: ") + e.what());
+    }
 
-  mCRL2log(verbose) << "compiled in " << time.time() << "ms, loading rewriter..." << std::endl;
+    mCRL2log(verbose) << "compiled in " << time.time() << "ms, loading rewriter..." << std::endl;
+    store_cached_rewriter(cpp_file, compile_script);
+  }
 
   bool (*init)(rewriter_interface*, RewriterCompilingJitty* this_rewriter);
   rewriter_interface interface = { mcrl2::utilities::get_toolset_version(), "Unknown error when loading rewriter.", this, nullptr, nullptr };
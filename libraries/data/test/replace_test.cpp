@@ -149,6 +149,13 @@ BOOST_AUTO_TEST_CASE(test_variable_replace)
   BOOST_CHECK(t1 == replace_variables(t, make_sequence_sequence_substitution(variables, replacements)));
   BOOST_CHECK(t1 == replace_variables(t, make_sequence_sequence_substitution(v, l)));
   BOOST_CHECK(t1 == replace_variables(t, make_mutable_map_substitution(variables, replacements)));
+  BOOST_CHECK(t1 == memoising_replace_variables(t, make_sequence_sequence_substitution(variables, replacements)));
+
+  std::vector<data::data_expression> w{t, not_(t), t};
+  data::memoising_replace_variables(w, make_mutable_map_substitution(variables, replacements));
+  BOOST_CHECK(w[0] == t1);
+  BOOST_CHECK(w[1] == not_(t1));
+  BOOST_CHECK(w[2] == t1);
 }
 
 BOOST_AUTO_TEST_CASE(test_replace_with_binders)
@@ -0,0 +1,366 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/detail/external_sort.h
+/// \brief Files of fixed-width records of 64-bit words, and sorting them in external memory.
+
+#ifndef MCRL2_LPS_DETAIL_EXTERNAL_SORT_H
+#define MCRL2_LPS_DETAIL_EXTERNAL_SORT_H
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <queue>
+#include <vector>
+#include "mcrl2/utilities/exception.h"
+
+namespace mcrl2::lps::detail {
+
+typedef std::uint64_t record_word;
+
+/// \brief Compares the first key_width words of two records lexicographically.
+inline
+bool record_less(const record_word* x, const record_word* y, std::size_t key_width)
+{
+  return std::lexicographical_compare(x, x + key_width, y, y + key_width);
+}
+
+/// \brief A temporary file of records that consist of a fixed number of words. The file is
+///        removed when this object is destroyed.
+class record_file
+{
+  protected:
+    std::filesystem::path m_path;
+    std::size_t m_width;
+    std::size_t m_size = 0;
+    std::size_t m_flushed_size = 0;
+    std::ofstream m_out;
+    std::vector<record_word> m_buffer;
+
+    static constexpr std::size_t buffer_words = 1 << 16;
+
+    static std::filesystem::path make_path(const std::filesystem::path& directory)
+    {
+      static std::atomic<std::size_t> counter{0};
+      std::string name = "mcrl2_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count())
+                         + "_" + std::to_string(counter++) + ".records";
+      return (directory.empty() ? std::filesystem::temp_directory_path() : directory) / name;
+    }
+
+    void flush_buffer()
+    {
+      m_out.write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size() * sizeof(record_word)));
+      if (m_out.fail())
+      {
+        throw mcrl2::runtime_error("Could not write to the temporary file " + m_path.string() + ".");
+      }
+      m_buffer.clear();
+    }
+
+  public:
+    /// \brief Creates an empty file in the given directory, or in the default temporary directory if it is empty.
+    record_file(const std::filesystem::path& directory, std::size_t width)
+      : m_path(make_path(directory)),
+        m_width(width)
+    {
+      m_out.open(m_path, std::ios::binary | std::ios::trunc);
+      if (m_out.fail())
+      {
+        throw mcrl2::runtime_error("Could not create the temporary file " + m_path.string() + ".");
+      }
+      m_buffer.reserve(buffer_words + width);
+    }
+
+    record_file(const record_file&) = delete;
+    record_file& operator=(const record_file&) = delete;
+
+    ~record_file()
+    {
+      m_out.close();
+      std::error_code ec;
+      std::filesystem::remove(m_path, ec);
+    }
+
+    const std::filesystem::path& path() const
+    {
+      return m_path;
+    }
+
+    std::size_t width() const
+    {
+      return m_width;
+    }
+
+    /// \brief The number of records in the file.
+    std::size_t size() const
+    {
+      return m_size;
+    }
+
+    /// \brief The number of records that can be read, i.e., that were appended before the last flush.
+    std::size_t flushed_size() const
+    {
+      return m_flushed_size;
+    }
+
+    void append(const record_word* r)
+    {
+      m_buffer.insert(m_buffer.end(), r, r + m_width);
+      ++m_size;
+      if (m_buffer.size() >= buffer_words)
+      {
+        flush_buffer();
+      }
+    }
+
+    /// \brief Writes all appended records to disk, such that they can be read.
+    void flush()
+    {
+      flush_buffer();
+      m_out.flush();
+      m_flushed_size = m_size;
+    }
+};
+
+/// \brief Reads the records of a record_file, either sequentially or at a given position.
+class record_reader
+{
+  protected:
+    const record_file& m_file;
+    std::ifstream m_in;
+    std::vector<record_word> m_buffer;
+    std::size_t m_position = 0; // The index in the file of the first record in the buffer.
+    std::size_t m_current = 0;  // The index in the buffer of the current record.
+    std::size_t m_available = 0; // The number of records in the buffer.
+
+    static constexpr std::size_t buffer_records = 1 << 12;
+
+    void fill(std::size_t position)
+    {
+      m_position = position;
+      m_current = 0;
+      m_available = std::min(buffer_records, m_file.flushed_size() - std::min(position, m_file.flushed_size()));
+      if (m_available > 0)
+      {
+        m_in.clear();
+        m_in.seekg(static_cast<std::streamoff>(position * m_file.width() * sizeof(record_word)));
+        m_in.read(reinterpret_cast<char*>(m_buffer.data()), static_cast<std::streamsize>(m_available * m_file.width() * sizeof(record_word)));
+        if (m_in.fail())
+        {
+          throw mcrl2::runtime_error("Could not read from the temporary file " + m_file.path().string() + ".");
+        }
+      }
+    }
+
+  public:
+    /// \brief Constructor. The records that are appended to the file after the last flush are not read.
+    explicit record_reader(const record_file& file, std::size_t position = 0)
+      : m_file(file),
+        m_in(file.path(), std::ios::binary),
+        m_buffer(buffer_records * file.width())
+    {
+      if (m_in.fail())
+      {
+        throw mcrl2::runtime_error("Could not open the temporary file " + file.path().string() + ".");
+      }
+      fill(position);
+    }
+
+    /// \brief Returns true if the current position is past the last record.
+    bool at_end() const
+    {
+      return m_current >= m_available;
+    }
+
+    /// \brief The index in the file of the current record.
+    std::size_t position() const
+    {
+      return m_position + m_current;
+    }
+
+    /// \brief The current record.
+    const record_word* current() const
+    {
+      assert(!at_end());
+      return m_buffer.data() + m_current * m_file.width();
+    }
+
+    void next()
+    {
+      ++m_current;
+      if (m_current == m_available && m_available == buffer_records)
+      {
+        fill(m_position + m_available);
+      }
+    }
+
+    /// \brief Returns the record with the given index. Reading consecutive records is efficient.
+    const record_word* operator[](std::size_t index)
+    {
+      if (index < m_position || index >= m_position + m_available)
+      {
+        fill(index);
+      }
+      m_current = index - m_position;
+      return current();
+    }
+};
+
+/// \brief Sorts records of a fixed width on their first key_width words, using at most a given
+///        amount of memory. Records that do not fit in memory are written to disk in sorted runs,
+///        which are merged when the records are read back.
+class external_sorter
+{
+  protected:
+    std::filesystem::path m_directory;
+    std::size_t m_width;
+    std::size_t m_key_width;
+    std::size_t m_capacity; // The maximum number of records in memory.
+    std::vector<record_word> m_buffer;
+    std::vector<std::unique_ptr<record_file>> m_runs;
+
+    // The state while reading the sorted records.
+    std::vector<std::size_t> m_order;
+    std::size_t m_next = 0;
+    std::vector<std::unique_ptr<record_reader>> m_readers;
+
+    struct reader_greater
+    {
+      std::size_t key_width;
+
+      bool operator()(const record_reader* x, const record_reader* y) const
+      {
+        return record_less(y->current(), x->current(), key_width);
+      }
+    };
+    std::priority_queue<record_reader*, std::vector<record_reader*>, reader_greater> m_queue;
+    record_reader* m_last = nullptr; // The reader of the record that was returned last.
+
+    // Sorts the records in the buffer, and stores the result in m_order.
+    void sort_buffer()
+    {
+      m_order.resize(m_buffer.size() / m_width);
+      std::iota(m_order.begin(), m_order.end(), 0);
+      std::sort(m_order.begin(), m_order.end(), [&](std::size_t i, std::size_t j)
+        {
+          return record_less(m_buffer.data() + i * m_width, m_buffer.data() + j * m_width, m_key_width);
+        }
+      );
+    }
+
+    void spill()
+    {
+      sort_buffer();
+      m_runs.push_back(std::make_unique<record_file>(m_directory, m_width));
+      for (std::size_t i: m_order)
+      {
+        m_runs.back()->append(m_buffer.data() + i * m_width);
+      }
+      m_runs.back()->flush();
+      m_buffer.clear();
+      m_order.clear();
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param directory The directory for the runs on disk.
+    /// \param width The number of words of a record.
+    /// \param key_width The number of words at the start of a record on which the records are sorted.
+    /// \param memory_budget The number of bytes that the records in memory may occupy.
+    external_sorter(const std::filesystem::path& directory, std::size_t width, std::size_t key_width, std::size_t memory_budget)
+      : m_directory(directory),
+        m_width(width),
+        m_key_width(key_width),
+        m_capacity(std::max<std::size_t>(1, memory_budget / ((width + 1) * sizeof(record_word)))),
+        m_queue(reader_greater{key_width})
+    {
+      assert(key_width <= width);
+    }
+
+    std::size_t width() const
+    {
+      return m_width;
+    }
+
+    void push(const record_word* r)
+    {
+      m_buffer.insert(m_buffer.end(), r, r + m_width);
+      if (m_buffer.size() >= m_capacity * m_width)
+      {
+        spill();
+      }
+    }
+
+    /// \brief Ends pushing records, and prepares for reading them in sorted order.
+    void sort()
+    {
+      if (m_runs.empty())
+      {
+        sort_buffer();
+        m_next = 0;
+        return;
+      }
+      if (!m_buffer.empty())
+      {
+        spill();
+      }
+      for (const std::unique_ptr<record_file>& run: m_runs)
+      {
+        m_readers.push_back(std::make_unique<record_reader>(*run));
+        m_queue.push(m_readers.back().get());
+      }
+    }
+
+    /// \brief Returns the next record in sorted order, or nullptr if all records have been read.
+    ///        The returned record remains valid until the next call.
+    const record_word* next()
+    {
+      if (m_runs.empty())
+      {
+        return m_next < m_order.size() ? m_buffer.data() + m_order[m_next++] * m_width : nullptr;
+      }
+      if (m_last != nullptr)
+      {
+        m_last->next();
+        if (!m_last->at_end())
+        {
+          m_queue.push(m_last);
+        }
+        m_last = nullptr;
+      }
+      if (m_queue.empty())
+      {
+        return nullptr;
+      }
+      m_last = m_queue.top();
+      m_queue.pop();
+      return m_last->current();
+    }
+
+    /// \brief Removes all records, and prepares for pushing records again.
+    void clear()
+    {
+      m_buffer.clear();
+      m_order.clear();
+      m_next = 0;
+      m_queue = std::priority_queue<record_reader*, std::vector<record_reader*>, reader_greater>(reader_greater{m_key_width});
+      m_last = nullptr;
+      m_readers.clear();
+      m_runs.clear();
+    }
+};
+
+} // namespace mcrl2::lps::detail
+
+#endif // MCRL2_LPS_DETAIL_EXTERNAL_SORT_H
@@ -0,0 +1,61 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/detail/read_write_parameters.h
+/// \brief Syntactic analysis of the process parameters that are read and written by a summand.
+
+#ifndef MCRL2_LPS_DETAIL_READ_WRITE_PARAMETERS_H
+#define MCRL2_LPS_DETAIL_READ_WRITE_PARAMETERS_H
+
+#include <map>
+#include <set>
+#include "mcrl2/lps/action_summand.h"
+#include "mcrl2/lps/find.h"
+#include "mcrl2/utilities/detail/container_utility.h"
+
+namespace mcrl2::lps::detail {
+
+/// \brief Computes the read and written process parameters for the given summand
+inline
+std::pair<std::set<data::variable>, std::set<data::variable>> read_write_parameters(const lps::action_summand& summand, const std::set<data::variable>& process_parameters)
+{
+  using utilities::detail::set_union;
+  using utilities::detail::set_intersection;
+
+  // TODO: multi-action free variables are only necessary when actions are rewritten.
+  std::set<data::variable> read_parameters = set_union(data::find_free_variables(summand.condition()), lps::find_free_variables(summand.multi_action()));
+  std::set<data::variable> write_parameters;
+
+  for (const auto& assignment: summand.assignments())
+  {
+    if (assignment.lhs() != assignment.rhs())
+    {
+      write_parameters.insert(assignment.lhs());
+      data::find_free_variables(assignment.rhs(), std::inserter(read_parameters, read_parameters.end()));
+    }
+  }
+
+  return { set_intersection(read_parameters, process_parameters), set_intersection(write_parameters, process_parameters) };
+}
+
+/// \brief Assigns a unique index to every parameter of the process.
+inline
+std::map<data::variable, std::size_t> process_parameter_index(const data::variable_list& process_parameters)
+{
+  std::map<data::variable, std::size_t> result;
+  std::size_t i = 0;
+  for (const data::variable& v: process_parameters)
+  {
+    result[v] = i++;
+  }
+  return result;
+}
+
+} // namespace mcrl2::lps::detail
+
+#endif // MCRL2_LPS_DETAIL_READ_WRITE_PARAMETERS_H
@@ -12,11 +12,14 @@
 #ifndef MCRL2_LPS_EXPLORER_H
 #define MCRL2_LPS_EXPLORER_H
 
+#include <optional>
 #include <random>
 #include <thread>
+#include <tuple>
 #include <type_traits>
 #include "mcrl2/utilities/detail/io.h"
 #include "mcrl2/utilities/skip.h"
+#include "mcrl2/atermpp/aterm_io.h"
 #include "mcrl2/atermpp/standard_containers/deque.h"
 #include "mcrl2/atermpp/standard_containers/vector.h"
 #include "mcrl2/atermpp/standard_containers/indexed_set.h"
@@ -31,7 +34,10 @@
 #include "mcrl2/lps/order_summand_variables.h"
 #include "mcrl2/lps/replace_constants_by_variables.h"
 #include "mcrl2/lps/resolve_name_clashes.h"
+#include "mcrl2/lps/state_indexed_set.h"
 #include "mcrl2/lps/stochastic_state.h"
+#include "mcrl2/lps/stubborn_sets.h"
+#include "mcrl2/lps/summand_cache.h"
 
 namespace mcrl2::lps {
 
@@ -87,6 +93,13 @@ class todo_set
       todo.push_back(s);
     }
 
+    /// \brief Removes an element that is handed over to another thread.
+    /// \details By default the element that would be chosen next is taken.
+    virtual void steal_element(state& result)
+    {
+      choose_element(result);
+    }
+
     virtual void finish_state()
     { }
 
@@ -99,6 +112,12 @@ class todo_set
     {
       return todo.size();
     }
+
+    /// \brief Returns the states in this set, in the order in which they are stored.
+    virtual std::vector<state> elements() const
+    {
+      return std::vector<state>(todo.begin(), todo.end());
+    }
 };
 
 class breadth_first_todo_set : public todo_set
@@ -157,6 +176,14 @@ class depth_first_todo_set : public todo_set
       todo.pop_back();
     }
 
+    // States are stolen at the bottom of the stack. These are the oldest states, which
+    // typically have the largest unexplored subtrees.
+    void steal_element(state& result) override
+    {
+      result = todo.front();
+      todo.pop_front();
+    }
+
     void insert(const state& s) override
     {
       todo.push_back(s);
@@ -237,6 +264,180 @@ class highway_todo_set : public todo_set
     void finish_state() override
     {
     }
+
+    std::vector<state> elements() const override
+    {
+      std::vector<state> result(todo.begin(), todo.end());
+      std::vector<state> new_elements = new_states.elements();
+      result.insert(result.end(), new_elements.begin(), new_elements.end());
+      return result;
+    }
+};
+
+/// \brief A collection of todo sets, one for each thread.
+/// \details Each thread takes states from and inserts states into its own todo set, which is
+///          protected by a mutex of its own. A thread whose todo set is empty steals half of
+///          the states of the largest todo set of another thread. Termination is detected using
+///          an atomic counter of states that are either in a todo set or are being explored,
+///          such that no global lock is needed.
+class work_stealing_todo_set
+{
+  protected:
+    struct alignas(64) thread_todo
+    {
+      std::mutex mutex;
+      std::unique_ptr<todo_set> todo;
+      std::atomic<std::size_t> size = 0; // Approximation of todo->size() that can be read without locking.
+    };
+
+    std::vector<thread_todo> m_todos;
+    std::atomic<std::size_t> m_pending = 0;
+    const bool m_thread_safe;
+
+    void lock(thread_todo& t)
+    {
+      if (m_thread_safe) t.mutex.lock();
+    }
+
+    void unlock(thread_todo& t)
+    {
+      if (m_thread_safe) t.mutex.unlock();
+    }
+
+    // Moves half of the states of the largest todo set of another thread to the todo set of thread_index.
+    bool steal(std::size_t thread_index)
+    {
+      std::size_t victim = thread_index;
+      std::size_t victim_size = 0;
+      for (std::size_t i = 0; i < m_todos.size(); ++i)
+      {
+        std::size_t size = m_todos[i].size.load(std::memory_order_relaxed);
+        if (i != thread_index && size > victim_size)
+        {
+          victim = i;
+          victim_size = size;
+        }
+      }
+      if (victim == thread_index)
+      {
+        return false;
+      }
+
+      std::vector<state> stolen;
+      thread_todo& v = m_todos[victim];
+      lock(v);
+      std::size_t n = (v.todo->size() + 1) / 2;
+      stolen.reserve(n);
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        stolen.emplace_back();
+        v.todo->steal_element(stolen.back());
+      }
+      v.size.store(v.todo->size(), std::memory_order_relaxed);
+      unlock(v);
+
+      if (stolen.empty())
+      {
+        return false;
+      }
+
+      thread_todo& t = m_todos[thread_index];
+      lock(t);
+      std::size_t size_before = t.todo->size();
+      for (const state& s: stolen)
+      {
+        t.todo->insert(s);
+      }
+      // A todo set may discard states on insertion, as is done by highway search.
+      m_pending -= stolen.size() - (t.todo->size() - size_before);
+      t.size.store(t.todo->size(), std::memory_order_relaxed);
+      unlock(t);
+      return true;
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param todos The todo sets of the threads, where todos[i] belongs to the thread with index i.
+    explicit work_stealing_todo_set(std::vector<std::unique_ptr<todo_set>>&& todos)
+      : m_todos(todos.size()),
+        m_thread_safe(todos.size() > 1)
+    {
+      for (std::size_t i = 0; i < todos.size(); ++i)
+      {
+        m_todos[i].size = todos[i]->size();
+        m_pending += todos[i]->size();
+        m_todos[i].todo = std::move(todos[i]);
+      }
+    }
+
+    /// \brief Chooses an element of the todo set of thread_index. If that set is empty, states
+    ///        are stolen from another thread first.
+    /// \return False if no state could be obtained.
+    bool choose_element(std::size_t thread_index, state& result)
+    {
+      thread_todo& t = m_todos[thread_index];
+      do
+      {
+        lock(t);
+        if (!t.todo->empty())
+        {
+          t.todo->choose_element(result);
+          t.size.store(t.todo->size(), std::memory_order_relaxed);
+          unlock(t);
+          return true;
+        }
+        unlock(t);
+      }
+      while (m_thread_safe && steal(thread_index));
+      return false;
+    }
+
+    void insert(std::size_t thread_index, const state& s)
+    {
+      thread_todo& t = m_todos[thread_index];
+      lock(t);
+      std::size_t size_before = t.todo->size();
+      t.todo->insert(s);
+      m_pending += t.todo->size() - size_before;
+      t.size.store(t.todo->size(), std::memory_order_relaxed);
+      unlock(t);
+    }
+
+    /// \brief Indicates that thread_index has explored the state that it has chosen last.
+    void finish_state(std::size_t thread_index)
+    {
+      thread_todo& t = m_todos[thread_index];
+      lock(t);
+      t.todo->finish_state();
+      unlock(t);
+      m_pending--;
+    }
+
+    /// \brief Returns true if all todo sets are empty, and no thread is exploring a state.
+    bool finished() const
+    {
+      return m_pending == 0;
+    }
+
+    /// \brief Returns the size of the todo set of thread_index.
+    std::size_t size(std::size_t thread_index) const
+    {
+      return m_todos[thread_index].size.load(std::memory_order_relaxed);
+    }
+
+    /// \brief Returns the states in the todo sets of all threads.
+    std::vector<state> elements()
+    {
+      std::vector<state> result;
+      for (thread_todo& t: m_todos)
+      {
+        lock(t);
+        std::vector<state> states = t.todo->elements();
+        unlock(t);
+        result.insert(result.end(), states.begin(), states.end());
+      }
+      return result;
+    }
 };
 
 template <typename Summand>
@@ -265,85 +466,6 @@ const stochastic_distribution& initial_distribution(const lps::stochastic_specif
   return lpsspec.initial_process().distribution();
 }
 
-namespace detail
-{
-// The functions below are used to support the key type in caches. 
-//
-struct cheap_cache_key
-{
-  data::mutable_indexed_substitution<>& m_sigma;
-  const std::vector<data::variable>& m_gamma;
-
-  cheap_cache_key(data::mutable_indexed_substitution<>& sigma, const std::vector<data::variable>& gamma)
-    : m_sigma(sigma),
-      m_gamma(gamma)
-  {}
-  
-};
-
-struct cache_equality
-{
-  bool operator()(const atermpp::term_appl<data::data_expression>& key1, const atermpp::term_appl<data::data_expression>& key2) const
-  {
-    return key1==key2;
-  }
-
-  bool operator()(const atermpp::term_appl<data::data_expression>& key1, const cheap_cache_key& key2) const
-  {
-    std::vector<data::variable>::const_iterator i=key2.m_gamma.begin();
-    for(const data::data_expression& d: key1)
-    {
-      if (d!=key2.m_sigma(*i))
-      {
-        return false;
-      }
-      ++i;
-    }
-    return true;
-  }
-};
-
-struct cache_hash
-{
-  std::size_t operator()(const std::pair<const atermpp::term_appl<mcrl2::data::data_expression>, 
-                                         std::list<atermpp::term_list<mcrl2::data::data_expression>>>& pair) const
-  {
-    return operator()(pair.first);
-  }
-
-  std::size_t operator()(const atermpp::term_appl<data::data_expression>& key) const
-  {
-    std::size_t hash=0;
-    for(const data::data_expression& d: key)
-    {
-      hash=atermpp::detail::combine(hash,d);
-    }
-    return hash;
-  }
-
-  std::size_t operator()(const cheap_cache_key& key) const
-  {
-    std::size_t hash=0;
-    for(const data::variable& v: key.m_gamma)
-    {
-      hash=atermpp::detail::combine(hash,key.m_sigma(v));
-    }
-    return hash;
-  }
-};
-
-} // end namespace detail
-
-
-typedef atermpp::utilities::unordered_map<atermpp::term_appl<data::data_expression>,
-                                          atermpp::term_list<data::data_expression_list>,
-                                          detail::cache_hash,
-                                          detail::cache_equality,
-                                          std::allocator< std::pair<atermpp::term_appl<data::data_expression>, atermpp::term_list<data::data_expression_list>> >,
-                                          true  // Thread_safe.
-                                        > summand_cache_map;
-
-
 struct explorer_summand
 {
   data::variable_list variables;
@@ -357,17 +479,21 @@ struct explorer_summand
   caching cache_strategy;
   std::vector<data::variable> gamma;
   atermpp::function_symbol f_gamma;
-  mutable summand_cache_map local_cache;
+  mutable summand_cache local_cache;
 
+  /// \param cache_budget The number of bytes that the local cache may use, or 0 if the size is unbounded.
+  /// \param cache_shards The number of shards of the local cache.
   template <typename ActionSummand>
-  explorer_summand(const ActionSummand& summand, std::size_t summand_index, const data::variable_list& process_parameters, caching cache_strategy_)
+  explorer_summand(const ActionSummand& summand, std::size_t summand_index, const data::variable_list& process_parameters, caching cache_strategy_,
+                   std::size_t cache_budget = 0, std::size_t cache_shards = 1)
     : variables(summand.summation_variables()),
       condition(summand.condition()),
       multi_action(summand.multi_action()),
       distribution(summand_distribution(summand)),
       next_state(make_data_expression_vector(summand.next_state(process_parameters))),
       index(summand_index),
-      cache_strategy(cache_strategy_)
+      cache_strategy(cache_strategy_),
+      local_cache(cache_strategy_ == caching::local ? cache_budget : 0, cache_strategy_ == caching::local ? cache_shards : 1)
   {
     gamma = free_variables(summand.condition(), process_parameters);
     if (cache_strategy_ == caching::global)
@@ -451,7 +577,7 @@ class explorer: public abortable
     static constexpr bool is_stochastic = Stochastic;
     static constexpr bool is_timed = Timed;
 
-    typedef atermpp::indexed_set<state, atermpp::detail::GlobalThreadSafe> indexed_set_for_states_type;
+    typedef state_indexed_set indexed_set_for_states_type;
 
   protected:
     using enumerator_element = data::enumerator_list_element_with_substitution<>;
@@ -475,8 +601,6 @@ class explorer: public abortable
     data::enumerator_identifier_generator m_global_id_generator;
 
     Specification m_global_lpsspec;
-    // Mutexes
-    std::mutex m_exclusive_state_access;
 
     std::vector<data::variable> m_process_parameters;
     std::size_t m_n; // m_n = m_process_parameters.size()
@@ -486,13 +610,24 @@ class explorer: public abortable
     std::vector<explorer_summand> m_regular_summands;
     std::vector<explorer_summand> m_confluent_summands;
 
+    // Computes the stubborn sets if partial order reduction is enabled.
+    std::optional<stubborn_sets> m_stubborn_sets;
+
     volatile bool m_must_abort = false;
 
     // N.B. The keys are stored in term_appl instead of data_expression_list for performance reasons.
-    summand_cache_map global_cache;
+    summand_cache global_cache;
 
     indexed_set_for_states_type m_discovered;
 
+    // The todo set of the exploration that is in progress, which is written to a checkpoint.
+    work_stealing_todo_set* m_todo = nullptr;
+
+    // The todo set that is read from a checkpoint. If m_resume is true, the next exploration starts from
+    // this todo set and the discovered states of the checkpoint, instead of from the initial state.
+    std::vector<state> m_resume_todo;
+    bool m_resume = false;
+
     // used by make_timed_state, to avoid needless creation of vectors
     mutable std::vector<data::data_expression> timed_state;
 
@@ -755,11 +890,10 @@ class explorer: public abortable
       else
       {
         auto& cache = summand.cache_strategy == caching::global ? global_cache : summand.local_cache;
-        summand_cache_map::iterator q = cache.find(detail::cheap_cache_key(sigma, summand.gamma));
-        if (q == cache.end())
+        atermpp::term_list<data::data_expression_list> solutions;
+        if (!cache.find(detail::cheap_cache_key(sigma, summand.gamma, summand.cache_strategy == caching::global ? &summand.condition : nullptr), solutions))
         {
           rewr(condition, summand.condition, sigma);
-          atermpp::term_list<data::data_expression_list> solutions;
           if (!data::is_false(condition))
           {
             enumerator.enumerate<enumerator_element>(
@@ -775,10 +909,10 @@ class explorer: public abortable
                       );
           }
           summand.compute_key(key, sigma);
-          q = cache.insert({key, solutions}).first;
+          cache.insert(key, solutions);
         }
 
-        for (const data::data_expression_list& e: static_cast<atermpp::term_list<data::data_expression_list>&>(q->second))
+        for (const data::data_expression_list& e: solutions)
         {
           data::add_assignments(sigma, summand.variables, e);
           variables_are_assigned_to_sigma=true;
@@ -975,13 +1109,26 @@ class explorer: public abortable
       return false;
     }
 
+    // Returns the number of shards of the caches, such that threads rarely wait for each other.
+    std::size_t cache_shards() const
+    {
+      return m_options.number_of_threads > 1 ? 4 * m_options.number_of_threads : 1;
+    }
+
   public:
     explorer(const Specification& lpsspec, const explorer_options& options_)
       : m_options(options_),
         m_global_rewr(construct_rewriter(lpsspec, m_options.remove_unused_rewrite_rules)),
         m_global_enumerator(m_global_rewr, lpsspec.data(), m_global_rewr, m_global_id_generator, false),
         m_global_lpsspec(preprocess(lpsspec)),
-        m_discovered(m_options.number_of_threads)
+        global_cache(m_options.cached && m_options.global_cache ? m_options.cache_size * 1024 * 1024 : 0, cache_shards()),
+        m_discovered(m_options.number_of_threads,
+                     m_options.state_storage,
+                     m_global_lpsspec.process().process_parameters().size() + (Timed ? 1 : 0),
+                     m_options.fingerprint_bits,
+                     m_options.bitstate_bits,
+                     m_options.bitstate_hash_functions,
+                     m_options.disk_directory)
     {
       const data::variable_list& params = m_global_lpsspec.process().process_parameters();
       m_process_parameters = std::vector<data::variable>(params.begin(), params.end());
@@ -992,19 +1139,42 @@ class explorer: public abortable
 
       // Split the summands in regular and confluent summands
       const auto& lpsspec_summands = m_global_lpsspec.process().action_summands();
+      // The memory budget of the caches is divided evenly over the local caches of the summands.
+      std::size_t local_cache_budget = m_options.cache_size * 1024 * 1024 / std::max<std::size_t>(1, lpsspec_summands.size());
+      if (m_options.cache_size > 0 && local_cache_budget == 0)
+      {
+        local_cache_budget = 1;
+      }
       for (std::size_t i = 0; i < lpsspec_summands.size(); i++)
       {
         const auto& summand = lpsspec_summands[i];
         auto cache_strategy = m_options.cached ? (m_options.global_cache ? lps::caching::global : lps::caching::local) : lps::caching::none;
         if (is_confluent_tau(summand.multi_action()))
         {
-          m_confluent_summands.emplace_back(summand, i, m_global_lpsspec.process().process_parameters(), cache_strategy);
+          m_confluent_summands.emplace_back(summand, i, m_global_lpsspec.process().process_parameters(), cache_strategy, local_cache_budget, cache_shards());
         }
         else
         {
-          m_regular_summands.emplace_back(summand, i, m_global_lpsspec.process().process_parameters(), cache_strategy);
+          m_regular_summands.emplace_back(summand, i, m_global_lpsspec.process().process_parameters(), cache_strategy, local_cache_budget, cache_shards());
         }
       }
+
+      if (m_options.partial_order_reduction != lps::partial_order_reduction::none)
+      {
+        if (Stochastic || Timed)
+        {
+          throw mcrl2::runtime_error("Partial order reduction is not supported for stochastic or timed specifications.");
+        }
+        if (!m_confluent_summands.empty())
+        {
+          throw mcrl2::runtime_error("Partial order reduction cannot be combined with confluence reduction.");
+        }
+        if (m_options.state_storage == lps::state_storage::disk)
+        {
+          throw mcrl2::runtime_error("Partial order reduction is not supported for the state storage disk.");
+        }
+        m_stubborn_sets.emplace(m_global_lpsspec.process().process_parameters(), lpsspec_summands, m_options.partial_order_reduction, m_options.actions_internal_for_divergencies);
+      }
     }
 
     ~explorer() = default;
@@ -1044,10 +1214,8 @@ class explorer: public abortable
       typename DiscoverInitialState = utilities::skip
     >
     void generate_state_space_thread(
-      std::unique_ptr<todo_set>& todo,
+      work_stealing_todo_set& todo,
       const std::size_t thread_index,
-      std::atomic<std::size_t>& number_of_active_processes,
-      std::atomic<std::size_t>& number_of_idle_processes,
       const SummandSequence& regular_summands,
       const SummandSequence& confluent_summands,
       indexed_set_for_states_type& discovered,
@@ -1067,28 +1235,121 @@ class explorer: public abortable
       state current_state;
       data::data_expression condition;   // The condition is used often, and it is effective not to declare it whenever it is used.
       state_type state_;                 // The same holds for state.
-      std::vector<state> dummy;
-      std::unique_ptr<todo_set> thread_todo=make_todo_set(dummy.begin(),dummy.end()); // The new states for each process are temporarily stored in this vector for each thread. 
       atermpp::term_appl<data::data_expression> key;  
-      if (atermpp::detail::GlobalThreadSafe && m_options.number_of_threads>1) m_exclusive_state_access.lock();
-      while (number_of_active_processes>0 || !todo->empty())
+      std::vector<std::tuple<lps::multi_action, state_type, std::size_t>> transitions; // Used for partial order reduction.
+      stubborn_sets::summand_set enabled(m_stubborn_sets ? m_stubborn_sets->size() : 0);
+      while (!m_must_abort)
       {
-        assert(thread_todo->empty());
-          
-        if (!todo->empty())
+        if (todo.choose_element(thread_index, current_state))
         {
-          todo->choose_element(current_state);
-          thread_todo->insert(current_state);
-          if (atermpp::detail::GlobalThreadSafe && m_options.number_of_threads>1) m_exclusive_state_access.unlock();
-
-          while (!thread_todo->empty() && !m_must_abort)
-          { 
-            thread_todo->choose_element(current_state);
-            std::size_t s_index = discovered.index(current_state,thread_index);
-            start_state(thread_index, current_state, s_index);
-            data::add_assignments(thread_sigma, m_process_parameters, current_state);
+          std::size_t s_index = discovered.index(current_state,thread_index);
+          start_state(thread_index, current_state, s_index);
+          data::add_assignments(thread_sigma, m_process_parameters, current_state);
+          auto report_transition = [&](const lps::multi_action& a, const state_type& s1, std::size_t summand_index)
+          {
+            if constexpr (Timed)
+            { 
+              const data::data_expression& t = current_state[m_n];
+              if (a.has_time() && less_equal(a.time(), t, thread_sigma, thread_rewr))
+              {
+                return;
+              }
+            } 
+            if constexpr (Stochastic)
+            { 
+              std::list<std::size_t> s1_index;
+              const auto& S1 = s1.states;
+              // TODO: join duplicate targets
+              for (const state& s1_: S1)
+              { 
+                std::pair<std::size_t,bool> p = discovered.insert(s1_, thread_index);
+                if (p.second)
+                { 
+                  todo.insert(thread_index, s1_);
+                  discover_state(thread_index, s1_, p.first);
+                }
+                s1_index.push_back(p.first);
+              }
+
+              examine_transition(thread_index, m_options.number_of_threads, current_state, s_index, a, s1, s1_index, summand_index);
+            } 
+            else 
+            { 
+              std::size_t s1_index; 
+              if constexpr (Timed)
+              { 
+                const data::data_expression& t = current_state[m_n];
+                const data::data_expression& t1 = a.has_time() ? a.time() : t;
+                make_timed_state(state_, s1, t1);
+                std::pair<std::size_t,bool> p = discovered.insert(state_, thread_index);
+                s1_index = p.first;
+                if (p.second)
+                {   
+                  discover_state(thread_index, state_, s1_index);
+                  todo.insert(thread_index, state_);
+                } 
+              }
+              else
+              { 
+                std::pair<std::size_t,bool> p = discovered.insert(s1, thread_index);
+                s1_index=p.first;
+                if (p.second)  // Index is newly added. 
+                {
+                  discover_state(thread_index, s1, s1_index);
+                  todo.insert(thread_index, s1); 
+                }
+              }
+
+              examine_transition(thread_index, m_options.number_of_threads, current_state, s_index, a, s1, s1_index, summand_index);
+            }
+          };
+
+          if (m_stubborn_sets)
+          {
+            if constexpr (!Stochastic && !Timed)
+            {
+              // Generate all transitions, and only report those of the enabled summands of a stubborn set.
+              transitions.clear();
+              enabled.reset();
+              for (const explorer_summand& summand: regular_summands)
+              {
+                generate_transitions(summand, confluent_summands, thread_sigma, thread_rewr, condition, state_, key, thread_enumerator, thread_id_generator,
+                  [&](const lps::multi_action& a, const state_type& s1)
+                  {
+                    transitions.emplace_back(a, s1, summand.index);
+                    enabled[summand.index] = true;
+                  }
+                );
+              }
+              stubborn_sets::summand_set stubborn = m_stubborn_sets->compute(enabled);
+
+              // The cycle proviso: if a transition of the stubborn set leads to a state that has been discovered
+              // before, all transitions are explored. Hence every cycle contains a state that is fully explored.
+              if (m_options.partial_order_reduction == lps::partial_order_reduction::stutter && stubborn != enabled)
+              {
+                for (const auto& [a, s1, summand_index]: transitions)
+                {
+                  if (stubborn[summand_index] && discovered.contains(s1, thread_index))
+                  {
+                    stubborn = enabled;
+                    break;
+                  }
+                }
+              }
+
+              for (const auto& [a, s1, summand_index]: transitions)
+              {
+                if (stubborn[summand_index])
+                {
+                  report_transition(a, s1, summand_index);
+                }
+              }
+            }
+          }
+          else
+          {
             for (const explorer_summand& summand: regular_summands)
-            {   
+            {
               generate_transitions(
                 summand,
                 confluent_summands,
@@ -1100,116 +1361,180 @@ class explorer: public abortable
                 thread_enumerator,
                 thread_id_generator,
                 [&](const lps::multi_action& a, const state_type& s1)
-                {   
-                  if constexpr (Timed)
-                  { 
-                    const data::data_expression& t = current_state[m_n];
-                    if (a.has_time() && less_equal(a.time(), t, thread_sigma, thread_rewr))
-                    {
-                      return;
-                    }
-                  } 
-                  if constexpr (Stochastic)
-                  { 
-                    std::list<std::size_t> s1_index;
-                    const auto& S1 = s1.states;
-                    // TODO: join duplicate targets
-                    for (const state& s1_: S1)
-                    { 
-                      std::size_t k = discovered.index(s1_,thread_index);
-                      if (k >= discovered.size())
-                      { 
-                        thread_todo->insert(s1_);
-                        k = discovered.insert(s1_, thread_index).first;
-                        discover_state(thread_index, s1_, k);
-                      }
-                      s1_index.push_back(k);
-                    }
-
-                    examine_transition(thread_index, m_options.number_of_threads, current_state, s_index, a, s1, s1_index, summand.index);
-                  } 
-                  else 
-                  { 
-                    std::size_t s1_index; 
-                    if constexpr (Timed)
-                    { 
-                      s1_index = discovered.index(s1,thread_index);
-                      if (s1_index >= discovered.size())
-                      {   
-                        const data::data_expression& t = current_state[m_n];
-                        const data::data_expression& t1 = a.has_time() ? a.time() : t;
-                        make_timed_state(state_, s1, t1);
-                        s1_index = discovered.insert(state_, thread_index).first;
-                        discover_state(thread_index, state_, s1_index);
-                        thread_todo->insert(state_);
-                      } 
-                    }
-                    else
-                    { 
-                      std::pair<std::size_t,bool> p = discovered.insert(s1, thread_index);
-                      s1_index=p.first;
-                      if (p.second)  // Index is newly added. 
-                      {
-                        discover_state(thread_index, s1, s1_index);
-                        thread_todo->insert(s1); 
-                      }
-                    }
-
-                    examine_transition(thread_index, m_options.number_of_threads, current_state, s_index, a, s1, s1_index, summand.index);
-                  }
-                }
-              );
-            }
-            if (number_of_idle_processes>0 && thread_todo->size()>1)
-            {
-              if (todo->size()<m_options.number_of_threads)  // Not thread_safe, but number is not so important.
-              // if (todo->size()<=number_of_idle_processes)  // Not thread_safe, but number is not so important.
-              {
-                if (atermpp::detail::GlobalThreadSafe && m_options.number_of_threads>1) m_exclusive_state_access.lock();
-                // move 25% of the states of this thread to the global todo buffer.
-                for(std::size_t i=0; i<std::min(thread_todo->size()-1,1+(thread_todo->size()/4)); ++i)  
                 {
-                  thread_todo->choose_element(current_state);
-                  todo->insert(current_state);
+                  report_transition(a, s1, summand.index);
                 }
-                if (atermpp::detail::GlobalThreadSafe && m_options.number_of_threads>1) m_exclusive_state_access.unlock();
-              }
+              );
             }
-
-            finish_state(thread_index, m_options.number_of_threads, current_state, s_index, thread_todo->size());
-            thread_todo->finish_state();
           }
+          finish_state(thread_index, m_options.number_of_threads, current_state, s_index, todo.size(thread_index));
+          todo.finish_state(thread_index);
         }
-        else
-        {
-          if (atermpp::detail::GlobalThreadSafe && m_options.number_of_threads>1) m_exclusive_state_access.unlock();
-        }
-        // Check whether all processes are ready. If so the number_of_active_processes becomes 0. 
-        // Otherwise, this thread becomes active again, and tries to see whether the todo buffer is
-        // not empty, to take up more work. 
-        number_of_active_processes--;
-        number_of_idle_processes++;
-        if (atermpp::detail::GlobalThreadSafe && m_options.number_of_threads>1) m_exclusive_state_access.lock();
-        assert(thread_todo->empty());
-        if (todo->empty())
+        else if (todo.finished())
         {
-          if (atermpp::detail::GlobalThreadSafe && m_options.number_of_threads>1) m_exclusive_state_access.unlock();
-          std::this_thread::sleep_for(std::chrono::milliseconds(100));
-          if (atermpp::detail::GlobalThreadSafe && m_options.number_of_threads>1) m_exclusive_state_access.lock();
+          break;
         }
-        if (number_of_active_processes>0 || !todo->empty())
+        else
         {
-          number_of_active_processes++;
+          // Other threads are still exploring states, and may produce new work that can be stolen.
+          std::this_thread::yield();
         }
-        number_of_idle_processes--;
       } 
       mCRL2log(log::debug) << "Stop thread " << thread_index << ".\n";
-      if (atermpp::detail::GlobalThreadSafe && m_options.number_of_threads>1) m_exclusive_state_access.unlock();
-
     }  // end generate_state_space_thread.
 
 
 
+    // Generates the state space level by level in breadth-first order, while the states are stored on disk
+    // (state_storage::disk). The successors of the states of a level are sorted in external memory, and are
+    // then inserted into the set of discovered states in a single batch (delayed duplicate detection). As the
+    // indices of the successors are only known after this, the transitions of a level are reported to the
+    // callback functions afterwards, again sorted in external memory, but now on their source.
+    // pre: s0 is in normal form
+    template <
+      typename SummandSequence,
+      typename DiscoverState,
+      typename ExamineTransition,
+      typename StartState,
+      typename FinishState
+    >
+    void generate_state_space_disk(
+      const state& s0,
+      const SummandSequence& regular_summands,
+      const SummandSequence& confluent_summands,
+      indexed_set_for_states_type& discovered,
+      DiscoverState discover_state,
+      ExamineTransition examine_transition,
+      StartState start_state,
+      FinishState finish_state
+    )
+    {
+      typedef detail::record_word record_word;
+      if (m_options.number_of_threads > 1 || m_options.search_strategy != es_breadth)
+      {
+        throw mcrl2::runtime_error("Storing the states on disk requires breadth-first search in a single thread.");
+      }
+      external_state_set& states = discovered.disk();
+      states.clear();
+      const std::size_t w = states.record_width();
+
+      // A pending transition consists of the record of the target state, followed by the index of the source
+      // state, the number of the transition among those of the source, and the indices of the action and the summand.
+      // A resolved transition consists of the index of the source state, the number of the transition, the indices
+      // of the action and the summand, the index of the target state, whether the target state is discovered by
+      // this transition, and finally the record of the target state.
+      const std::size_t memory_budget = m_options.memory_budget * 1024 * 1024 / 2;
+      detail::external_sorter pending(states.directory(), w + 4, w + 2, memory_budget);
+      detail::external_sorter resolved(states.directory(), w + 6, 2, memory_budget);
+      std::vector<record_word> entry(w + 6);
+      std::unordered_map<multi_action, std::size_t> action_indices;
+      std::vector<multi_action> actions;
+
+      states.start_batch();
+      states.encode(s0, entry.data());
+      states.insert_sorted(entry.data());
+      states.end_batch();
+      discover_state(0, s0, 0);
+
+      data::data_expression condition;
+      state_type state_;
+      atermpp::term_appl<data::data_expression> key;
+      std::size_t level_begin = 0;
+      std::size_t level_end = 1;
+      while (level_begin < level_end && !m_must_abort)
+      {
+        for (std::size_t s_index = level_begin; s_index < level_end && !m_must_abort; ++s_index)
+        {
+          const state s = states[s_index];
+          data::add_assignments(m_global_sigma, m_process_parameters, s);
+          std::size_t transition_number = 0;
+          for (const explorer_summand& summand: regular_summands)
+          {
+            generate_transitions(
+              summand,
+              confluent_summands,
+              m_global_sigma,
+              m_global_rewr,
+              condition,
+              state_,
+              key,
+              m_global_enumerator,
+              m_global_id_generator,
+              [&](const lps::multi_action& a, const state_type& s1)
+              {
+                if constexpr (Timed)
+                {
+                  const data::data_expression& t = s[m_n];
+                  if (a.has_time() && less_equal(a.time(), t, m_global_sigma, m_global_rewr))
+                  {
+                    return;
+                  }
+                  make_timed_state(state_, s1, a.has_time() ? a.time() : t);
+                  states.encode(state_, entry.data());
+                }
+                else
+                {
+                  states.encode(s1, entry.data());
+                }
+                auto i = action_indices.find(a);
+                if (i == action_indices.end())
+                {
+                  i = action_indices.emplace(a, actions.size()).first;
+                  actions.push_back(a);
+                }
+                entry[w] = s_index;
+                entry[w + 1] = transition_number++;
+                entry[w + 2] = i->second;
+                entry[w + 3] = summand.index;
+                pending.push(entry.data());
+              }
+            );
+          }
+        }
+
+        // Insert the successors. The first transition in the sorted order that leads to a new state discovers it.
+        pending.sort();
+        states.start_batch();
+        while (const record_word* t = pending.next())
+        {
+          std::pair<std::size_t, bool> p = states.insert_sorted(t);
+          entry[0] = t[w];
+          entry[1] = t[w + 1];
+          entry[2] = t[w + 2];
+          entry[3] = t[w + 3];
+          entry[4] = p.first;
+          entry[5] = p.second;
+          std::copy(t, t + w, entry.begin() + 6);
+          resolved.push(entry.data());
+        }
+        states.end_batch();
+        pending.clear();
+
+        // Report the transitions of the level.
+        resolved.sort();
+        const record_word* t = resolved.next();
+        for (std::size_t s_index = level_begin; s_index < level_end && !m_must_abort; ++s_index)
+        {
+          const state s = states[s_index];
+          start_state(0, s, s_index);
+          for (; t != nullptr && t[0] == s_index; t = resolved.next())
+          {
+            const state s1 = states.decode(t + 6);
+            if (t[5])
+            {
+              discover_state(0, s1, t[4]);
+            }
+            examine_transition(0, 1, s, s_index, actions[t[2]], s1, t[4], t[3]);
+          }
+          finish_state(0, 1, s, s_index, states.size() - s_index - 1);
+        }
+        resolved.clear();
+
+        level_begin = level_end;
+        level_end = states.size();
+      }
+    }
+
     // pre: s0 is in normal form
     template <
       typename StateType,
@@ -1235,42 +1560,74 @@ class explorer: public abortable
     {
       utilities::mcrl2_unused(discover_initial_state); // silence unused parameter warning
 
+      if (discovered.storage() == state_storage::disk)
+      {
+        if constexpr (Stochastic)
+        {
+          throw mcrl2::runtime_error("Storing the states on disk is not supported for stochastic specifications.");
+        }
+        else
+        {
+          m_recursive = recursive;
+          generate_state_space_disk(s0, regular_summands, confluent_summands, discovered, discover_state,
+                                    examine_transition, start_state, finish_state);
+          m_must_abort = false;
+          return;
+        }
+      }
+
       const std::size_t number_of_threads=m_options.number_of_threads;
       assert(number_of_threads>0);
       const std::size_t initialisation_thread_index= (number_of_threads==1?0:1);
       m_recursive = recursive;
-      std::unique_ptr<todo_set> todo;
-      discovered.clear(initialisation_thread_index);
-
-      if constexpr (Stochastic)
+      // There is a todo set for each thread. Threads are numbered from 1 to number_of_threads,
+      // and thread number 0 is reserved for the sequential implementation.
+      std::vector<std::unique_ptr<todo_set>> todos;
+      std::vector<state> empty;
+      for (std::size_t i = 0; i <= (number_of_threads == 1 ? 0 : number_of_threads); ++i)
+      {
+        todos.push_back(make_todo_set(empty.begin(), empty.end()));
+      }
+      if (m_resume)
+      {
+        if constexpr (Stochastic)
+        {
+          throw mcrl2::runtime_error("Resuming from a checkpoint is not supported for stochastic specifications.");
+        }
+        todos[initialisation_thread_index] = make_todo_set(m_resume_todo.begin(), m_resume_todo.end());
+        m_resume_todo.clear();
+        m_resume = false;
+      }
+      else if constexpr (Stochastic)
       {
+        discovered.clear(initialisation_thread_index);
         state_type s0_ = make_state(s0);
         const auto& S = s0_.states;
-        todo = make_todo_set(S.begin(), S.end());
+        todos[initialisation_thread_index] = make_todo_set(S.begin(), S.end());
         discovered.clear();
         std::list<std::size_t> s0_index;
         for (const state& s: S)
         {
           // TODO: join duplicate targets
-          std::size_t s_index = discovered.index(s);
-          if (s_index >= discovered.size())
+          std::pair<std::size_t,bool> p = discovered.insert(s, initialisation_thread_index);
+          if (p.second)
           {
-            s_index = discovered.insert(s, initialisation_thread_index).first;
-            discover_state(initialisation_thread_index, s, s_index);
+            discover_state(initialisation_thread_index, s, p.first);
           }
-          s0_index.push_back(s_index);
+          s0_index.push_back(p.first);
         }
         discover_initial_state(s0_, s0_index);
       }
       else
       {
-        todo = make_todo_set(s0);
+        discovered.clear(initialisation_thread_index);
+        todos[initialisation_thread_index] = make_todo_set(s0);
         std::size_t s0_index = discovered.insert(s0, initialisation_thread_index).first;
         discover_state(initialisation_thread_index, s0, s0_index);
       }
 
-      std::atomic<std::size_t> number_of_active_processes=number_of_threads;
-      std::atomic<std::size_t> number_of_idle_processes=0;
+      work_stealing_todo_set todo(std::move(todos));
+      m_todo = &todo;
 
       if (number_of_threads>1)
       {
@@ -1285,7 +1642,7 @@ class explorer: public abortable
                                                          StartState, FinishState,
                                                          DiscoverInitialState >
                                        (todo, 
-                                        i, number_of_active_processes, number_of_idle_processes,
+                                        i,
                                         regular_summands,confluent_summands,discovered, discover_state,
                                         examine_transition, start_state, finish_state, 
                                         m_global_rewr.clone(), m_global_sigma); } );  // It is essential that the rewriter is cloned as
@@ -1307,12 +1664,13 @@ class explorer: public abortable
                                                 DiscoverState, ExamineTransition,
                                                 StartState, FinishState,
                                                 DiscoverInitialState >
-                                  (todo,single_thread_index,number_of_active_processes, number_of_idle_processes,
+                                  (todo,single_thread_index,
                                    regular_summands,confluent_summands,discovered, discover_state,
                                    examine_transition, start_state, finish_state, 
                                    m_global_rewr, m_global_sigma);  
       }
 
+      m_todo = nullptr;
       m_must_abort = false;
     }
 
@@ -1700,11 +2058,66 @@ class explorer: public abortable
     }
 
     /// \brief Returns a mapping containing all discovered states.
+    /// \brief Writes the discovered states and the todo set of the exploration that is in progress to stream.
+    /// \details This is only consistent between the exploration of two states, e.g., in the finish_state
+    ///          callback. It is not supported for multiple threads, and for the state storages from which
+    ///          the states cannot be retrieved.
+    void save_checkpoint(atermpp::aterm_ostream& stream) const
+    {
+      if (m_options.number_of_threads > 1)
+      {
+        throw mcrl2::runtime_error("Checkpoints are not supported for exploration with multiple threads.");
+      }
+      if (m_discovered.storage() != state_storage::terms && m_discovered.storage() != state_storage::tree)
+      {
+        throw mcrl2::runtime_error("Checkpoints are not supported for the state storage " + print_state_storage(m_discovered.storage()) + ".");
+      }
+      stream << atermpp::aterm_int(m_discovered.size());
+      for (std::size_t i = 0; i < m_discovered.size(); ++i)
+      {
+        stream << m_discovered[i];
+      }
+      stream << (m_todo == nullptr ? std::vector<state>() : m_todo->elements());
+    }
+
+    /// \brief Reads the discovered states and the todo set that were written by save_checkpoint. The next
+    ///        call of generate_state_space continues the exploration from there.
+    void load_checkpoint(atermpp::aterm_istream& stream)
+    {
+      m_discovered.clear();
+      atermpp::aterm_int n;
+      stream >> n;
+      for (std::size_t i = 0; i < n.value(); ++i)
+      {
+        state s;
+        stream >> s;
+        m_discovered.insert(s);
+      }
+      m_resume_todo.clear();
+      stream >> m_resume_todo;
+      m_resume = true;
+    }
+
     const indexed_set_for_states_type& state_map() const
     {
       return m_discovered;
     }
 
+    /// \brief Returns the number of hits, misses and evictions of the caches of the summands.
+    summand_cache_statistics cache_statistics() const
+    {
+      summand_cache_statistics result = global_cache.statistics();
+      for (const explorer_summand& summand: m_regular_summands)
+      {
+        result += summand.local_cache.statistics();
+      }
+      for (const explorer_summand& summand: m_confluent_summands)
+      {
+        result += summand.local_cache.statistics();
+      }
+      return result;
+    }
+
     const std::vector<explorer_summand>& regular_summands() const
     {
       return m_regular_summands;
@@ -17,6 +17,8 @@
 #include "mcrl2/data/rewrite_strategy.h"
 #include "mcrl2/lps/multi_action.h"
 #include "mcrl2/lps/exploration_strategy.h"
+#include "mcrl2/lps/state_indexed_set.h"
+#include "mcrl2/lps/stubborn_sets.h"
 
 namespace mcrl2 {
 
@@ -26,11 +28,22 @@ struct explorer_options
 {
   data::rewrite_strategy rewrite_strategy = data::jitty;
   exploration_strategy search_strategy;
+  lps::state_storage state_storage = lps::state_storage::terms;
+  std::size_t fingerprint_bits = 64;
+  std::size_t bitstate_bits = 30;
+  std::size_t bitstate_hash_functions = 3;
+  std::string disk_directory;      // The directory of the temporary files for state_storage::disk.
+  std::size_t memory_budget = 1024; // The memory in MB for sorting the transitions for state_storage::disk.
+  std::string checkpoint_file;      // If not empty, checkpoints are written to this file periodically.
+  std::size_t checkpoint_interval = 600; // The time in seconds between two checkpoints.
+  bool resume = false;              // If true, the exploration is resumed from checkpoint_file.
+  lps::partial_order_reduction partial_order_reduction = lps::partial_order_reduction::none;
   bool one_point_rule_rewrite = false;
   bool replace_constants_by_variables = false;
   bool remove_unused_rewrite_rules = false;
   bool cached = false;
   bool global_cache = false;
+  std::size_t cache_size = 0;       // The memory in MB for the caches of --cached, or 0 if their size is unbounded.
   bool confluence = false;
   bool detect_deadlock = false;
   bool detect_nondeterminism = false;
@@ -62,8 +75,19 @@ std::ostream& operator<<(std::ostream& out, const explorer_options& options)
 {
   out << "rewrite-strategy = " << options.rewrite_strategy << std::endl;
   out << "search-strategy = " << options.search_strategy << std::endl;
+  out << "state-storage = " << options.state_storage << std::endl;
+  out << "fingerprint-bits = " << options.fingerprint_bits << std::endl;
+  out << "bitstate-bits = " << options.bitstate_bits << std::endl;
+  out << "bitstate-hash-functions = " << options.bitstate_hash_functions << std::endl;
+  out << "disk-directory = " << options.disk_directory << std::endl;
+  out << "memory-budget = " << options.memory_budget << std::endl;
+  out << "checkpoint-file = " << options.checkpoint_file << std::endl;
+  out << "checkpoint-interval = " << options.checkpoint_interval << std::endl;
+  out << "resume = " << std::boolalpha << options.resume << std::endl;
+  out << "partial-order-reduction = " << options.partial_order_reduction << std::endl;
   out << "cached = " << std::boolalpha << options.cached << std::endl;
   out << "global-cache = " << std::boolalpha << options.global_cache << std::endl;
+  out << "cache-size = " << options.cache_size << std::endl;
   out << "confluence = " << std::boolalpha << options.confluence << std::endl;
   out << "confluence-action = " << options.confluence << std::endl;
   out << "one-point-rule-rewrite = " << std::boolalpha << options.one_point_rule_rewrite << std::endl;
@@ -0,0 +1,246 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/external_state_set.h
+/// \brief A set of states that is stored on disk, for state space exploration in external memory.
+
+#ifndef MCRL2_LPS_EXTERNAL_STATE_SET_H
+#define MCRL2_LPS_EXTERNAL_STATE_SET_H
+
+#include "mcrl2/atermpp/standard_containers/indexed_set.h"
+#include "mcrl2/lps/detail/external_sort.h"
+#include "mcrl2/lps/state.h"
+
+namespace mcrl2::lps {
+
+/// \brief A set of states of a fixed size that is stored on disk.
+/// \details A state is encoded as a record with for each position the index of its value in an
+///          in-memory table of the values at that position. Only these tables are kept in memory,
+///          and they are typically much smaller than the set of states. The records are stored
+///          in a file in the order of their indices, and in a few runs that are sorted on the
+///          records and are used for duplicate detection. States are inserted in batches, in which
+///          the records must be inserted in sorted order, such that duplicates can be detected by
+///          a single sequential scan of the runs.
+class external_state_set
+{
+  public:
+    typedef std::size_t size_type;
+    typedef detail::record_word record_word;
+
+  protected:
+    // If there are more sorted runs than this, they are merged into a single run.
+    static constexpr std::size_t max_runs = 8;
+
+    std::filesystem::path m_directory;
+    std::size_t m_state_size;
+    std::size_t m_width; // The number of words of a record, which is at least one.
+    std::size_t m_size = 0;
+    std::vector<atermpp::indexed_set<data::data_expression>> m_leaves;
+    std::unique_ptr<detail::record_file> m_states;
+    mutable std::unique_ptr<detail::record_reader> m_state_reader;
+    std::vector<std::unique_ptr<detail::record_file>> m_runs; // Each record is followed by its index.
+
+    // The state of the current batch.
+    std::vector<std::unique_ptr<detail::record_reader>> m_run_readers;
+    std::unique_ptr<detail::record_file> m_new_run;
+    std::vector<record_word> m_last; // The record that was inserted last, followed by its index.
+    std::pair<size_type, bool> m_last_result;
+    bool m_has_last = false;
+
+    bool equal(const record_word* x, const record_word* y) const
+    {
+      return std::equal(x, x + m_width, y);
+    }
+
+    void merge_runs()
+    {
+      std::vector<std::unique_ptr<detail::record_reader>> readers;
+      for (const std::unique_ptr<detail::record_file>& run: m_runs)
+      {
+        readers.push_back(std::make_unique<detail::record_reader>(*run));
+      }
+      auto merged = std::make_unique<detail::record_file>(m_directory, m_width + 1);
+      while (true)
+      {
+        detail::record_reader* first = nullptr;
+        for (const std::unique_ptr<detail::record_reader>& reader: readers)
+        {
+          if (!reader->at_end() && (first == nullptr || detail::record_less(reader->current(), first->current(), m_width)))
+          {
+            first = reader.get();
+          }
+        }
+        if (first == nullptr)
+        {
+          break;
+        }
+        merged->append(first->current());
+        first->next();
+      }
+      merged->flush();
+      readers.clear();
+      m_runs.clear();
+      m_runs.push_back(std::move(merged));
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param directory The directory in which the files are stored. If it is empty, the default
+    ///        temporary directory is used.
+    /// \param state_size The number of elements of the states.
+    explicit external_state_set(const std::string& directory = "", std::size_t state_size = 0)
+      : m_directory(directory),
+        m_state_size(state_size),
+        m_width(std::max<std::size_t>(1, state_size)),
+        m_leaves(state_size),
+        m_last(m_width + 1)
+    {
+      m_states = std::make_unique<detail::record_file>(m_directory, m_width);
+    }
+
+    const std::filesystem::path& directory() const
+    {
+      return m_directory;
+    }
+
+    /// \brief The number of words of the record of a state.
+    std::size_t record_width() const
+    {
+      return m_width;
+    }
+
+    /// \brief Stores the record of the state s in r, which must have room for record_width() words.
+    void encode(const state& s, record_word* r)
+    {
+      assert(s.size() == m_state_size);
+      r[0] = 0;
+      std::size_t i = 0;
+      for (const data::data_expression& d: s)
+      {
+        r[i] = m_leaves[i].insert(d).first;
+        ++i;
+      }
+    }
+
+    /// \brief Returns the state of the record r.
+    state decode(const record_word* r) const
+    {
+      std::vector<data::data_expression> values;
+      values.reserve(m_state_size);
+      for (std::size_t i = 0; i < m_state_size; ++i)
+      {
+        values.push_back(m_leaves[i][r[i]]);
+      }
+      state result;
+      make_state(result, values.begin(), m_state_size);
+      return result;
+    }
+
+    /// \brief Starts a batch of insertions.
+    void start_batch()
+    {
+      for (const std::unique_ptr<detail::record_file>& run: m_runs)
+      {
+        m_run_readers.push_back(std::make_unique<detail::record_reader>(*run));
+      }
+      m_new_run = std::make_unique<detail::record_file>(m_directory, m_width + 1);
+      m_has_last = false;
+    }
+
+    /// \brief Inserts the state with record r, and returns its index and whether it was newly inserted.
+    /// \pre The records that are inserted in the current batch are non-decreasing.
+    std::pair<size_type, bool> insert_sorted(const record_word* r)
+    {
+      assert(m_new_run);
+      if (m_has_last)
+      {
+        assert(!detail::record_less(r, m_last.data(), m_width));
+        if (equal(r, m_last.data()))
+        {
+          return std::make_pair(m_last_result.first, false);
+        }
+      }
+      std::copy(r, r + m_width, m_last.begin());
+      m_has_last = true;
+      for (const std::unique_ptr<detail::record_reader>& reader: m_run_readers)
+      {
+        while (!reader->at_end() && detail::record_less(reader->current(), r, m_width))
+        {
+          reader->next();
+        }
+        if (!reader->at_end() && equal(reader->current(), r))
+        {
+          m_last_result = std::make_pair(static_cast<size_type>(reader->current()[m_width]), false);
+          return m_last_result;
+        }
+      }
+      m_last_result = std::make_pair(m_size++, true);
+      m_states->append(r);
+      m_last[m_width] = m_last_result.first; // The index is stored directly after the record.
+      m_new_run->append(m_last.data());
+      return m_last_result;
+    }
+
+    /// \brief Ends a batch of insertions. After this the states of the batch can be read.
+    void end_batch()
+    {
+      m_run_readers.clear();
+      m_states->flush();
+      m_new_run->flush();
+      if (m_new_run->size() > 0)
+      {
+        m_runs.push_back(std::move(m_new_run));
+      }
+      m_new_run.reset();
+      if (m_runs.size() > max_runs)
+      {
+        merge_runs();
+      }
+    }
+
+    /// \brief Returns the record of the state with the given index, which remains valid until the next call.
+    /// \details Reading the states in the order of their indices is efficient.
+    const record_word* record(size_type index) const
+    {
+      if (!m_state_reader)
+      {
+        m_state_reader = std::make_unique<detail::record_reader>(*m_states);
+      }
+      return (*m_state_reader)[index];
+    }
+
+    /// \brief Returns the state with the given index.
+    state operator[](size_type index) const
+    {
+      return decode(record(index));
+    }
+
+    size_type size() const
+    {
+      return m_size;
+    }
+
+    void clear()
+    {
+      m_run_readers.clear();
+      m_new_run.reset();
+      m_runs.clear();
+      m_state_reader.reset();
+      m_states = std::make_unique<detail::record_file>(m_directory, m_width);
+      for (atermpp::indexed_set<data::data_expression>& leaves: m_leaves)
+      {
+        leaves.clear();
+      }
+      m_size = 0;
+      m_has_last = false;
+    }
+};
+
+} // namespace mcrl2::lps
+
+#endif // MCRL2_LPS_EXTERNAL_STATE_SET_H
@@ -14,6 +14,7 @@
 
 #include "mcrl2/data/data_expression.h"
 #include "mcrl2/lps/action_summand.h"
+#include "mcrl2/lps/detail/read_write_parameters.h"
 #include "mcrl2/lps/specification.h"
 #include "mcrl2/symbolic/summand_group.h"
 #include "mcrl2/symbolic/utility.h"
@@ -79,47 +80,6 @@ struct lps_summand_group: public symbolic::summand_group
   std::vector<lps::multi_action> actions;
 };
 
-namespace 
-{
-
-/// \brief Computes the read and written process parameters for the given summand
-inline
-std::pair<std::set<data::variable>, std::set<data::variable>> read_write_parameters(const lps::action_summand& summand, const std::set<data::variable>& process_parameters)
-{
-  using utilities::detail::set_union;
-  using utilities::detail::set_intersection;
-
-  // TODO: multi-action free variables are only necessary when actions are rewritten.
-  std::set<data::variable> read_parameters = set_union(data::find_free_variables(summand.condition()), lps::find_free_variables(summand.multi_action()));
-  std::set<data::variable> write_parameters;
-
-  for (const auto& assignment: summand.assignments())
-  {
-    if (assignment.lhs() != assignment.rhs())
-    {
-      write_parameters.insert(assignment.lhs());
-      data::find_free_variables(assignment.rhs(), std::inserter(read_parameters, read_parameters.end()));
-    }
-  }
-
-  return { set_intersection(read_parameters, process_parameters), set_intersection(write_parameters, process_parameters) };
-}
-
-/// \brief Assigns a unique index to every parameter of the process.
-inline
-std::map<data::variable, std::size_t> process_parameter_index(const lps::specification& lpsspec)
-{
-  std::map<data::variable, std::size_t> result;
-  std::size_t i = 0;
-  for (const data::variable& v: lpsspec.process().process_parameters())
-  {
-    result[v] = i++;
-  }
-  return result;
-}
-
-} // internal
-
 std::vector<boost::dynamic_bitset<>> compute_read_write_patterns(const lps::specification& lpsspec)
 {
   using utilities::detail::as_set;
@@ -128,11 +88,11 @@ std::vector<boost::dynamic_bitset<>> compute_read_write_patterns(const lps::spec
 
   auto process_parameters = as_set(lpsspec.process().process_parameters());
   std::size_t n = process_parameters.size();
-  std::map<data::variable, std::size_t> index = process_parameter_index(lpsspec);
+  std::map<data::variable, std::size_t> index = detail::process_parameter_index(lpsspec.process().process_parameters());
 
   for (const auto& summand: lpsspec.process().action_summands())
   {
-    auto [read_parameters, write_parameters] = read_write_parameters(summand, process_parameters);
+    auto [read_parameters, write_parameters] = detail::read_write_parameters(summand, process_parameters);
     auto read = symbolic::parameter_indices(read_parameters, index);
     auto write = symbolic::parameter_indices(write_parameters, index);
     boost::dynamic_bitset<> rw(2*n);
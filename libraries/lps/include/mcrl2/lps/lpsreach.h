@@ -31,8 +31,13 @@
 
 #include <sylvan_ldd.hpp>
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <exception>
 #include <iomanip>
+#include <mutex>
+#include <thread>
 #include <boost/dynamic_bitset.hpp>
 
 namespace mcrl2::lps {
@@ -47,6 +52,7 @@ class lpsreach_algorithm
 
   protected:
     const symbolic::symbolic_reachability_options& m_options;
+    data::data_specification m_data_specification;
     data::rewriter m_rewr;
     data::mutable_indexed_substitution<> m_sigma;
     data::enumerator_identifier_generator m_id_generator;
@@ -77,9 +83,243 @@ class lpsreach_algorithm
         );
     }
 
+    // A transition that is learned by a worker thread. The values of the write parameters and the action
+    // are not yet added to the data and action indices, as these are not thread safe.
+    struct learned_transition
+    {
+      std::size_t summand; // the index of the summand in its group
+      std::vector<data::data_expression> values; // the values of the write parameters, or default values for copy parameters
+      lps::multi_action action;
+    };
+
+    // The successors of a projected state x of a summand group.
+    struct learn_task
+    {
+      std::size_t group;
+      std::vector<std::uint32_t> x;
+      std::vector<learned_transition> transitions;
+      double time = 0.0;
+    };
+
+    // The helper threads for learning transitions in parallel, see learn_successors_parallel.
+    std::vector<std::thread> m_learn_threads;
+    std::mutex m_learn_mutex;
+    std::condition_variable m_learn_start;
+    std::condition_variable m_learn_done;
+    std::size_t m_learn_round = 0;
+    std::size_t m_learn_active = 0; // The number of helper threads that have not finished the current round.
+    bool m_learn_stop = false;
+    std::vector<learn_task>* m_learn_tasks = nullptr;
+    std::atomic<std::size_t> m_learn_next_task{0};
+    std::vector<std::exception_ptr> m_learn_exceptions;
+
+    static void collect_projected_states(WorkerP*, Task*, std::uint32_t* x, std::size_t n, void* context)
+    {
+      auto p = reinterpret_cast<std::pair<std::size_t, std::vector<learn_task>&>*>(context);
+      p->second.push_back(learn_task{p->first, std::vector<std::uint32_t>(x, x + n), {}});
+    }
+
+    bool learn_in_parallel() const
+    {
+      return m_options.max_workers > 1;
+    }
+
+    // Computes the successors of task.x in its summand group. This function only reads the data index, such
+    // that it can be called by several threads at the same time.
+    void learn_task_successors(learn_task& task,
+                               const data::rewriter& rewr,
+                               const data::enumerator_algorithm<>& enumerator,
+                               data::mutable_indexed_substitution<>& sigma)
+    {
+      const lps_summand_group& group = m_lts.summand_groups[task.group];
+      stopwatch learn_start;
+      for (std::size_t j = 0; j < group.read.size(); j++)
+      {
+        sigma[group.read_parameters[j]] = m_lts.data_index[group.read[j]][task.x[j]];
+      }
+
+      for (std::size_t i = 0; i < group.summands.size(); i++)
+      {
+        const auto& smd = group.summands[i];
+        data::data_expression condition = rewr(smd.condition, sigma);
+        if (!data::is_false(condition))
+        {
+          enumerator.enumerate(enumerator_element(smd.variables, condition),
+                               sigma,
+                               [&](const enumerator_element& p) {
+                                 symbolic::check_enumerator_solution(p, group);
+                                 p.add_assignments(smd.variables, sigma, rewr);
+                                 learned_transition t{i, std::vector<data::data_expression>(group.write.size()), rewrite_action(group.actions[i], rewr, sigma)};
+                                 for (std::size_t j = 0; j < group.write.size(); j++)
+                                 {
+                                   if (!smd.copy[group.write_pos[j]])
+                                   {
+                                     t.values[j] = rewr(smd.next_state[j], sigma);
+                                   }
+                                 }
+                                 task.transitions.push_back(std::move(t));
+                                 return false;
+                               },
+                               data::is_false
+          );
+        }
+        data::remove_assignments(sigma, smd.variables);
+      }
+      data::remove_assignments(sigma, group.read_parameters);
+      task.time = learn_start.seconds();
+    }
+
+    // Adds the transitions of the task to the transition relation of its summand group.
+    void add_learned_transitions(const learn_task& task)
+    {
+      using namespace sylvan::ldds;
+
+      lps_summand_group& group = m_lts.summand_groups[task.group];
+      std::size_t xy_size = group.read.size() + group.write.size() + 1; // One additional space for the action label.
+      std::vector<std::uint32_t> xy(xy_size);
+      for (std::size_t j = 0; j < group.read.size(); j++)
+      {
+        xy[group.read_pos[j]] = task.x[j];
+      }
+
+      for (const learned_transition& t: task.transitions)
+      {
+        const auto& smd = group.summands[t.summand];
+        for (std::size_t j = 0; j < group.write.size(); j++)
+        {
+          xy[group.write_pos[j]] = smd.copy[group.write_pos[j]] ? symbolic::relprod_ignore : m_lts.data_index[group.write[j]].insert(t.values[j]).first;
+        }
+        xy[xy_size - 1] = m_lts.action_index.insert(t.action).first;
+
+        mCRL2log(log::debug1) << "  " << print_transition(m_lts.data_index, xy.data(), group.read, group.write) << std::endl;
+        group.L = m_options.no_relprod ? union_cube(group.L, xy.data(), xy_size) : union_cube_copy(group.L, xy.data(), smd.copy.data(), xy_size);
+      }
+      group.learn_calls += 1;
+      group.learn_time += task.time;
+
+      if (m_options.cached)
+      {
+        group.Ldomain = union_cube(group.Ldomain, task.x.data(), task.x.size());
+      }
+    }
+
+    // Learns the successors of the tasks in m_learn_tasks that are handed out in chunks, to balance the
+    // load without contention on the counter.
+    void learn_task_chunks(const data::rewriter& rewr, const data::enumerator_algorithm<>& enumerator, data::mutable_indexed_substitution<>& sigma)
+    {
+      constexpr std::size_t chunk_size = 16;
+      std::vector<learn_task>& tasks = *m_learn_tasks;
+      for (std::size_t first = m_learn_next_task.fetch_add(chunk_size); first < tasks.size(); first = m_learn_next_task.fetch_add(chunk_size))
+      {
+        for (std::size_t k = first; k < std::min(first + chunk_size, tasks.size()); k++)
+        {
+          learn_task_successors(tasks[k], rewr, enumerator, sigma);
+        }
+      }
+    }
+
+    // The function that is executed by the helper threads for learning. Each round of learning is started
+    // by increasing m_learn_round.
+    void learn_thread(std::size_t thread_index, data::rewriter rewr, data::mutable_indexed_substitution<> sigma)
+    {
+      rewr.thread_initialise();
+      data::enumerator_identifier_generator id_generator("t_");
+      data::enumerator_algorithm<> enumerator(rewr, m_data_specification, rewr, id_generator, false);
+      std::size_t round = 0;
+      while (true)
+      {
+        {
+          std::unique_lock<std::mutex> lock(m_learn_mutex);
+          m_learn_start.wait(lock, [&]() { return m_learn_stop || m_learn_round != round; });
+          if (m_learn_stop)
+          {
+            return;
+          }
+          round = m_learn_round;
+        }
+        try
+        {
+          learn_task_chunks(rewr, enumerator, sigma);
+        }
+        catch (...)
+        {
+          m_learn_exceptions[thread_index] = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(m_learn_mutex);
+        if (--m_learn_active == 0)
+        {
+          m_learn_done.notify_one();
+        }
+      }
+    }
+
+    // For each index k: R[I[k]].L := R[I[k]].L U {(x,y) in R | x in X[k]}
+    // The successors are computed by the calling thread together with m_options.max_workers - 1 helper threads,
+    // each with its own rewriter and enumerator. The helper threads are started once, as starting a thread and
+    // cloning a rewriter is expensive. The indices and the transition relations are updated afterwards by the
+    // calling thread, in the order of the projected states, such that the result does not depend on the
+    // scheduling of the threads.
+    void learn_successors_parallel(const std::vector<std::size_t>& I, const std::vector<ldd>& X)
+    {
+      using namespace sylvan::ldds;
+
+      std::vector<learn_task> tasks;
+      for (std::size_t k = 0; k < I.size(); k++)
+      {
+        mCRL2log(log::debug1) << "learn successors of summand group " << I[k] << " for X = " << print_states(m_lts.data_index, X[k], m_lts.summand_groups[I[k]].read) << std::endl;
+        std::pair<std::size_t, std::vector<learn_task>&> context{I[k], tasks};
+        sat_all_nopar(X[k], collect_projected_states, &context);
+      }
+
+      m_learn_tasks = &tasks;
+      m_learn_next_task = 0;
+      if (tasks.size() > 1)
+      {
+        if (m_learn_threads.empty())
+        {
+          m_learn_exceptions.resize(m_options.max_workers - 1);
+          for (std::size_t t = 0; t < m_options.max_workers - 1; t++)
+          {
+            // One rewriter cannot be used by several threads at the same time.
+            m_learn_threads.emplace_back(&lpsreach_algorithm::learn_thread, this, t, m_rewr.clone(), m_sigma);
+          }
+        }
+        std::lock_guard<std::mutex> lock(m_learn_mutex);
+        m_learn_active = m_learn_threads.size();
+        m_learn_round++;
+        m_learn_start.notify_all();
+      }
+
+      learn_task_chunks(m_rewr, m_enumerator, m_sigma);
+
+      if (tasks.size() > 1)
+      {
+        std::unique_lock<std::mutex> lock(m_learn_mutex);
+        m_learn_done.wait(lock, [&]() { return m_learn_active == 0; });
+      }
+      for (std::exception_ptr& e: m_learn_exceptions)
+      {
+        if (e)
+        {
+          std::rethrow_exception(std::exchange(e, nullptr));
+        }
+      }
+
+      for (const learn_task& task: tasks)
+      {
+        add_learned_transitions(task);
+      }
+    }
+
     // R.L := R.L U {(x,y) in R | x in X}
     void learn_successors(std::size_t i, symbolic::summand_group& R, const ldd& X)
     {
+      if (learn_in_parallel())
+      {
+        learn_successors_parallel({ i }, { X });
+        return;
+      }
+
       mCRL2log(log::debug1) << "learn successors of summand group " << i << " for X = " << print_states(m_lts.data_index, X, R.read) << std::endl;
 
       using namespace sylvan::ldds;
@@ -87,6 +327,15 @@ class lpsreach_algorithm
       sat_all_nopar(X, symbolic::learn_successors_callback<std::pair<lpsreach_algorithm&, lps_summand_group&>, true>, &context);
     }
 
+    // Returns the projection of U on the read parameters of R[i] of which the successors must still be learned.
+    ldd learn_domain(std::size_t i, const ldd& U)
+    {
+      using namespace sylvan::ldds;
+      auto& R = m_lts.summand_groups;
+      ldd proj = project(U, R[i].Ip);
+      return m_options.cached ? minus(proj, R[i].Ldomain) : proj;
+    }
+
     template <typename Specification>
     Specification preprocess(const Specification& lpsspec)
     {
@@ -114,6 +363,7 @@ class lpsreach_algorithm
   public:
     lpsreach_algorithm(const lps::specification& lpsspec, const symbolic::symbolic_reachability_options& options_)
       : m_options(options_),
+        m_data_specification(lpsspec.data()),
         m_rewr(symbolic::construct_rewriter(lpsspec.data(), m_options.rewrite_strategy, lps::find_function_symbols(lpsspec), m_options.remove_unused_rewrite_rules)),
         m_enumerator(m_rewr, lpsspec.data(), m_rewr, m_id_generator, false)
     {
@@ -165,6 +415,19 @@ class lpsreach_algorithm
       }
     }
 
+    ~lpsreach_algorithm()
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_learn_mutex);
+        m_learn_stop = true;
+        m_learn_start.notify_all();
+      }
+      for (std::thread& thread: m_learn_threads)
+      {
+        thread.join();
+      }
+    }
+
     /// \brief Computes relprod(U, group).
     ldd relprod_impl(const ldd& U, const lps_summand_group& group, std::size_t i)
     {
@@ -197,12 +460,28 @@ class lpsreach_algorithm
         // regular and chaining.
         todo1 = m_options.chaining ? todo : empty_set();
 
+        // Without chaining the groups are learned from the same todo set, so they can be learned at the same time.
+        bool learn_all_groups = learn_transitions && !m_options.chaining && learn_in_parallel();
+        if (learn_all_groups)
+        {
+          std::vector<std::size_t> I;
+          std::vector<ldd> X;
+          for (std::size_t i = 0; i < R.size(); i++)
+          {
+            I.push_back(i);
+            X.push_back(learn_domain(i, todo));
+          }
+          learn_successors_parallel(I, X);
+        }
+
         for (std::size_t i = 0; i < R.size(); i++)
         {
           if (learn_transitions)
           {
-            ldd proj = project(m_options.chaining ? todo1 : todo, R[i].Ip);
-            learn_successors(i, R[i], m_options.cached ? minus(proj, R[i].Ldomain) : proj);
+            if (!learn_all_groups)
+            {
+              learn_successors(i, R[i], learn_domain(i, m_options.chaining ? todo1 : todo));
+            }
 
             mCRL2log(log::debug1) << "L =\n" << print_relation(m_lts.data_index, R[i].L, R[i].read, R[i].write) << std::endl;
           }
@@ -225,8 +504,7 @@ class lpsreach_algorithm
         {
           if (learn_transitions)
           {
-            ldd proj = project(todo1, R[i].Ip);
-            learn_successors(i, R[i], m_options.cached ? minus(proj, R[i].Ldomain) : proj);
+            learn_successors(i, R[i], learn_domain(i, todo1));
 
             mCRL2log(log::debug1) << "L =\n" << print_relation(m_lts.data_index, R[i].L, R[i].read, R[i].write) << std::endl;
           }
@@ -79,6 +79,35 @@ T rewrite(const T& x,
 }
 //--- end generated lps rewrite code ---//
 
+/// \brief Rewrites all embedded expressions in an object x, and rewrites every distinct expression only once
+/// \details The summands of a linear process often share their conditions, actions and next states, which are then
+///          rewritten once instead of once per occurrence. The rewriter must not depend on the context of an expression.
+/// \param x an object containing expressions
+/// \param R a rewriter
+template <typename T, typename Rewriter>
+void memoising_rewrite(T& x,
+                       Rewriter R,
+                       typename std::enable_if<!std::is_base_of<atermpp::aterm, T>::value>::type* = nullptr
+                      )
+{
+  data::detail::make_memoising_rewrite_data_expressions_builder<lps::data_expression_builder>(R).update(x);
+}
+
+/// \brief Rewrites all embedded expressions in an object x, and rewrites every distinct expression only once
+/// \param x an object containing expressions
+/// \param R a rewriter
+/// \return the rewrite result
+template <typename T, typename Rewriter>
+T memoising_rewrite(const T& x,
+                    Rewriter R,
+                    typename std::enable_if<std::is_base_of<atermpp::aterm, T>::value>::type* = nullptr
+                   )
+{
+  T result;
+  data::detail::make_memoising_rewrite_data_expressions_builder<lps::data_expression_builder>(R).apply(result, x);
+  return result;
+}
+
 } // namespace lps
 
 } // namespace mcrl2
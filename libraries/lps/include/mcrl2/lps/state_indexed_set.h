@@ -0,0 +1,693 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/state_indexed_set.h
+/// \brief Indexed sets for storing the states that are discovered during state space exploration.
+
+#ifndef MCRL2_LPS_STATE_INDEXED_SET_H
+#define MCRL2_LPS_STATE_INDEXED_SET_H
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/atermpp/standard_containers/indexed_set.h"
+#include "mcrl2/utilities/exception.h"
+#include "mcrl2/utilities/stack_array.h"
+#include "mcrl2/lps/external_state_set.h"
+
+namespace mcrl2::lps {
+
+/// \brief An indexed set of states of a fixed size, in which a state is stored as a balanced
+///        binary tree of hash-consed pairs of indices, as in the tree table of LTSmin.
+/// \details The data expressions at position i of the states are stored in a leaf table of their
+///          own. Each internal node of the tree has a table of pairs of indices in the tables of its
+///          two children, where each pair is packed into a single 64-bit integer. The index of a state
+///          is its index in the table of the root. As states that are discovered after each other
+///          typically differ in only a few positions, most internal nodes are shared, and a state
+///          typically costs one entry in the root table plus a few entries in the other node tables.
+class tree_indexed_set
+{
+  public:
+    typedef std::size_t size_type;
+
+    /// \brief Value returned by index when an element does not exist in the set.
+    static constexpr size_type npos = std::numeric_limits<std::size_t>::max();
+
+  protected:
+    struct node_hash
+    {
+      std::size_t operator()(std::uint64_t x) const
+      {
+        // The multiplier is the 64-bit golden ratio, which spreads both halves over all bits.
+        x ^= x >> 32;
+        x *= 0x9E3779B97F4A7C15ULL;
+        return static_cast<std::size_t>(x ^ (x >> 29));
+      }
+    };
+
+    typedef atermpp::indexed_set<data::data_expression, atermpp::detail::GlobalThreadSafe> leaf_table;
+    typedef utilities::indexed_set<std::uint64_t, atermpp::detail::GlobalThreadSafe, node_hash> node_table;
+
+    // The children of an internal node. A child c < m_state_size is the leaf at position c,
+    // a child m_state_size + k is the internal node k, and the child m_state_size + m_layout.size()
+    // is a constant 0 that is used to pad the root if the states have less than two elements.
+    struct node_layout
+    {
+      std::size_t left;
+      std::size_t right;
+    };
+
+    std::size_t m_state_size;
+    std::vector<leaf_table> m_leaves;
+    std::vector<node_table> m_nodes;
+    std::vector<node_layout> m_layout; // The internal nodes in post order, so the root is the last one.
+
+    std::size_t make_layout(std::size_t first, std::size_t last)
+    {
+      if (last - first == 1)
+      {
+        return first;
+      }
+      std::size_t middle = first + (last - first) / 2;
+      std::size_t left = make_layout(first, middle);
+      std::size_t right = make_layout(middle, last);
+      m_layout.push_back({left, right});
+      return m_state_size + m_layout.size() - 1;
+    }
+
+    std::size_t padding() const
+    {
+      return m_state_size + m_layout.size();
+    }
+
+    static std::uint64_t make_node(std::size_t left, std::size_t right)
+    {
+      if (left > std::numeric_limits<std::uint32_t>::max() || right > std::numeric_limits<std::uint32_t>::max())
+      {
+        throw mcrl2::runtime_error("The tree compressed state storage cannot store more than 2^32 different subtrees per node.");
+      }
+      return (static_cast<std::uint64_t>(left) << 32) | static_cast<std::uint64_t>(right);
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param number_of_threads The number of threads that use this set, see utilities::indexed_set.
+    /// \param state_size The number of elements of the states that are stored in this set.
+    explicit tree_indexed_set(std::size_t number_of_threads = 1, std::size_t state_size = 0)
+      : m_state_size(state_size)
+    {
+      if (state_size >= 2)
+      {
+        make_layout(0, state_size);
+      }
+      else
+      {
+        m_layout.push_back({0, 0});
+        m_layout.back() = {state_size == 1 ? 0 : padding(), padding()};
+      }
+      m_leaves.reserve(state_size);
+      for (std::size_t i = 0; i < state_size; ++i)
+      {
+        m_leaves.emplace_back(number_of_threads);
+      }
+      m_nodes.reserve(m_layout.size());
+      for (std::size_t i = 0; i < m_layout.size(); ++i)
+      {
+        m_nodes.emplace_back(number_of_threads);
+      }
+    }
+
+    /// \brief Returns the index of the state s, or npos if s is not in the set.
+    size_type index(const state& s, std::size_t thread_index = 0) const
+    {
+      assert(s.size() == m_state_size);
+      MCRL2_DECLARE_STACK_ARRAY(indices, std::size_t, padding() + 1);
+      std::size_t i = 0;
+      for (const data::data_expression& d: s)
+      {
+        indices[i] = m_leaves[i].index(d, thread_index);
+        if (indices[i] == leaf_table::npos)
+        {
+          return npos;
+        }
+        ++i;
+      }
+      indices[padding()] = 0;
+      for (std::size_t k = 0; k < m_layout.size(); ++k)
+      {
+        indices[m_state_size + k] = m_nodes[k].index(make_node(indices[m_layout[k].left], indices[m_layout[k].right]), thread_index);
+        if (indices[m_state_size + k] == node_table::npos)
+        {
+          return npos;
+        }
+      }
+      return indices[padding() - 1];
+    }
+
+    /// \brief Inserts the state s, and returns its index and whether it was newly inserted.
+    std::pair<size_type, bool> insert(const state& s, std::size_t thread_index = 0)
+    {
+      assert(s.size() == m_state_size);
+      MCRL2_DECLARE_STACK_ARRAY(indices, std::size_t, padding() + 1);
+      std::size_t i = 0;
+      for (const data::data_expression& d: s)
+      {
+        indices[i] = m_leaves[i].insert(d, thread_index).first;
+        ++i;
+      }
+      indices[padding()] = 0;
+      std::pair<size_type, bool> result;
+      for (std::size_t k = 0; k < m_layout.size(); ++k)
+      {
+        result = m_nodes[k].insert(make_node(indices[m_layout[k].left], indices[m_layout[k].right]), thread_index);
+        indices[m_state_size + k] = result.first;
+      }
+      return result;
+    }
+
+    /// \brief Reconstructs the state with the given index.
+    state operator[](size_type index) const
+    {
+      std::vector<std::size_t> indices(padding() + 1);
+      indices[padding() - 1] = index;
+      for (std::size_t k = m_layout.size(); k-- > 0; )
+      {
+        std::uint64_t node = m_nodes[k][indices[m_state_size + k]];
+        indices[m_layout[k].left] = static_cast<std::size_t>(node >> 32);
+        indices[m_layout[k].right] = static_cast<std::size_t>(node & std::numeric_limits<std::uint32_t>::max());
+      }
+      std::vector<data::data_expression> values;
+      values.reserve(m_state_size);
+      for (std::size_t i = 0; i < m_state_size; ++i)
+      {
+        values.push_back(m_leaves[i][indices[i]]);
+      }
+      state result;
+      make_state(result, values.begin(), m_state_size);
+      return result;
+    }
+
+    /// \brief Returns the number of states in the set.
+    size_type size(std::size_t thread_index = 0) const
+    {
+      return m_nodes.back().size(thread_index);
+    }
+
+    /// \brief Removes all states from the set.
+    void clear(std::size_t thread_index = 0)
+    {
+      for (leaf_table& leaves: m_leaves)
+      {
+        leaves.clear(thread_index);
+      }
+      for (node_table& nodes: m_nodes)
+      {
+        nodes.clear(thread_index);
+      }
+    }
+};
+
+namespace detail {
+
+/// \brief The finalizer of splitmix64, which maps similar integers to very different ones.
+inline
+std::uint64_t mix_hash(std::uint64_t x)
+{
+  x ^= x >> 30;
+  x *= 0xBF58476D1CE4E5B9ULL;
+  x ^= x >> 27;
+  x *= 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+/// \brief A hash function on terms that only depends on the structure of the term.
+/// \details The standard hash function on terms uses the address of a term. This is not suitable
+///          if only the hash of a term is stored, as the term can be garbage collected and recreated
+///          at another address.
+inline
+std::uint64_t structural_hash(const atermpp::aterm& t)
+{
+  if (t.type_is_int())
+  {
+    return mix_hash(atermpp::down_cast<atermpp::aterm_int>(t).value());
+  }
+  const atermpp::aterm_appl& x = atermpp::down_cast<atermpp::aterm_appl>(t);
+  std::uint64_t result = mix_hash(std::hash<std::string>()(x.function().name()) + x.function().arity());
+  for (const atermpp::aterm& arg: x)
+  {
+    result = mix_hash(result ^ structural_hash(arg));
+  }
+  return result;
+}
+
+} // namespace detail
+
+/// \brief A set of states in which only a k-bit fingerprint of each state is stored (hash compaction).
+/// \details Two different states with the same fingerprint are considered to be equal, so the set may
+///          wrongly report that a state was already inserted. The indices of the states are consecutive,
+///          but states cannot be reconstructed from their index.
+class hash_compaction_set
+{
+  public:
+    typedef std::size_t size_type;
+    static constexpr size_type npos = std::numeric_limits<std::size_t>::max();
+
+  protected:
+    std::size_t m_fingerprint_bits;
+    utilities::indexed_set<std::uint64_t, atermpp::detail::GlobalThreadSafe> m_fingerprints;
+
+    std::uint64_t fingerprint(const state& s) const
+    {
+      std::uint64_t result = detail::structural_hash(s);
+      return m_fingerprint_bits >= 64 ? result : result & ((std::uint64_t(1) << m_fingerprint_bits) - 1);
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param number_of_threads The number of threads that use this set, see utilities::indexed_set.
+    /// \param fingerprint_bits The number of bits of a fingerprint, which must be between 1 and 64.
+    explicit hash_compaction_set(std::size_t number_of_threads = 1, std::size_t fingerprint_bits = 64)
+      : m_fingerprint_bits(fingerprint_bits),
+        m_fingerprints(number_of_threads)
+    {
+      if (fingerprint_bits == 0 || fingerprint_bits > 64)
+      {
+        throw mcrl2::runtime_error("The number of bits of a fingerprint must be between 1 and 64, and not " + std::to_string(fingerprint_bits) + ".");
+      }
+    }
+
+    size_type index(const state& s, std::size_t thread_index = 0) const
+    {
+      return m_fingerprints.index(fingerprint(s), thread_index);
+    }
+
+    std::pair<size_type, bool> insert(const state& s, std::size_t thread_index = 0)
+    {
+      return m_fingerprints.insert(fingerprint(s), thread_index);
+    }
+
+    size_type size(std::size_t thread_index = 0) const
+    {
+      return m_fingerprints.size(thread_index);
+    }
+
+    /// \brief Returns the expected number of states that were wrongly considered to be inserted
+    ///        already, because their fingerprint collided with that of another state.
+    /// \details For n states and k-bit fingerprints this is approximately n(n-1)/2^(k+1).
+    double expected_number_of_missed_states() const
+    {
+      double n = static_cast<double>(size());
+      return n * (n - 1) / std::ldexp(2.0, static_cast<int>(m_fingerprint_bits));
+    }
+
+    void clear(std::size_t thread_index = 0)
+    {
+      m_fingerprints.clear(thread_index);
+    }
+};
+
+/// \brief A set of states that is stored in a bit array, as in the bitstate hashing (supertrace)
+///        algorithm of Holzmann.
+/// \details A state is inserted by setting the bits at the positions given by a number of hash
+///          functions. A state is considered to be in the set if all these bits are set, so the set
+///          may wrongly report that a state was already inserted. States do not have an index.
+class bitstate_set
+{
+  public:
+    typedef std::size_t size_type;
+    static constexpr size_type npos = std::numeric_limits<std::size_t>::max();
+
+  protected:
+    std::vector<std::atomic<std::uint64_t>> m_words;
+    std::uint64_t m_mask;
+    std::size_t m_hash_functions;
+    std::atomic<std::size_t> m_size{0};
+    std::atomic<std::size_t> m_bits_set{0};
+    std::atomic<double> m_expected_missed{0.0};
+
+    // Calls f(word, bit) for all bit positions of the state s, using double hashing.
+    template <typename Function>
+    void for_each_position(const state& s, Function f) const
+    {
+      std::uint64_t h1 = detail::structural_hash(s);
+      std::uint64_t h2 = detail::mix_hash(h1) | 1;
+      for (std::size_t i = 0; i < m_hash_functions; ++i)
+      {
+        std::uint64_t position = (h1 + i * h2) & m_mask;
+        f(position >> 6, std::uint64_t(1) << (position & 63));
+      }
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param log2_size The two-logarithm of the number of bits in the array, which must be between 6 and 40.
+    /// \param hash_functions The number of bits that are set per state.
+    explicit bitstate_set(std::size_t log2_size = 6, std::size_t hash_functions = 3)
+      : m_words(std::size_t(1) << (log2_size < 6 ? 0 : log2_size - 6)),
+        m_mask((std::uint64_t(1) << log2_size) - 1),
+        m_hash_functions(hash_functions)
+    {
+      if (log2_size < 6 || log2_size > 40)
+      {
+        throw mcrl2::runtime_error("The two-logarithm of the size of the bit array must be between 6 and 40, and not " + std::to_string(log2_size) + ".");
+      }
+      if (hash_functions == 0)
+      {
+        throw mcrl2::runtime_error("The number of hash functions must be positive.");
+      }
+      clear();
+    }
+
+    /// \brief Returns true if s is in the set.
+    bool contains(const state& s) const
+    {
+      bool found = true;
+      for_each_position(s, [&](std::uint64_t word, std::uint64_t bit)
+        {
+          found = found && (m_words[word].load(std::memory_order_relaxed) & bit) != 0;
+        }
+      );
+      return found;
+    }
+
+    /// \brief Inserts the state s. If s is new, its sequence number is returned as index. Otherwise npos
+    ///        is returned, as states that are already in the set cannot be distinguished.
+    std::pair<size_type, bool> insert(const state& s, std::size_t /* thread_index */ = 0)
+    {
+      // The probability that a new state is wrongly reported to be in the set is roughly f^k, where
+      // f is the fraction of bits that is set, and k is the number of hash functions.
+      double f = static_cast<double>(m_bits_set.load(std::memory_order_relaxed)) / static_cast<double>(m_mask + 1);
+      bool is_new = false;
+      for_each_position(s, [&](std::uint64_t word, std::uint64_t bit)
+        {
+          if ((m_words[word].fetch_or(bit, std::memory_order_relaxed) & bit) == 0)
+          {
+            m_bits_set.fetch_add(1, std::memory_order_relaxed);
+            is_new = true;
+          }
+        }
+      );
+      if (!is_new)
+      {
+        return std::make_pair(npos, false);
+      }
+      double missed = m_expected_missed.load(std::memory_order_relaxed);
+      while (!m_expected_missed.compare_exchange_weak(missed, missed + std::pow(f, static_cast<double>(m_hash_functions)), std::memory_order_relaxed))
+      {}
+      return std::make_pair(m_size.fetch_add(1, std::memory_order_relaxed), true);
+    }
+
+    /// \brief Returns the number of states that were inserted.
+    size_type size(std::size_t /* thread_index */ = 0) const
+    {
+      return m_size.load(std::memory_order_relaxed);
+    }
+
+    /// \brief Returns the fraction of the bits that is set.
+    double fill_ratio() const
+    {
+      return static_cast<double>(m_bits_set.load(std::memory_order_relaxed)) / static_cast<double>(m_mask + 1);
+    }
+
+    /// \brief Returns the expected number of new states that were wrongly considered to be
+    ///        in the set, because all their bits were set by other states.
+    double expected_number_of_missed_states() const
+    {
+      return m_expected_missed.load(std::memory_order_relaxed);
+    }
+
+    void clear(std::size_t /* thread_index */ = 0)
+    {
+      for (std::atomic<std::uint64_t>& word: m_words)
+      {
+        word.store(0, std::memory_order_relaxed);
+      }
+      m_size = 0;
+      m_bits_set = 0;
+      m_expected_missed = 0.0;
+    }
+};
+
+/// \brief The way in which the discovered states are stored during state space exploration.
+enum class state_storage
+{
+  terms,           ///< Each state is stored as a balanced tree of terms.
+  tree,            ///< The states are stored in a tree_indexed_set.
+  hash_compaction, ///< Only a fingerprint of each state is stored in a hash_compaction_set.
+  bitstate,        ///< The states are stored in a bitstate_set.
+  disk             ///< The states are stored in an external_state_set.
+};
+
+/// \brief Returns true if states can wrongly be considered to be discovered when stored in this way.
+inline
+bool is_probabilistic(const state_storage s)
+{
+  return s == state_storage::hash_compaction || s == state_storage::bitstate;
+}
+
+inline
+state_storage parse_state_storage(const std::string& s)
+{
+  if (s == "terms")
+  {
+    return state_storage::terms;
+  }
+  if (s == "tree")
+  {
+    return state_storage::tree;
+  }
+  if (s == "hash-compaction")
+  {
+    return state_storage::hash_compaction;
+  }
+  if (s == "bitstate")
+  {
+    return state_storage::bitstate;
+  }
+  if (s == "disk")
+  {
+    return state_storage::disk;
+  }
+  throw mcrl2::runtime_error("unknown state storage " + s);
+}
+
+inline
+std::string print_state_storage(const state_storage s)
+{
+  switch (s)
+  {
+    case state_storage::terms: return "terms";
+    case state_storage::tree: return "tree";
+    case state_storage::hash_compaction: return "hash-compaction";
+    case state_storage::bitstate: return "bitstate";
+    case state_storage::disk: return "disk";
+    default: throw mcrl2::runtime_error("unknown state storage");
+  }
+}
+
+inline
+std::istream& operator>>(std::istream& is, state_storage& s)
+{
+  try
+  {
+    std::string text;
+    is >> text;
+    s = parse_state_storage(text);
+  }
+  catch (mcrl2::runtime_error&)
+  {
+    is.setstate(std::ios_base::failbit);
+  }
+  return is;
+}
+
+inline
+std::ostream& operator<<(std::ostream& os, const state_storage s)
+{
+  os << print_state_storage(s);
+  return os;
+}
+
+inline
+std::string description(const state_storage s)
+{
+  switch (s)
+  {
+    case state_storage::terms:
+      return "store each state as a balanced tree of terms";
+    case state_storage::tree:
+      return "store the states as a tree of hash-consed pairs of indices. This typically requires much less memory per state, at the expense of some speed";
+    case state_storage::hash_compaction:
+      return "only store a fingerprint of each state. States with the same fingerprint are considered equal, so part of the state space may be missed. No LTS can be generated";
+    case state_storage::bitstate:
+      return "only set a few bits per state in a bit array of a fixed size. States of which all bits are already set are considered to be discovered, so part of the state space may be missed. No LTS can be generated";
+    case state_storage::disk:
+      return "store the states on disk, and detect duplicate states per breadth-first level in batches. Only the values of the process parameters are kept in memory. This requires breadth-first search in a single thread";
+    default:
+      throw mcrl2::runtime_error("unknown state storage");
+  }
+}
+
+/// \brief An indexed set of states, that stores the states in the way indicated by a state_storage.
+class state_indexed_set
+{
+  public:
+    typedef std::size_t size_type;
+    static constexpr size_type npos = std::numeric_limits<std::size_t>::max();
+
+  protected:
+    state_storage m_storage;
+    atermpp::indexed_set<state, atermpp::detail::GlobalThreadSafe> m_states;
+    tree_indexed_set m_tree;
+    hash_compaction_set m_fingerprints;
+    bitstate_set m_bits;
+    std::unique_ptr<external_state_set> m_disk;
+
+    [[noreturn]] void unsupported(const std::string& operation) const
+    {
+      throw mcrl2::runtime_error("The operation " + operation + " is not supported for states that are stored using " + print_state_storage(m_storage) + ".");
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param number_of_threads The number of threads that use this set, see utilities::indexed_set.
+    /// \param storage The way in which the states are stored.
+    /// \param state_size The number of elements of the states. This is only needed for state_storage::tree.
+    /// \param fingerprint_bits The number of bits per fingerprint for state_storage::hash_compaction.
+    /// \param bitstate_bits The two-logarithm of the number of bits of the array for state_storage::bitstate.
+    /// \param bitstate_hash_functions The number of bits per state for state_storage::bitstate.
+    /// \param disk_directory The directory of the files for state_storage::disk. If it is empty, the
+    ///        default temporary directory is used.
+    explicit state_indexed_set(std::size_t number_of_threads = 1,
+                               state_storage storage = state_storage::terms,
+                               std::size_t state_size = 0,
+                               std::size_t fingerprint_bits = 64,
+                               std::size_t bitstate_bits = 30,
+                               std::size_t bitstate_hash_functions = 3,
+                               const std::string& disk_directory = ""
+                              )
+      : m_storage(storage),
+        m_states(number_of_threads),
+        m_tree(number_of_threads, storage == state_storage::tree ? state_size : 0),
+        m_fingerprints(number_of_threads, fingerprint_bits),
+        m_bits(storage == state_storage::bitstate ? bitstate_bits : 6, bitstate_hash_functions)
+    {
+      if (storage == state_storage::disk)
+      {
+        m_disk = std::make_unique<external_state_set>(disk_directory, state_size);
+      }
+    }
+
+    /// \brief Returns the set in which the states are stored for state_storage::disk.
+    /// \details States can only be added to this set in batches, see external_state_set.
+    external_state_set& disk()
+    {
+      assert(m_disk);
+      return *m_disk;
+    }
+
+    state_storage storage() const
+    {
+      return m_storage;
+    }
+
+    /// \brief Returns the index of the state s, or a value that is at least size() if s is not in the set.
+    /// \details For state_storage::bitstate the indices of states are not known, and npos is always returned.
+    size_type index(const state& s, std::size_t thread_index = 0) const
+    {
+      switch (m_storage)
+      {
+        case state_storage::tree: return m_tree.index(s, thread_index);
+        case state_storage::hash_compaction: return m_fingerprints.index(s, thread_index);
+        case state_storage::bitstate: return npos;
+        case state_storage::disk: unsupported("index");
+        default: return m_states.index(s, thread_index);
+      }
+    }
+
+    /// \brief Returns true if the state s is in the set.
+    bool contains(const state& s, std::size_t thread_index = 0) const
+    {
+      return m_storage == state_storage::bitstate ? m_bits.contains(s) : index(s, thread_index) != npos;
+    }
+
+    /// \brief Inserts the state s, and returns its index and whether it was newly inserted.
+    /// \details For state_storage::bitstate the returned index is npos if s was not newly inserted.
+    std::pair<size_type, bool> insert(const state& s, std::size_t thread_index = 0)
+    {
+      switch (m_storage)
+      {
+        case state_storage::tree: return m_tree.insert(s, thread_index);
+        case state_storage::hash_compaction: return m_fingerprints.insert(s, thread_index);
+        case state_storage::bitstate: return m_bits.insert(s, thread_index);
+        case state_storage::disk: unsupported("insert");
+        default: return m_states.insert(s, thread_index);
+      }
+    }
+
+    /// \brief Returns the state with the given index.
+    /// \details This is not supported if the storage is probabilistic.
+    state operator[](size_type index) const
+    {
+      switch (m_storage)
+      {
+        case state_storage::tree: return m_tree[index];
+        case state_storage::hash_compaction:
+        case state_storage::bitstate: unsupported("operator[]");
+        case state_storage::disk: return (*m_disk)[index];
+        default: return m_states[index];
+      }
+    }
+
+    size_type size(std::size_t thread_index = 0) const
+    {
+      switch (m_storage)
+      {
+        case state_storage::tree: return m_tree.size(thread_index);
+        case state_storage::hash_compaction: return m_fingerprints.size(thread_index);
+        case state_storage::bitstate: return m_bits.size(thread_index);
+        case state_storage::disk: return m_disk->size();
+        default: return m_states.size(thread_index);
+      }
+    }
+
+    /// \brief Returns an estimate of the number of states that were wrongly considered to be
+    ///        discovered already. This is 0 if the storage is not probabilistic.
+    double expected_number_of_missed_states() const
+    {
+      switch (m_storage)
+      {
+        case state_storage::hash_compaction: return m_fingerprints.expected_number_of_missed_states();
+        case state_storage::bitstate: return m_bits.expected_number_of_missed_states();
+        default: return 0.0;
+      }
+    }
+
+    /// \brief Returns the fraction of the bit array that is set for state_storage::bitstate.
+    double fill_ratio() const
+    {
+      return m_bits.fill_ratio();
+    }
+
+    void clear(std::size_t thread_index = 0)
+    {
+      m_states.clear(thread_index);
+      m_tree.clear(thread_index);
+      m_fingerprints.clear(thread_index);
+      m_bits.clear(thread_index);
+      if (m_disk)
+      {
+        m_disk->clear();
+      }
+    }
+};
+
+} // namespace mcrl2::lps
+
+#endif // MCRL2_LPS_STATE_INDEXED_SET_H
@@ -0,0 +1,272 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/stubborn_sets.h
+/// \brief Stubborn sets of summands, for partial order reduction during state space exploration.
+
+#ifndef MCRL2_LPS_STUBBORN_SETS_H
+#define MCRL2_LPS_STUBBORN_SETS_H
+
+#include <boost/dynamic_bitset.hpp>
+#include "mcrl2/lps/detail/read_write_parameters.h"
+#include "mcrl2/utilities/logger.h"
+#include "mcrl2/utilities/exception.h"
+
+namespace mcrl2::lps {
+
+/// \brief The kinds of partial order reduction that are supported by the explorer.
+enum class partial_order_reduction
+{
+  none,     ///< All transitions are explored.
+  deadlock, ///< The reduced state space has the same deadlocks.
+  stutter   ///< The reduced state space has the same deadlocks, and is stutter-trace equivalent for the visible actions.
+};
+
+inline
+partial_order_reduction parse_partial_order_reduction(const std::string& s)
+{
+  if (s == "none")
+  {
+    return partial_order_reduction::none;
+  }
+  if (s == "deadlock")
+  {
+    return partial_order_reduction::deadlock;
+  }
+  if (s == "stutter")
+  {
+    return partial_order_reduction::stutter;
+  }
+  throw mcrl2::runtime_error("unknown partial order reduction " + s);
+}
+
+inline
+std::string print_partial_order_reduction(const partial_order_reduction r)
+{
+  switch (r)
+  {
+    case partial_order_reduction::none: return "none";
+    case partial_order_reduction::deadlock: return "deadlock";
+    case partial_order_reduction::stutter: return "stutter";
+    default: throw mcrl2::runtime_error("unknown partial order reduction");
+  }
+}
+
+inline
+std::istream& operator>>(std::istream& is, partial_order_reduction& r)
+{
+  try
+  {
+    std::string text;
+    is >> text;
+    r = parse_partial_order_reduction(text);
+  }
+  catch (mcrl2::runtime_error&)
+  {
+    is.setstate(std::ios_base::failbit);
+  }
+  return is;
+}
+
+inline
+std::ostream& operator<<(std::ostream& os, const partial_order_reduction r)
+{
+  os << print_partial_order_reduction(r);
+  return os;
+}
+
+inline
+std::string description(const partial_order_reduction r)
+{
+  switch (r)
+  {
+    case partial_order_reduction::none:
+      return "explore all transitions";
+    case partial_order_reduction::deadlock:
+      return "explore the transitions of a stubborn set of summands in each state, which preserves the deadlocks";
+    case partial_order_reduction::stutter:
+      return "explore the transitions of a stubborn set of summands in each state, which preserves the deadlocks and "
+             "the traces of visible actions up to stuttering. The actions tau and those given by --tau are invisible";
+    default:
+      throw mcrl2::runtime_error("unknown partial order reduction");
+  }
+}
+
+/// \brief Computes stubborn sets of the summands of a linear process, based on the process parameters that
+///        are read and written by the summands.
+/// \details Two summands are dependent if one of them writes a parameter that the other one reads or writes.
+///          A summand that is disabled can only become enabled by a summand that writes a parameter that
+///          occurs in its condition. A stubborn set contains all summands that are dependent on an enabled
+///          summand in the set, and all summands that can enable a disabled summand in the set. Exploring only
+///          the enabled summands of a stubborn set preserves the deadlocks. For stutter-trace equivalence
+///          a stubborn set that contains an enabled visible summand moreover contains all visible summands;
+///          the cycle proviso that is needed as well is the responsibility of the caller.
+class stubborn_sets
+{
+  public:
+    typedef boost::dynamic_bitset<> summand_set;
+
+  protected:
+    std::size_t m_size; // The number of summands.
+    std::vector<summand_set> m_dependent; // m_dependent[i] contains the summands that are dependent on summand i.
+    std::vector<summand_set> m_enabling;  // m_enabling[i] contains the summands that may enable summand i.
+    summand_set m_visible;
+    bool m_stutter;
+
+    bool is_visible(const lps::multi_action& a, const std::set<core::identifier_string>& invisible_actions) const
+    {
+      for (const process::action& act: a.actions())
+      {
+        if (invisible_actions.find(act.label().name()) == invisible_actions.end())
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // Computes the stubborn set that contains the summand seed, and returns the enabled summands in it.
+    // The computation is cut short, returning an empty set, as soon as more than bound summands are enabled.
+    summand_set closure(std::size_t seed, const summand_set& enabled, std::size_t bound) const
+    {
+      summand_set result(m_size);
+      std::vector<std::size_t> todo{ seed };
+      result[seed] = true;
+      std::size_t enabled_count = 0;
+
+      auto add = [&](const summand_set& X)
+      {
+        for (std::size_t k = X.find_first(); k != summand_set::npos; k = X.find_next(k))
+        {
+          if (!result[k])
+          {
+            result[k] = true;
+            todo.push_back(k);
+          }
+        }
+      };
+
+      while (!todo.empty())
+      {
+        std::size_t k = todo.back();
+        todo.pop_back();
+        if (enabled[k])
+        {
+          if (++enabled_count > bound)
+          {
+            return summand_set(m_size);
+          }
+          add(m_dependent[k]);
+          if (m_stutter && m_visible[k])
+          {
+            add(m_visible);
+          }
+        }
+        else
+        {
+          add(m_enabling[k]);
+        }
+      }
+      return result & enabled;
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param process_parameters The process parameters of the linear process.
+    /// \param summands The action summands of the linear process.
+    /// \param reduction The kind of reduction, which must be deadlock or stutter.
+    /// \param invisible_actions The names of the actions that are invisible, in addition to tau.
+    template <typename ActionSummandSequence>
+    stubborn_sets(const data::variable_list& process_parameters,
+                  const ActionSummandSequence& summands,
+                  partial_order_reduction reduction,
+                  const std::set<core::identifier_string>& invisible_actions = {})
+      : m_size(summands.size()),
+        m_dependent(m_size, summand_set(m_size)),
+        m_enabling(m_size, summand_set(m_size)),
+        m_visible(m_size),
+        m_stutter(reduction == partial_order_reduction::stutter)
+    {
+      std::set<data::variable> parameters(process_parameters.begin(), process_parameters.end());
+      std::map<data::variable, std::size_t> index = detail::process_parameter_index(process_parameters);
+      std::size_t n = parameters.size();
+
+      auto to_bitset = [&](const std::set<data::variable>& V)
+      {
+        boost::dynamic_bitset<> result(n);
+        for (const data::variable& v: V)
+        {
+          result[index[v]] = true;
+        }
+        return result;
+      };
+
+      std::vector<boost::dynamic_bitset<>> read;
+      std::vector<boost::dynamic_bitset<>> write;
+      std::vector<boost::dynamic_bitset<>> guard;
+      for (const auto& summand: summands)
+      {
+        auto [read_parameters, write_parameters] = detail::read_write_parameters(summand, parameters);
+        read.push_back(to_bitset(read_parameters));
+        write.push_back(to_bitset(write_parameters));
+        guard.push_back(to_bitset(utilities::detail::set_intersection(data::find_free_variables(summand.condition()), parameters)));
+        m_visible[read.size() - 1] = is_visible(summand.multi_action(), invisible_actions);
+      }
+
+      for (std::size_t i = 0; i < m_size; i++)
+      {
+        for (std::size_t j = 0; j < m_size; j++)
+        {
+          if (i != j && (write[i].intersects(read[j]) || write[i].intersects(write[j]) || write[j].intersects(read[i])))
+          {
+            m_dependent[i][j] = true;
+          }
+          if (write[j].intersects(guard[i]))
+          {
+            m_enabling[i][j] = true;
+          }
+        }
+        mCRL2log(log::debug) << "summand " << i << ": dependent = " << m_dependent[i] << ", enabling = " << m_enabling[i]
+                             << (m_visible[i] ? ", visible" : "") << std::endl;
+      }
+    }
+
+    /// \brief Returns the number of summands.
+    std::size_t size() const
+    {
+      return m_size;
+    }
+
+    bool is_visible(std::size_t i) const
+    {
+      return m_visible[i];
+    }
+
+    /// \brief Returns the enabled summands of a stubborn set with the least number of enabled summands,
+    ///        among the stubborn sets that are generated by a single enabled summand.
+    /// \param enabled The summands that are enabled in the current state.
+    summand_set compute(const summand_set& enabled) const
+    {
+      summand_set result = enabled;
+      std::size_t result_count = enabled.count();
+      for (std::size_t k = enabled.find_first(); k != summand_set::npos && result_count > 1; k = enabled.find_next(k))
+      {
+        summand_set T = closure(k, enabled, result_count - 1);
+        if (T.any())
+        {
+          result = T;
+          result_count = T.count();
+        }
+      }
+      return result;
+    }
+};
+
+} // namespace mcrl2::lps
+
+#endif // MCRL2_LPS_STUBBORN_SETS_H
@@ -0,0 +1,343 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/summand_cache.h
+/// \brief A bounded cache for the solutions of the conditions of summands, used by the explorer.
+
+#ifndef MCRL2_LPS_SUMMAND_CACHE_H
+#define MCRL2_LPS_SUMMAND_CACHE_H
+
+#include <limits>
+#include <memory>
+#include <mutex>
+#include "mcrl2/atermpp/standard_containers/detail/unordered_map_implementation.h"
+#include "mcrl2/atermpp/standard_containers/vector.h"
+#include "mcrl2/data/substitutions/mutable_indexed_substitution.h"
+
+namespace mcrl2::lps {
+
+namespace detail
+{
+// The functions below are used to support the key type in caches.
+//
+struct cheap_cache_key
+{
+  data::mutable_indexed_substitution<>& m_sigma;
+  const std::vector<data::variable>& m_gamma;
+  const data::data_expression* m_condition; // If not nullptr, this is the first element of the key (for the global cache).
+
+  cheap_cache_key(data::mutable_indexed_substitution<>& sigma, const std::vector<data::variable>& gamma, const data::data_expression* condition = nullptr)
+    : m_sigma(sigma),
+      m_gamma(gamma),
+      m_condition(condition)
+  {}
+
+  // Applies f to the elements of the key.
+  template <typename Function>
+  void for_each(Function f) const
+  {
+    auto i = m_gamma.begin();
+    if (m_condition != nullptr)
+    {
+      f(*m_condition);
+      ++i;
+    }
+    for (; i != m_gamma.end(); ++i)
+    {
+      f(m_sigma(*i));
+    }
+  }
+};
+
+struct cache_equality
+{
+  bool operator()(const atermpp::term_appl<data::data_expression>& key1, const atermpp::term_appl<data::data_expression>& key2) const
+  {
+    return key1==key2;
+  }
+
+  bool operator()(const atermpp::term_appl<data::data_expression>& key1, const cheap_cache_key& key2) const
+  {
+    bool result = true;
+    auto i = key1.begin();
+    key2.for_each([&](const data::data_expression& d)
+      {
+        result = result && *i++ == d;
+      }
+    );
+    return result;
+  }
+};
+
+struct cache_hash
+{
+  template <typename T>
+  std::size_t operator()(const std::pair<const atermpp::term_appl<mcrl2::data::data_expression>, T>& pair) const
+  {
+    return operator()(pair.first);
+  }
+
+  std::size_t operator()(const atermpp::term_appl<data::data_expression>& key) const
+  {
+    std::size_t hash=0;
+    for(const data::data_expression& d: key)
+    {
+      hash=atermpp::detail::combine(hash,d);
+    }
+    return hash;
+  }
+
+  std::size_t operator()(const cheap_cache_key& key) const
+  {
+    std::size_t hash=0;
+    key.for_each([&](const data::data_expression& d)
+      {
+        hash=atermpp::detail::combine(hash,d);
+      }
+    );
+    return hash;
+  }
+};
+
+} // end namespace detail
+
+/// \brief The number of hits, misses and evictions of a summand_cache.
+struct summand_cache_statistics
+{
+  std::size_t hits = 0;
+  std::size_t misses = 0;
+  std::size_t evictions = 0;
+
+  summand_cache_statistics& operator+=(const summand_cache_statistics& other)
+  {
+    hits += other.hits;
+    misses += other.misses;
+    evictions += other.evictions;
+    return *this;
+  }
+};
+
+/// \brief A cache that maps the values of the parameters that occur in the condition of a summand to the
+///        solutions of the condition, with a bounded size.
+/// \details The cache is split in shards, each with its own lock, such that it can be used by several
+///          threads. When a shard exceeds its part of the memory budget, entries are evicted using the
+///          CLOCK policy: the keys of a shard form a ring, in which a key is marked when it is found. The
+///          clock hand moves over the ring, unmarks the marked keys and evicts the first unmarked key.
+///          The memory use of an entry is estimated from the sizes of its key and its list of solutions;
+///          the data expressions themselves are not counted, as they are typically shared with the states.
+///          The lock of a shard is always taken inside a shared section of the term pool, such that garbage
+///          collection cannot start while a thread waits for a shard.
+class summand_cache
+{
+  public:
+    typedef atermpp::term_appl<data::data_expression> key_type;
+    typedef atermpp::term_list<data::data_expression_list> solutions_type;
+
+  protected:
+    // The solutions of a key, and the position of the key in the ring of its shard.
+    typedef std::pair<solutions_type, std::size_t> entry_type;
+
+    typedef atermpp::utilities::unordered_map<key_type,
+                                              entry_type,
+                                              detail::cache_hash,
+                                              detail::cache_equality,
+                                              std::allocator<std::pair<const key_type, entry_type>>,
+                                              true  // Thread_safe.
+                                             > map_type;
+
+    enum class slot_state: std::uint8_t { empty, unmarked, marked };
+
+    struct shard
+    {
+      std::mutex mutex;
+      map_type map;
+      atermpp::vector<key_type> ring;
+      std::vector<slot_state> states;
+      std::vector<std::size_t> free_slots;
+      std::size_t hand = 0;
+      std::size_t bytes = 0;
+      summand_cache_statistics statistics;
+    };
+
+    std::size_t m_shard_budget; // The number of bytes that the entries of a shard may use.
+    std::vector<std::unique_ptr<shard>> m_shards;
+
+    static std::size_t estimated_size(const key_type& key, const solutions_type& solutions)
+    {
+      constexpr std::size_t entry_overhead = 64; // The node in the map and the slot in the ring.
+      constexpr std::size_t list_node_size = 3 * sizeof(std::size_t);
+      std::size_t result = entry_overhead + (key.size() + 2) * sizeof(std::size_t);
+      for (const data::data_expression_list& solution: solutions)
+      {
+        result += (solution.size() + 1) * list_node_size;
+      }
+      return result;
+    }
+
+    template <typename Key>
+    shard& shard_of(const Key& key) const
+    {
+      return *m_shards[detail::cache_hash()(key) % m_shards.size()];
+    }
+
+    // Evicts the entry in slot i of the shard s.
+    void evict(shard& s, std::size_t i)
+    {
+      auto q = s.map.find(s.ring[i]);
+      assert(q != s.map.end());
+      s.bytes -= estimated_size(s.ring[i], static_cast<const solutions_type&>(q->second.first));
+      s.map.erase(q);
+      s.states[i] = slot_state::empty;
+      s.free_slots.push_back(i);
+      s.statistics.evictions++;
+    }
+
+    // Evicts entries of the shard s until an entry of the given size fits in the budget.
+    void make_room(shard& s, std::size_t size)
+    {
+      while (s.bytes + size > m_shard_budget && !s.map.empty())
+      {
+        if (s.hand >= s.ring.size())
+        {
+          s.hand = 0;
+        }
+        switch (s.states[s.hand])
+        {
+          case slot_state::marked: s.states[s.hand] = slot_state::unmarked; break;
+          case slot_state::unmarked: evict(s, s.hand); break;
+          default: break;
+        }
+        s.hand++;
+      }
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param memory_budget The number of bytes that the entries may use, or 0 if the size is unbounded.
+    /// \param number_of_shards The number of independently locked parts of the cache.
+    explicit summand_cache(std::size_t memory_budget = 0, std::size_t number_of_shards = 1)
+      : m_shard_budget(memory_budget == 0 ? std::numeric_limits<std::size_t>::max() : memory_budget / std::max<std::size_t>(1, number_of_shards))
+    {
+      for (std::size_t i = 0; i < std::max<std::size_t>(1, number_of_shards); i++)
+      {
+        m_shards.push_back(std::make_unique<shard>());
+      }
+    }
+
+    /// \brief Copy constructor. The copy has the same memory budget and number of shards, but it is empty.
+    summand_cache(const summand_cache& other)
+      : m_shard_budget(other.m_shard_budget)
+    {
+      for (std::size_t i = 0; i < other.m_shards.size(); i++)
+      {
+        m_shards.push_back(std::make_unique<shard>());
+      }
+    }
+
+    summand_cache(summand_cache&& other) = default;
+
+    summand_cache& operator=(const summand_cache& other)
+    {
+      *this = summand_cache(other);
+      return *this;
+    }
+
+    summand_cache& operator=(summand_cache&& other) = default;
+
+    /// \brief Looks up the solutions of the key that is formed by the values of the substitution.
+    /// \return True if the key is in the cache, in which case its solutions are assigned to result.
+    bool find(const detail::cheap_cache_key& key, solutions_type& result)
+    {
+      shard& s = shard_of(key);
+      atermpp::detail::shared_guard shared;
+      std::lock_guard<std::mutex> guard(s.mutex);
+      auto q = s.map.find(key);
+      if (q == s.map.end())
+      {
+        s.statistics.misses++;
+        return false;
+      }
+      s.statistics.hits++;
+      result = q->second.first;
+      s.states[static_cast<std::size_t>(q->second.second)] = slot_state::marked;
+      return true;
+    }
+
+    /// \brief Adds a key with its solutions to the cache, evicting other entries if needed.
+    void insert(const key_type& key, const solutions_type& solutions)
+    {
+      shard& s = shard_of(key);
+      std::size_t size = estimated_size(key, solutions);
+      atermpp::detail::shared_guard shared;
+      std::lock_guard<std::mutex> guard(s.mutex);
+      if (size > m_shard_budget || s.map.find(key) != s.map.end())
+      {
+        return;
+      }
+      make_room(s, size);
+      std::size_t i;
+      if (s.free_slots.empty())
+      {
+        i = s.ring.size();
+        s.ring.push_back(key);
+        s.states.push_back(slot_state::unmarked);
+      }
+      else
+      {
+        i = s.free_slots.back();
+        s.free_slots.pop_back();
+        s.ring[i] = key;
+        s.states[i] = slot_state::unmarked;
+      }
+      s.map.insert(std::make_pair(key, entry_type(solutions, i)));
+      s.bytes += size;
+    }
+
+    /// \brief Returns the number of entries.
+    std::size_t size() const
+    {
+      std::size_t result = 0;
+      for (const std::unique_ptr<shard>& s: m_shards)
+      {
+        std::lock_guard<std::mutex> guard(s->mutex);
+        result += s->map.size();
+      }
+      return result;
+    }
+
+    summand_cache_statistics statistics() const
+    {
+      summand_cache_statistics result;
+      for (const std::unique_ptr<shard>& s: m_shards)
+      {
+        std::lock_guard<std::mutex> guard(s->mutex);
+        result += s->statistics;
+      }
+      return result;
+    }
+
+    void clear()
+    {
+      atermpp::detail::shared_guard shared;
+      for (const std::unique_ptr<shard>& s: m_shards)
+      {
+        std::lock_guard<std::mutex> guard(s->mutex);
+        s->map.clear();
+        s->ring.clear();
+        s->states.clear();
+        s->free_slots.clear();
+        s->hand = 0;
+        s->bytes = 0;
+        s->statistics = summand_cache_statistics();
+      }
+    }
+};
+
+} // namespace mcrl2::lps
+
+#endif // MCRL2_LPS_SUMMAND_CACHE_H
@@ -222,7 +222,7 @@ void lpsrewr(const std::string& input_filename,
     case simplify:
     {
       mcrl2::data::rewriter R(spec.data(), rewrite_strategy);
-      lps::rewrite(spec, R);
+      lps::memoising_rewrite(spec, R);
       break;
     }
     case quantifier_one_point:
@@ -0,0 +1,110 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file external_state_set_test.cpp
+/// \brief Tests for sorting in external memory, and for the external state set.
+
+#define BOOST_TEST_MODULE external_state_set_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <random>
+#include "mcrl2/data/standard_numbers_utility.h"
+#include "mcrl2/lps/external_state_set.h"
+
+using namespace mcrl2;
+using namespace mcrl2::lps;
+
+BOOST_AUTO_TEST_CASE(test_external_sorter)
+{
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<detail::record_word> distribution(0, 100);
+
+  // A budget of 1000 bytes forces the sorter to write many runs to disk.
+  for (std::size_t memory_budget: { 1000, 1 << 20 })
+  {
+    detail::external_sorter sorter("", 3, 2, memory_budget);
+    std::vector<std::vector<detail::record_word>> records;
+    for (std::size_t i = 0; i < 5000; ++i)
+    {
+      records.push_back({ distribution(generator), distribution(generator), i });
+      sorter.push(records.back().data());
+    }
+    sorter.sort();
+    std::stable_sort(records.begin(), records.end(), [](const auto& x, const auto& y) { return detail::record_less(x.data(), y.data(), 2); });
+
+    std::size_t count = 0;
+    const detail::record_word* previous = nullptr;
+    std::vector<detail::record_word> previous_record(3);
+    while (const detail::record_word* r = sorter.next())
+    {
+      BOOST_CHECK_EQUAL(r[0], records[count][0]);
+      BOOST_CHECK_EQUAL(r[1], records[count][1]);
+      if (previous != nullptr)
+      {
+        BOOST_CHECK(!detail::record_less(r, previous_record.data(), 2));
+      }
+      std::copy(r, r + 3, previous_record.begin());
+      previous = previous_record.data();
+      ++count;
+    }
+    BOOST_CHECK_EQUAL(count, records.size());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_external_state_set)
+{
+  external_state_set states("", 2);
+  std::vector<state> inserted;
+
+  // Insert the states (i, j) with i + j = k in batch k, and each of the states of the previous batch again.
+  for (std::size_t k = 0; k < 20; ++k)
+  {
+    std::vector<std::vector<detail::record_word>> records;
+    for (std::size_t i = 0; i <= k; ++i)
+    {
+      state s;
+      std::vector<data::data_expression> values{ data::sort_nat::nat(std::to_string(i)), data::sort_nat::nat(std::to_string(k - i)) };
+      make_state(s, values.begin(), 2);
+      records.emplace_back(states.record_width());
+      states.encode(s, records.back().data());
+    }
+    std::size_t previous_size = inserted.size();
+    for (std::size_t i = previous_size - std::min(previous_size, k); i < previous_size; ++i)
+    {
+      records.emplace_back(states.record_width());
+      states.encode(inserted[i], records.back().data());
+    }
+    std::sort(records.begin(), records.end());
+
+    states.start_batch();
+    std::size_t new_states = 0;
+    for (const std::vector<detail::record_word>& r: records)
+    {
+      std::pair<std::size_t, bool> p = states.insert_sorted(r.data());
+      if (p.second)
+      {
+        BOOST_CHECK_EQUAL(p.first, inserted.size());
+        inserted.push_back(states.decode(r.data()));
+        ++new_states;
+      }
+      else
+      {
+        BOOST_CHECK(p.first < inserted.size());
+        BOOST_CHECK(inserted[p.first] == states.decode(r.data()));
+      }
+    }
+    states.end_batch();
+    BOOST_CHECK_EQUAL(new_states, k + 1);
+  }
+
+  BOOST_CHECK_EQUAL(states.size(), inserted.size());
+  for (std::size_t i = 0; i < inserted.size(); ++i)
+  {
+    BOOST_CHECK(states[i] == inserted[i]);
+  }
+}
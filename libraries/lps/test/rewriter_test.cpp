@@ -185,6 +185,11 @@ void test_lps_rewriter()
     "init P(true, false);                                                \n";
 
   test_lps_rewriter(src, dest, "");
+
+  lps::specification spec = parse_linear_process_specification(src);
+  data::rewriter R(spec.data());
+  lps::memoising_rewrite(spec, R);
+  BOOST_CHECK(spec == parse_linear_process_specification(dest));
 }
 
 void test_one_point_rule_rewriter()
@@ -0,0 +1,124 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file summand_cache_test.cpp
+/// \brief Tests for the bounded caches of the summands that are used by the explorer.
+
+#define BOOST_TEST_MODULE summand_cache_test
+#include <boost/test/included/unit_test.hpp>
+
+#include "mcrl2/data/standard_numbers_utility.h"
+#include "mcrl2/lps/summand_cache.h"
+
+using namespace mcrl2;
+using namespace mcrl2::lps;
+
+// Returns the key @gamma(n, n + 1), and assigns the same values to the variables in gamma.
+static summand_cache::key_type make_key(std::size_t n, data::mutable_indexed_substitution<>& sigma, const std::vector<data::variable>& gamma)
+{
+  atermpp::function_symbol f_gamma("@gamma", 2);
+  std::vector<data::data_expression> values = { data::sort_nat::nat(n), data::sort_nat::nat(n + 1) };
+  sigma[gamma[0]] = values[0];
+  sigma[gamma[1]] = values[1];
+  return summand_cache::key_type(f_gamma, values.begin(), values.end());
+}
+
+static summand_cache::solutions_type make_solutions(std::size_t n)
+{
+  summand_cache::solutions_type result;
+  result.push_front(data::data_expression_list({ data::sort_nat::nat(n) }));
+  return result;
+}
+
+BOOST_AUTO_TEST_CASE(test_unbounded)
+{
+  std::vector<data::variable> gamma = { data::variable("x", data::sort_nat::nat()), data::variable("y", data::sort_nat::nat()) };
+  data::mutable_indexed_substitution<> sigma;
+  summand_cache cache;
+
+  for (std::size_t n = 0; n < 100; n++)
+  {
+    summand_cache::key_type key = make_key(n, sigma, gamma);
+    summand_cache::solutions_type solutions;
+    BOOST_CHECK(!cache.find(detail::cheap_cache_key(sigma, gamma), solutions));
+    cache.insert(key, make_solutions(n));
+    BOOST_CHECK(cache.find(detail::cheap_cache_key(sigma, gamma), solutions));
+    BOOST_CHECK_EQUAL(solutions, make_solutions(n));
+  }
+  BOOST_CHECK_EQUAL(cache.size(), 100u);
+  BOOST_CHECK_EQUAL(cache.statistics().hits, 100u);
+  BOOST_CHECK_EQUAL(cache.statistics().misses, 100u);
+  BOOST_CHECK_EQUAL(cache.statistics().evictions, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_bounded)
+{
+  std::vector<data::variable> gamma = { data::variable("x", data::sort_nat::nat()), data::variable("y", data::sort_nat::nat()) };
+  data::mutable_indexed_substitution<> sigma;
+
+  for (std::size_t number_of_shards: { 1, 4 })
+  {
+    // A budget that is sufficient for a few entries per shard.
+    summand_cache cache(2000, number_of_shards);
+    for (std::size_t n = 0; n < 1000; n++)
+    {
+      cache.insert(make_key(n, sigma, gamma), make_solutions(n));
+    }
+    BOOST_CHECK(cache.size() > 0);
+    BOOST_CHECK(cache.size() < 100);
+    BOOST_CHECK_EQUAL(cache.size() + cache.statistics().evictions, 1000u);
+
+    // The entries that remain in the cache have the right solutions.
+    for (std::size_t n = 0; n < 1000; n++)
+    {
+      make_key(n, sigma, gamma);
+      summand_cache::solutions_type solutions;
+      if (cache.find(detail::cheap_cache_key(sigma, gamma), solutions))
+      {
+        BOOST_CHECK_EQUAL(solutions, make_solutions(n));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_clock_policy)
+{
+  std::vector<data::variable> gamma = { data::variable("x", data::sort_nat::nat()), data::variable("y", data::sort_nat::nat()) };
+  data::mutable_indexed_substitution<> sigma;
+  summand_cache cache(2000);
+
+  // An entry that is found between each two insertions is never evicted.
+  summand_cache::key_type hot_key = make_key(0, sigma, gamma);
+  cache.insert(hot_key, make_solutions(0));
+  for (std::size_t n = 1; n < 1000; n++)
+  {
+    make_key(0, sigma, gamma);
+    summand_cache::solutions_type solutions;
+    BOOST_CHECK(cache.find(detail::cheap_cache_key(sigma, gamma), solutions));
+    cache.insert(make_key(n, sigma, gamma), make_solutions(n));
+  }
+  BOOST_CHECK(cache.statistics().evictions > 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_condition_in_key)
+{
+  // In the global cache the condition of the summand is the first element of the key.
+  data::variable x("x", data::sort_nat::nat());
+  std::vector<data::variable> gamma = { data::variable(), x };
+  data::data_expression condition = data::less(x, data::sort_nat::nat(10));
+  data::mutable_indexed_substitution<> sigma;
+  sigma[x] = data::sort_nat::nat(3);
+  summand_cache cache;
+
+  std::vector<data::data_expression> values = { condition, data::sort_nat::nat(3) };
+  cache.insert(summand_cache::key_type(atermpp::function_symbol("@gamma", 2), values.begin(), values.end()), make_solutions(3));
+  summand_cache::solutions_type solutions;
+  BOOST_CHECK(cache.find(detail::cheap_cache_key(sigma, gamma, &condition), solutions));
+  data::data_expression other_condition = data::less(x, data::sort_nat::nat(20));
+  BOOST_CHECK(!cache.find(detail::cheap_cache_key(sigma, gamma, &other_condition), solutions));
+}
@@ -12,6 +12,8 @@
 #ifndef MCRL2_LTS_BUILDER_H
 #define MCRL2_LTS_BUILDER_H
 
+#include <filesystem>
+#include <mutex>
 #include "mcrl2/lps/explorer.h"
 #include "mcrl2/lts/detail/lts_convert.h"
 #include "mcrl2/lts/lts_io.h"
@@ -27,9 +29,62 @@ lps::state remove_time_stamp(const lps::state& s)
   return lps::state(s.begin(), s.size() - 1);
 }
 
+namespace detail {
+
+/// \brief A buffer per thread, for the transitions that are added to an LTS builder by several threads.
+/// \details The buffers are created when they are first used. Thread indices start at 1 in a parallel
+///          exploration, so number_of_threads + 1 buffers are created.
+template <typename Buffer>
+class thread_buffers
+{
+  protected:
+    std::once_flag m_created;
+    std::vector<Buffer> m_buffers;
+
+  public:
+    Buffer& operator()(std::size_t thread_index, std::size_t number_of_threads)
+    {
+      std::call_once(m_created, [&]() { m_buffers.resize(number_of_threads + 1); });
+      assert(thread_index < m_buffers.size());
+      return m_buffers[thread_index];
+    }
+
+    /// \brief Returns the buffers, which is only safe if no thread is adding transitions.
+    std::vector<Buffer>& buffers()
+    {
+      return m_buffers;
+    }
+};
+
+/// \brief The transitions of a thread that have not yet been added to the LTS. The labels of the transitions
+///        are local to the thread, such that the shared mapping from actions to labels is only consulted
+///        once per action when the buffer is flushed.
+struct alignas(64) transition_buffer
+{
+  static constexpr std::size_t capacity = 1024;
+
+  std::vector<transition> transitions;
+  std::unordered_map<lps::multi_action, std::size_t> labels;
+  std::vector<lps::multi_action> actions;   // actions[i] is the action with local label i
+  std::vector<std::size_t> global_labels;   // global_labels[i] is the label in the LTS of local label i
+
+  void add(std::size_t from, const lps::multi_action& a, std::size_t to)
+  {
+    auto i = labels.find(a);
+    if (i == labels.end())
+    {
+      i = labels.emplace(a, actions.size()).first;
+      actions.push_back(a);
+    }
+    transitions.emplace_back(from, i->second, to);
+  }
+};
+
+} // namespace detail
+
 struct lts_builder
 {
-  typedef atermpp::indexed_set<lps::state, atermpp::detail::GlobalThreadSafe> indexed_set_for_states_type;
+  typedef lps::state_indexed_set indexed_set_for_states_type;
   // All LTS classes use integers to represent actions in transitions. A mapping from actions to integers
   // is needed to avoid duplicates.
   utilities::unordered_map_large<lps::multi_action, std::size_t> m_actions;
@@ -51,8 +106,8 @@ struct lts_builder
     return i->second;
   }
 
-  // Add a transition to the LTS
-  virtual void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads = 0) = 0;
+  // Add a transition to the LTS. If there are several threads, each thread must pass its own thread_index.
+  virtual void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads = 0, const std::size_t thread_index = 0) = 0;
 
   // Add actions and states to the LTS
   virtual void finalize(const indexed_set_for_states_type& state_map, bool timed) = 0;
@@ -60,13 +115,155 @@ struct lts_builder
   // Save the LTS to a file
   virtual void save(const std::string& filename) = 0;
 
+  // Write the partial LTS to a checkpoint, see lps::explorer::save_checkpoint
+  virtual void save_checkpoint(atermpp::aterm_ostream& /* stream */)
+  {
+    throw mcrl2::runtime_error("Checkpoints are not supported for this output format.");
+  }
+
+  // Read the partial LTS from a checkpoint that was written by save_checkpoint
+  virtual void load_checkpoint(atermpp::aterm_istream& /* stream */)
+  {
+    throw mcrl2::runtime_error("Checkpoints are not supported for this output format.");
+  }
+
   virtual ~lts_builder() = default;
+
+  protected:
+    std::mutex m_exclusive_transition_access;
+    detail::thread_buffers<detail::transition_buffer> m_transition_buffers;
+
+    // Adds the transitions in buffer to lts. The caller must have exclusive access to lts and m_actions.
+    template <typename LTS>
+    void flush(detail::transition_buffer& buffer, LTS& lts)
+    {
+      for (std::size_t i = buffer.global_labels.size(); i < buffer.actions.size(); ++i)
+      {
+        buffer.global_labels.push_back(add_action(buffer.actions[i]));
+      }
+      for (const transition& t: buffer.transitions)
+      {
+        lts.add_transition(transition(t.from(), buffer.global_labels[t.label()], t.to()));
+      }
+      buffer.transitions.clear();
+    }
+
+    // Adds a transition to the buffer of the thread, and adds the buffer to lts when it is full.
+    template <typename LTS>
+    void buffer_transition(std::size_t from, const lps::multi_action& a, std::size_t to, std::size_t number_of_threads, std::size_t thread_index, LTS& lts)
+    {
+      detail::transition_buffer& buffer = m_transition_buffers(thread_index, number_of_threads);
+      buffer.add(from, a, to);
+      if (buffer.transitions.size() >= detail::transition_buffer::capacity)
+      {
+        std::lock_guard<std::mutex> guard(m_exclusive_transition_access);
+        flush(buffer, lts);
+      }
+    }
+
+    // Adds the transitions in all buffers to lts. In a parallel exploration the labels are assigned in the
+    // order in which the threads happen to flush their buffers. To make the result independent of this order,
+    // the labels are renumbered in the order of the printed actions, with tau remaining label 0, and the
+    // transitions are sorted.
+    template <typename LTS>
+    void flush_transition_buffers(LTS& lts)
+    {
+      std::vector<detail::transition_buffer>& buffers = m_transition_buffers.buffers();
+      if (buffers.empty())
+      {
+        return;
+      }
+      for (detail::transition_buffer& buffer: buffers)
+      {
+        flush(buffer, lts);
+        buffer.labels.clear();
+        buffer.actions.clear();
+        buffer.global_labels.clear();
+      }
+
+      std::vector<std::pair<std::string, std::size_t>> printed_actions;
+      for (const auto& p: m_actions)
+      {
+        if (p.second != 0)
+        {
+          printed_actions.emplace_back(lps::pp(p.first), p.second);
+        }
+      }
+      std::sort(printed_actions.begin(), printed_actions.end());
+      std::vector<std::size_t> new_label(m_actions.size(), 0);
+      for (std::size_t i = 0; i < printed_actions.size(); ++i)
+      {
+        new_label[printed_actions[i].second] = i + 1;
+      }
+      for (auto& p: m_actions)
+      {
+        p.second = new_label[p.second];
+      }
+      std::vector<transition>& transitions = lts.get_transitions();
+      for (transition& t: transitions)
+      {
+        t.set_label(new_label[t.label()]);
+      }
+      std::sort(transitions.begin(), transitions.end(), [](const transition& t1, const transition& t2)
+        {
+          return std::make_tuple(t1.from(), t1.label(), t1.to()) < std::make_tuple(t2.from(), t2.label(), t2.to());
+        }
+      );
+    }
+
+    void save_actions(atermpp::aterm_ostream& stream) const
+    {
+      stream << atermpp::aterm_int(m_actions.size());
+      for (const auto& p: m_actions)
+      {
+        stream << p.first.actions() << p.first.time() << atermpp::aterm_int(p.second);
+      }
+    }
+
+    void load_actions(atermpp::aterm_istream& stream)
+    {
+      m_actions.clear();
+      atermpp::aterm_int n;
+      stream >> n;
+      for (std::size_t i = 0; i < n.value(); ++i)
+      {
+        process::action_list actions;
+        data::data_expression time;
+        atermpp::aterm_int index;
+        stream >> actions >> time >> index;
+        m_actions.emplace(std::make_pair(lps::multi_action(actions, time), index.value()));
+      }
+    }
+
+    template <typename LTS>
+    static void save_transitions(atermpp::aterm_ostream& stream, const LTS& lts)
+    {
+      stream << atermpp::aterm_int(lts.num_transitions());
+      for (const transition& t: lts.get_transitions())
+      {
+        stream << atermpp::aterm_int(t.from()) << atermpp::aterm_int(t.label()) << atermpp::aterm_int(t.to());
+      }
+    }
+
+    template <typename LTS>
+    static void load_transitions(atermpp::aterm_istream& stream, LTS& lts)
+    {
+      lts.clear_transitions();
+      atermpp::aterm_int n;
+      stream >> n;
+      for (std::size_t i = 0; i < n.value(); ++i)
+      {
+        atermpp::aterm_int from, label, to;
+        stream >> from >> label >> to;
+        lts.add_transition(transition(from.value(), label.value(), to.value()));
+      }
+    }
 };
 
 class lts_none_builder: public lts_builder
 {
   public:
-    void add_transition(std::size_t /* from */, const lps::multi_action& /* a */, std::size_t /* to */, const std::size_t /* number_of_threads */) override
+    void add_transition(std::size_t /* from */, const lps::multi_action& /* a */, std::size_t /* to */, const std::size_t /* number_of_threads */, const std::size_t /* thread_index */) override
     {}
 
     void finalize(const indexed_set_for_states_type& /* state_map */, bool /* timed */) override
@@ -74,28 +271,40 @@ class lts_none_builder: public lts_builder
 
     void save(const std::string& /* filename */) override
     {}
+
+    void save_checkpoint(atermpp::aterm_ostream& /* stream */) override
+    {}
+
+    void load_checkpoint(atermpp::aterm_istream& /* stream */) override
+    {}
 };
 
 class lts_aut_builder: public lts_builder
 {
   protected:
     lts_aut_t m_lts;
-    std::mutex m_exclusive_transition_access;
 
   public:
     lts_aut_builder() = default;
 
-    void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads) override
+    void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads, const std::size_t thread_index) override
     {
-      if (atermpp::detail::GlobalThreadSafe && number_of_threads>1) m_exclusive_transition_access.lock();
-      std::size_t label = add_action(a);
-      m_lts.add_transition(transition(from, label, to));
-      if (atermpp::detail::GlobalThreadSafe && number_of_threads>1) m_exclusive_transition_access.unlock();
+      if (atermpp::detail::GlobalThreadSafe && number_of_threads>1)
+      {
+        buffer_transition(from, a, to, number_of_threads, thread_index, m_lts);
+      }
+      else
+      {
+        std::size_t label = add_action(a);
+        m_lts.add_transition(transition(from, label, to));
+      }
     }
 
     // Add actions and states to the LTS
     void finalize(const indexed_set_for_states_type& state_map, bool /* timed */) override
     {
+      flush_transition_buffers(m_lts);
+
       // add actions
       m_lts.set_num_action_labels(m_actions.size());
       for (const auto& p: m_actions)
@@ -104,46 +313,99 @@ class lts_aut_builder: public lts_builder
       }
 
       m_lts.set_num_states(state_map.size());
+      m_lts.set_initial_state(0);
     }
 
     void save(const std::string& filename) override
     {
       m_lts.save(filename);
     }
+
+    void save_checkpoint(atermpp::aterm_ostream& stream) override
+    {
+      save_actions(stream);
+      save_transitions(stream, m_lts);
+    }
+
+    void load_checkpoint(atermpp::aterm_istream& stream) override
+    {
+      load_actions(stream);
+      load_transitions(stream, m_lts);
+    }
 };
 
 // Write transitions immediately to disk, and add the AUT header later.
 class lts_aut_disk_builder: public lts_builder
 {
   protected:
+    std::string m_filename;
     std::ofstream out;
     std::size_t m_transition_count = 0;
-    std::mutex m_exclusive_transition_access;
+
+    // The transitions of a thread in the AUT format, which are written to out when the buffer is full.
+    struct alignas(64) text_buffer
+    {
+      static constexpr std::size_t capacity = 1 << 16;
+
+      std::string text;
+      std::size_t transition_count = 0;
+    };
+    detail::thread_buffers<text_buffer> m_text_buffers;
+
+    void flush(text_buffer& buffer)
+    {
+      out << buffer.text;
+      m_transition_count += buffer.transition_count;
+      buffer.text.clear();
+      buffer.transition_count = 0;
+    }
 
   public:
-    explicit lts_aut_disk_builder(const std::string& filename)
+    /// \param resume If true, the file is not truncated, as the transitions up to the position that is
+    ///        stored in a checkpoint are kept by load_checkpoint.
+    explicit lts_aut_disk_builder(const std::string& filename, bool resume = false)
+      : m_filename(filename)
     {
       mCRL2log(log::verbose) << "writing state space in AUT format to '" << filename << "'." << std::endl;
-      out.open(filename.c_str());
+      out.open(filename.c_str(), resume ? std::ios::in | std::ios::out : std::ios::out);
       if (!out.is_open())
       {
         mCRL2log(log::error) << "cannot open '" << filename << "' for writing" << std::endl;
         std::exit(EXIT_FAILURE);
       }
-      out << "des                                                \n"; // write a dummy header that will be overwritten
+      if (!resume)
+      {
+        out << "des                                                \n"; // write a dummy header that will be overwritten
+      }
     }
 
-    void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads) override
+    void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads, const std::size_t thread_index) override
     {
-      if (atermpp::detail::GlobalThreadSafe && number_of_threads>1) m_exclusive_transition_access.lock();
-      m_transition_count++;
-      out << "(" << from << ",\"" << lps::pp(a) << "\"," << to << ")\n";
-      if (atermpp::detail::GlobalThreadSafe && number_of_threads>1) m_exclusive_transition_access.unlock();
+      if (atermpp::detail::GlobalThreadSafe && number_of_threads>1)
+      {
+        text_buffer& buffer = m_text_buffers(thread_index, number_of_threads);
+        buffer.text += "(" + std::to_string(from) + ",\"" + lps::pp(a) + "\"," + std::to_string(to) + ")\n";
+        buffer.transition_count++;
+        if (buffer.text.size() >= text_buffer::capacity)
+        {
+          std::lock_guard<std::mutex> guard(m_exclusive_transition_access);
+          flush(buffer);
+        }
+      }
+      else
+      {
+        m_transition_count++;
+        out << "(" << from << ",\"" << lps::pp(a) << "\"," << to << ")\n";
+      }
     }
 
     // Add actions and states to the LTS
     void finalize(const indexed_set_for_states_type& state_map, bool /* timed */) override
     {
+      for (text_buffer& buffer: m_text_buffers.buffers())
+      {
+        flush(buffer);
+      }
       out.flush();
       out.seekp(0);
       out << "des (0," << m_transition_count << "," << state_map.size() << ")";
@@ -152,6 +414,25 @@ class lts_aut_disk_builder: public lts_builder
 
     void save(const std::string& /* filename */) override
     { }
+
+    void save_checkpoint(atermpp::aterm_ostream& stream) override
+    {
+      out.flush();
+      stream << atermpp::aterm_int(static_cast<std::size_t>(out.tellp())) << atermpp::aterm_int(m_transition_count);
+    }
+
+    // Removes the transitions that were written after the checkpoint was saved.
+    void load_checkpoint(atermpp::aterm_istream& stream) override
+    {
+      atermpp::aterm_int position;
+      atermpp::aterm_int transition_count;
+      stream >> position >> transition_count;
+      out.close();
+      std::filesystem::resize_file(m_filename, position.value());
+      out.open(m_filename.c_str(), std::ios::in | std::ios::out);
+      out.seekp(static_cast<std::streamoff>(position.value()));
+      m_transition_count = transition_count.value();
+    }
 };
 
 class lts_lts_builder: public lts_builder
@@ -159,7 +440,6 @@ class lts_lts_builder: public lts_builder
   protected:
     lts_lts_t m_lts;
     bool m_discard_state_labels = false;
-    std::mutex m_exclusive_transition_access;
 
   public:
     lts_lts_builder(
@@ -175,17 +455,24 @@ class lts_lts_builder: public lts_builder
       m_lts.set_action_label_declarations(action_labels);
     }
 
-    void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads) override
+    void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads, const std::size_t thread_index) override
     {
-      if (atermpp::detail::GlobalThreadSafe && number_of_threads>1) m_exclusive_transition_access.lock();
-      std::size_t label = add_action(a);
-      m_lts.add_transition(transition(from, label, to));
-      if (atermpp::detail::GlobalThreadSafe && number_of_threads>1) m_exclusive_transition_access.unlock();
+      if (atermpp::detail::GlobalThreadSafe && number_of_threads>1)
+      {
+        buffer_transition(from, a, to, number_of_threads, thread_index, m_lts);
+      }
+      else
+      {
+        std::size_t label = add_action(a);
+        m_lts.add_transition(transition(from, label, to));
+      }
     }
 
     // Add actions and states to the LTS
     void finalize(const indexed_set_for_states_type& state_map, bool timed) override
     {
+      flush_transition_buffers(m_lts);
+
       // add actions
       m_lts.set_num_action_labels(m_actions.size());
       for (const auto& p: m_actions)
@@ -220,6 +507,18 @@ class lts_lts_builder: public lts_builder
     {
       m_lts.save(filename);
     }
+
+    void save_checkpoint(atermpp::aterm_ostream& stream) override
+    {
+      save_actions(stream);
+      save_transitions(stream, m_lts);
+    }
+
+    void load_checkpoint(atermpp::aterm_istream& stream) override
+    {
+      load_actions(stream);
+      load_transitions(stream, m_lts);
+    }
 };
 
 class lts_lts_disk_builder: public lts_builder
@@ -228,7 +527,24 @@ class lts_lts_disk_builder: public lts_builder
     std::fstream fstream;
     std::unique_ptr<atermpp::binary_aterm_ostream> stream;
     bool m_discard_state_labels = false;
-    std::mutex m_exclusive_transition_access;
+
+    // The transitions of a thread, which are written to stream when the buffer is full.
+    struct alignas(64) multi_action_transition_buffer
+    {
+      static constexpr std::size_t capacity = 1024;
+
+      std::vector<std::tuple<std::size_t, lps::multi_action, std::size_t>> transitions;
+    };
+    detail::thread_buffers<multi_action_transition_buffer> m_multi_action_buffers;
+
+    void flush(multi_action_transition_buffer& buffer)
+    {
+      for (const auto& [from, a, to]: buffer.transitions)
+      {
+        write_transition(*stream, from, a, to);
+      }
+      buffer.transitions.clear();
+    }
 
   public:
     lts_lts_disk_builder(
@@ -252,30 +568,47 @@ class lts_lts_disk_builder: public lts_builder
       mcrl2::lts::write_lts_header(*stream, dataspec, process_parameters, action_labels);
     }
 
-    void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads) override
+    void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads, const std::size_t thread_index) override
     {
-      if (atermpp::detail::GlobalThreadSafe && number_of_threads>1) m_exclusive_transition_access.lock();
-      write_transition(*stream, from, a, to);
-      if (atermpp::detail::GlobalThreadSafe && number_of_threads>1) m_exclusive_transition_access.unlock();
+      if (atermpp::detail::GlobalThreadSafe && number_of_threads>1)
+      {
+        multi_action_transition_buffer& buffer = m_multi_action_buffers(thread_index, number_of_threads);
+        buffer.transitions.emplace_back(from, a, to);
+        if (buffer.transitions.size() >= multi_action_transition_buffer::capacity)
+        {
+          std::lock_guard<std::mutex> guard(m_exclusive_transition_access);
+          flush(buffer);
+        }
+      }
+      else
+      {
+        write_transition(*stream, from, a, to);
+      }
     }
 
     // Add actions and states to the LTS
     void finalize(const indexed_set_for_states_type& state_map, bool timed) override
     {
+      for (multi_action_transition_buffer& buffer: m_multi_action_buffers.buffers())
+      {
+        flush(buffer);
+      }
+
       if (!m_discard_state_labels)
       {
         // Write the state labels in the order of their indices.
         for (std::size_t i = 0; i < state_map.size(); i++)
         {
-          if (is_aterm_balanced_tree(state_map[i]))  // in a parallel context not all positions may be filled.
+          const lps::state s = state_map[i];
+          if (is_aterm_balanced_tree(s))  // in a parallel context not all positions may be filled.
           {
             if (timed)
             {
-              write_state_label(*stream, state_label_lts(remove_time_stamp(state_map[i])));
+              write_state_label(*stream, state_label_lts(remove_time_stamp(s)));
             }
             else
             {
-              write_state_label(*stream, state_label_lts(state_map[i]));
+              write_state_label(*stream, state_label_lts(s));
             }
           }
         }
@@ -333,7 +666,7 @@ std::unique_ptr<lts_builder> create_lts_builder(const lps::specification& lpsspe
       }
       else
       {
-        return std::make_unique<lts_aut_disk_builder>(output_filename);
+        return std::make_unique<lts_aut_disk_builder>(output_filename, options.resume);
       }
     }
     case lts_dot: return std::make_unique<lts_dot_builder>(lpsspec.data(), lpsspec.action_labels(), lpsspec.process().process_parameters());
@@ -12,6 +12,9 @@
 #ifndef MCRL2_LTS_STATE_SPACE_GENERATOR_H
 #define MCRL2_LTS_STATE_SPACE_GENERATOR_H
 
+#include <chrono>
+#include <filesystem>
+#include "mcrl2/atermpp/aterm_io_binary.h"
 #include "mcrl2/lps/explorer.h"
 #include "mcrl2/lts/trace.h"
 
@@ -39,6 +42,18 @@ const lps::state& first_state(const lps::stochastic_state& s)
 namespace detail 
 {
 
+// Returns " (state index: i)", or the empty string if the index of the state is not known,
+// which is the case when exploring with a bitstate storage.
+inline
+std::string print_state_index(std::size_t s_index)
+{
+  if (s_index == lps::state_indexed_set::npos)
+  {
+    return "";
+  }
+  return " (state index: " + std::to_string(s_index) + ")";
+}
+
 inline
 bool save_trace(
   class trace& tr,
@@ -250,7 +265,7 @@ class action_detector
       }
       bool result = false;
 
-      mCRL2log(log::info) << "Action '" + lps::pp(a) + "' found (state index: " + std::to_string(s0_index) + ")";
+      mCRL2log(log::info) << "Action '" + lps::pp(a) + "' found" + print_state_index(s0_index);
       if (m_trace_count < m_max_trace_count)
       {
         class trace tr = m_trace_constructor.construct_trace(s0);
@@ -291,7 +306,7 @@ class deadlock_detector
 
     void detect_deadlock(const lps::state& s, std::size_t s_index)
     {
-      mCRL2log(log::info) << "Deadlock found (state index: " + std::to_string(s_index) + ")";
+      mCRL2log(log::info) << "Deadlock found" + print_state_index(s_index);
       if (m_trace_count < m_max_trace_count)
       {
         class trace tr = m_trace_constructor.construct_trace(s);
@@ -348,7 +363,7 @@ class nondeterminism_detector
       }
       else if (i->second != s1) // nondeterminism detected
       {
-        mCRL2log(log::info) << "Nondeterministic state found (state index: " + std::to_string(s0_index) + ")";
+        mCRL2log(log::info) << "Nondeterministic state found" + print_state_index(s0_index);
         if (m_trace_count < m_max_trace_count)
         {
           class trace tr = m_trace_constructor.construct_trace(s0);
@@ -470,7 +485,7 @@ class divergence_detector
 
           // back_edge
           [&](const lps::state& s0, const lps::multi_action& a, const state_type& s1) {
-            mCRL2log(log::info) << "Divergent state found (state index: " + std::to_string(s_index) + ")";
+            mCRL2log(log::info) << "Divergent state found" + print_state_index(s_index);
             if (m_trace_count < m_max_trace_count)
             {
               class trace tr = global_trace_constructor.construct_trace(s);
@@ -506,7 +521,7 @@ class divergence_detector
 
           // back_edge
           [&](const lps::state& s0, const lps::multi_action& a, const state_type& s1) {
-            mCRL2log(log::info) << "Divergent state found (state index: " + std::to_string(s_index) + ")";
+            mCRL2log(log::info) << "Divergent state found" + print_state_index(s_index);
             if (m_trace_count < m_max_trace_count)
             {
               class trace tr = global_trace_constructor.construct_trace(s);
@@ -689,15 +704,66 @@ struct state_space_generator
     alignas(64) size_t m_bool;
   };
 
+  static atermpp::aterm checkpoint_marker()
+  {
+    return atermpp::aterm_appl(atermpp::function_symbol("state_space_checkpoint", 0));
+  }
+
+  // Writes the discovered states, the todo set and the partial LTS to options.checkpoint_file. The checkpoint
+  // is written to a temporary file first, which then replaces the previous checkpoint.
+  template <typename LTSBuilder>
+  void save_checkpoint(LTSBuilder& builder)
+  {
+    const std::string filename = options.checkpoint_file + ".tmp";
+    {
+      std::ofstream out(filename, std::ios::binary);
+      if (!out.is_open())
+      {
+        throw mcrl2::runtime_error("Could not open the checkpoint file '" + filename + "' for writing.");
+      }
+      atermpp::binary_aterm_ostream stream(out);
+      stream << checkpoint_marker();
+      explorer.save_checkpoint(stream);
+      builder.save_checkpoint(stream);
+    }
+    std::filesystem::rename(filename, options.checkpoint_file);
+    mCRL2log(log::verbose) << "Saved a checkpoint with " << explorer.state_map().size() << " states to '" << options.checkpoint_file << "'." << std::endl;
+  }
+
+  template <typename LTSBuilder>
+  void load_checkpoint(LTSBuilder& builder)
+  {
+    std::ifstream in(options.checkpoint_file, std::ios::binary);
+    if (!in.is_open())
+    {
+      throw mcrl2::runtime_error("Could not open the checkpoint file '" + options.checkpoint_file + "'.");
+    }
+    atermpp::binary_aterm_istream stream(in);
+    atermpp::aterm marker;
+    stream >> marker;
+    if (marker != checkpoint_marker())
+    {
+      throw mcrl2::runtime_error("The file '" + options.checkpoint_file + "' does not contain a checkpoint.");
+    }
+    explorer.load_checkpoint(stream);
+    builder.load_checkpoint(stream);
+    mCRL2log(log::verbose) << "Resuming from a checkpoint with " << explorer.state_map().size() << " states." << std::endl;
+  }
+
   // Explore the specification passed via the constructor, and put the results in builder.
   template <typename LTSBuilder>
   void explore(LTSBuilder& builder)
   {
     std::vector<aligned_bool> has_outgoing_transitions(options.number_of_threads+1); // thread indices start at 1. 
     const lps::state* source = nullptr;
+    auto last_checkpoint = std::chrono::steady_clock::now();
 
     try
     {
+      if (options.resume)
+      {
+        load_checkpoint(builder);
+      }
       explorer.generate_state_space(
         false,
 
@@ -743,7 +809,7 @@ struct state_space_generator
           }
           else
           {
-            builder.add_transition(s0_index, a, s1_index, number_of_threads);
+            builder.add_transition(s0_index, a, s1_index, number_of_threads, thread_index);
           }
           assert(thread_index<has_outgoing_transitions.size());
           has_outgoing_transitions[thread_index].m_bool = true;
@@ -786,6 +852,11 @@ struct state_space_generator
           {
             m_progress_monitor.finish_state(explorer.state_map().size(), todo_list_size, number_of_threads);
           }
+          if (!options.checkpoint_file.empty() && std::chrono::steady_clock::now() - last_checkpoint >= std::chrono::seconds(options.checkpoint_interval))
+          {
+            save_checkpoint(builder);
+            last_checkpoint = std::chrono::steady_clock::now();
+          }
         },
 
         // discover_initial_state
@@ -798,7 +869,29 @@ struct state_space_generator
         }
       );
       m_progress_monitor.finish_exploration(explorer.state_map().size(), options.number_of_threads);
+      if (options.cached)
+      {
+        lps::summand_cache_statistics statistics = explorer.cache_statistics();
+        mCRL2log(log::verbose) << "The caches of the summands had " << statistics.hits << " hits, " << statistics.misses << " misses and "
+                               << statistics.evictions << " evictions." << std::endl;
+      }
+      if (lps::is_probabilistic(options.state_storage))
+      {
+        std::ostringstream out;
+        out << "The expected number of states that were missed due to " << options.state_storage << " is "
+            << std::setprecision(3) << explorer.state_map().expected_number_of_missed_states();
+        if (options.state_storage == lps::state_storage::bitstate)
+        {
+          out << " (" << std::fixed << std::setprecision(2) << 100.0 * explorer.state_map().fill_ratio() << "% of the bit array is used)";
+        }
+        mCRL2log(log::info) << out.str() << "." << std::endl;
+      }
       builder.finalize(explorer.state_map(), Timed);
+      if (!options.checkpoint_file.empty())
+      {
+        // The exploration is complete, so the last checkpoint is no longer needed.
+        std::remove(options.checkpoint_file.c_str());
+      }
     }
     catch (const data::enumerator_error& e)
     {
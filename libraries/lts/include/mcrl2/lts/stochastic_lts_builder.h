@@ -20,7 +20,7 @@ namespace lts {
 
 struct stochastic_lts_builder
 {
-  typedef atermpp::indexed_set<lps::state, atermpp::detail::GlobalThreadSafe> indexed_set_for_states_type;
+  typedef lps::state_indexed_set indexed_set_for_states_type;
   // All LTS classes use integers to represent actions in transitions. A mapping from actions to integers
   // is needed to avoid duplicates.
   utilities::unordered_map_large<lps::multi_action, std::size_t> m_actions;
@@ -53,6 +53,17 @@ struct stochastic_lts_builder
   // Save the LTS to a file
   virtual void save(const std::string& filename) = 0;
 
+  // Checkpoints are not supported for stochastic specifications, see lts_builder::save_checkpoint
+  virtual void save_checkpoint(atermpp::aterm_ostream& /* stream */)
+  {
+    throw mcrl2::runtime_error("Checkpoints are not supported for stochastic specifications.");
+  }
+
+  virtual void load_checkpoint(atermpp::aterm_istream& /* stream */)
+  {
+    throw mcrl2::runtime_error("Checkpoints are not supported for stochastic specifications.");
+  }
+
   virtual ~stochastic_lts_builder() = default;
 };
 
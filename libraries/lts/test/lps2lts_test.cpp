@@ -18,6 +18,7 @@
 
 #include "mcrl2/data/detail/rewrite_strategies.h"
 #include "mcrl2/lps/is_stochastic.h"
+#include "mcrl2/lts/lts_algorithm.h"
 #include "mcrl2/lts/state_space_generator.h"
 #include "mcrl2/lts/stochastic_lts_builder.h"
 #include "mcrl2/utilities/test_utilities.h"
@@ -220,6 +221,426 @@ BOOST_AUTO_TEST_CASE(test_abp)
   check_lps2lts_specification(abp, 74, 92, 20, "tau");
 }
 
+BOOST_AUTO_TEST_CASE(test_multiple_threads)
+{
+  std::string spec(
+    "act a, b;\n"
+    "proc P(m, n: Nat) = (m < 10) -> a . P(m = m + 1)\n"
+    "                  + (n < 10) -> b . P(n = n + 1);\n"
+    "init P(0, 0);\n"
+  );
+  lps::specification lpsspec = parse_linear_process_specification(spec);
+
+  for (lps::exploration_strategy estrategy: { lps::es_breadth, lps::es_depth, lps::es_highway })
+  {
+    lps::explorer_options options;
+    options.search_strategy = estrategy;
+    options.number_of_threads = 4;
+    std::atomic<std::size_t> state_count = 0;
+    std::atomic<std::size_t> transition_count = 0;
+
+    lps::explorer<false, false, lps::specification> explorer(lpsspec, options);
+    explorer.generate_state_space(false,
+      [&](std::size_t /* thread_index */, const lps::state& /* s */, std::size_t /* s_index */) { state_count++; },
+      [&](std::size_t /* thread_index */, std::size_t /* number_of_threads */, const lps::state& /* s0 */, std::size_t /* s0_index */,
+          const lps::multi_action& /* a */, const lps::state& /* s1 */, std::size_t /* s1_index */, std::size_t /* summand_index */) { transition_count++; }
+    );
+    BOOST_CHECK_EQUAL(state_count, 121u);
+    BOOST_CHECK_EQUAL(transition_count, 220u);
+  }
+}
+
+// Generates the LTS of lpsspec in the given format with the given number of threads, and reads it back.
+static lts::lts_aut_t generate_lts_with_threads(const lps::specification& lpsspec, lts::lts_type output_format, bool save_at_end, std::size_t number_of_threads)
+{
+  lps::explorer_options options;
+  options.search_strategy = lps::es_breadth;
+  options.number_of_threads = number_of_threads;
+  options.save_at_end = save_at_end;
+  std::string filename = "generate_lts_with_threads" + file_extension(output_format);
+  {
+    // The disk builders complete the file when they are destroyed.
+    auto builder = create_lts_builder(lpsspec, options, output_format, filename);
+    generate_state_space<false, false>(lpsspec, *builder, filename, options);
+  }
+  lts::lts_aut_t result;
+  if (output_format == lts::lts_lts)
+  {
+    lts::lts_lts_t ltsspec;
+    ltsspec.load(filename);
+    lts::detail::lts_convert(ltsspec, result);
+  }
+  else
+  {
+    result.load(filename);
+  }
+  std::remove(filename.c_str());
+  return result;
+}
+
+// An LTS builder that gives access to the LTS, to inspect it before it is saved.
+class inspectable_lts_aut_builder: public lts::lts_aut_builder
+{
+  public:
+    const lts::lts_aut_t& lts() const
+    {
+      return m_lts;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(test_multiple_threads_builders)
+{
+  lps::specification lpsspec = parse_linear_process_specification(
+    "act a, b: Nat;\n"
+    "proc P(m, n: Nat) = (m < 40) -> a(m) . P(m = m + 1)\n"
+    "                  + (n < 40) -> b(n mod 7) . P(n = n + 1);\n"
+    "init P(0, 0);\n"
+  );
+  for (lts::lts_type output_format: { lts::lts_aut, lts::lts_lts })
+  {
+    for (bool save_at_end: { true, false })
+    {
+      lts::lts_aut_t expected = generate_lts_with_threads(lpsspec, output_format, save_at_end, 1);
+      lts::lts_aut_t result = generate_lts_with_threads(lpsspec, output_format, save_at_end, 4);
+      BOOST_CHECK_EQUAL(result.num_states(), 41u * 41u);
+      BOOST_CHECK_EQUAL(result.num_transitions(), 2u * 40u * 41u);
+      BOOST_CHECK(lts::compare(expected, result, lts::lts_eq_bisim));
+
+    }
+  }
+
+  // In a parallel exploration the labels are numbered in the order of the printed actions, and the
+  // transitions are sorted, independently of the order in which the threads added them.
+  lps::explorer_options options;
+  options.search_strategy = lps::es_breadth;
+  options.number_of_threads = 4;
+  inspectable_lts_aut_builder builder;
+  lts::state_space_generator<false, false, lps::specification> generator(lpsspec, options);
+  generator.explore(builder);
+  const lts::lts_aut_t& ltsspec = builder.lts();
+  BOOST_CHECK_EQUAL(ltsspec.num_transitions(), 2u * 40u * 41u);
+  BOOST_CHECK_EQUAL(ltsspec.action_label(0), lts::action_label_string::tau_action());
+  for (std::size_t i = 2; i < ltsspec.num_action_labels(); ++i)
+  {
+    BOOST_CHECK(std::string(ltsspec.action_label(i - 1)) < std::string(ltsspec.action_label(i)));
+  }
+  BOOST_CHECK(std::is_sorted(ltsspec.get_transitions().begin(), ltsspec.get_transitions().end(), [](const lts::transition& t1, const lts::transition& t2)
+    {
+      return std::make_tuple(t1.from(), t1.label(), t1.to()) < std::make_tuple(t2.from(), t2.label(), t2.to());
+    }
+  ));
+}
+
+static void check_tree_state_storage(const std::string& spec, std::size_t number_of_threads)
+{
+  lps::specification lpsspec = parse_linear_process_specification(spec);
+  lps::explorer_options options;
+  options.search_strategy = lps::es_breadth;
+  options.number_of_threads = number_of_threads;
+  lps::explorer<false, false, lps::specification> explorer(lpsspec, options);
+  explorer.generate_state_space(false);
+
+  lps::explorer_options tree_options = options;
+  tree_options.state_storage = lps::state_storage::tree;
+  lps::explorer<false, false, lps::specification> tree_explorer(lpsspec, tree_options);
+  tree_explorer.generate_state_space(false);
+
+  const auto& states = explorer.state_map();
+  const auto& tree_states = tree_explorer.state_map();
+  BOOST_CHECK_EQUAL(states.size(), tree_states.size());
+  for (std::size_t i = 0; i < tree_states.size(); ++i)
+  {
+    // The reconstructed state must be stored under the same index.
+    BOOST_CHECK_EQUAL(tree_states.index(tree_states[i]), i);
+    BOOST_CHECK(states.index(tree_states[i]) < states.size());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_tree_state_storage)
+{
+  std::string spec0(
+    "act a;\n"
+    "proc P = a . P;\n"
+    "init P;\n"
+  );
+  std::string spec1(
+    "act a;\n"
+    "proc P(n: Nat) = (n < 5) -> a . P(n = n + 1);\n"
+    "init P(0);\n"
+  );
+  std::string spec3(
+    "act a, b, c;\n"
+    "proc P(m, n: Nat, x: Bool) = (m < 10) -> a . P(m = m + 1)\n"
+    "                           + (n < 10) -> b . P(n = n + 1)\n"
+    "                           + c . P(x = !x);\n"
+    "init P(0, 0, true);\n"
+  );
+  for (std::size_t number_of_threads: { 1, 4 })
+  {
+    check_tree_state_storage(spec0, number_of_threads);
+    check_tree_state_storage(spec1, number_of_threads);
+    check_tree_state_storage(spec3, number_of_threads);
+  }
+}
+
+static std::size_t count_probabilistic_states(const lps::specification& lpsspec, lps::state_storage storage, std::size_t number_of_threads, std::size_t bitstate_bits = 20)
+{
+  lps::explorer_options options;
+  options.search_strategy = lps::es_breadth;
+  options.number_of_threads = number_of_threads;
+  options.state_storage = storage;
+  options.bitstate_bits = bitstate_bits;
+  std::atomic<std::size_t> state_count = 0;
+  lps::explorer<false, false, lps::specification> explorer(lpsspec, options);
+  explorer.generate_state_space(false,
+    [&](std::size_t /* thread_index */, const lps::state& /* s */, std::size_t /* s_index */) { state_count++; }
+  );
+  BOOST_CHECK_EQUAL(state_count, explorer.state_map().size());
+  BOOST_CHECK(explorer.state_map().expected_number_of_missed_states() >= 0.0);
+  return state_count;
+}
+
+BOOST_AUTO_TEST_CASE(test_probabilistic_state_storage)
+{
+  std::string spec(
+    "act a, b;\n"
+    "proc P(m, n: Nat) = (m < 10) -> a . P(m = m + 1)\n"
+    "                  + (n < 10) -> b . P(n = n + 1);\n"
+    "init P(0, 0);\n"
+  );
+  lps::specification lpsspec = parse_linear_process_specification(spec);
+  for (std::size_t number_of_threads: { 1, 4 })
+  {
+    BOOST_CHECK_EQUAL(count_probabilistic_states(lpsspec, lps::state_storage::hash_compaction, number_of_threads), 121u);
+    BOOST_CHECK_EQUAL(count_probabilistic_states(lpsspec, lps::state_storage::bitstate, number_of_threads), 121u);
+
+    // With a bit array of only 64 bits part of the state space is missed.
+    std::size_t count = count_probabilistic_states(lpsspec, lps::state_storage::bitstate, number_of_threads, 6);
+    BOOST_CHECK(0 < count && count < 121);
+  }
+
+  // Deadlock detection does not need the indices of the states.
+  lps::explorer_options options;
+  options.search_strategy = lps::es_breadth;
+  options.state_storage = lps::state_storage::bitstate;
+  options.bitstate_bits = 20;
+  options.detect_deadlock = true;
+  lts::lts_none_builder builder;
+  lts::state_space_generator<false, false, lps::specification> generator(lpsspec, options);
+  generator.explore(builder);
+}
+
+template <bool Timed>
+static void check_disk_state_storage(const std::string& spec)
+{
+  lps::specification lpsspec = parse_linear_process_specification(spec);
+  std::string expected;
+  for (lps::state_storage storage: { lps::state_storage::terms, lps::state_storage::disk })
+  {
+    lps::explorer_options options;
+    options.search_strategy = lps::es_breadth;
+    options.state_storage = storage;
+    options.detect_deadlock = true;
+    lts::lts_aut_builder builder;
+    lts::state_space_generator<false, Timed, lps::specification> generator(lpsspec, options);
+    generator.explore(builder);
+    std::string filename = "check_disk_state_storage.aut";
+    builder.save(filename);
+    lts::lts_aut_t result;
+    result.load(filename);
+    std::remove(filename.c_str());
+    std::ostringstream out;
+    out << result.num_states() << " " << result.num_transitions() << " " << result.num_action_labels();
+    if (storage == lps::state_storage::terms)
+    {
+      expected = out.str();
+    }
+    else
+    {
+      BOOST_CHECK_EQUAL(out.str(), expected);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_disk_state_storage)
+{
+  check_disk_state_storage<false>(
+    "act a, b;\n"
+    "proc P(m, n: Nat) = (m < 10) -> a . P(m = m + 1)\n"
+    "                  + (n < 10) -> b . P(n = n + 1);\n"
+    "init P(0, 0);\n"
+  );
+  check_disk_state_storage<false>(
+    "act a;\n"
+    "proc P = a . P;\n"
+    "init P;\n"
+  );
+  check_disk_state_storage<true>(
+    "act a, b;\n"
+    "proc P(n: Nat) = (n < 5) -> a@(n + 1) . P(n = n + 1) + b . P(n = 0);\n"
+    "init P(0);\n"
+  );
+}
+
+// An LTS builder that fails after a given number of transitions, to simulate an interrupted exploration.
+class interrupted_lts_aut_builder: public lts::lts_aut_builder
+{
+  protected:
+    std::size_t m_remaining;
+
+  public:
+    explicit interrupted_lts_aut_builder(std::size_t transition_count)
+      : m_remaining(transition_count)
+    {}
+
+    void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads, const std::size_t thread_index) override
+    {
+      if (m_remaining-- == 0)
+      {
+        throw mcrl2::runtime_error("interrupted");
+      }
+      lts::lts_aut_builder::add_transition(from, a, to, number_of_threads, thread_index);
+    }
+};
+
+static std::string read_file(const std::string& filename)
+{
+  std::ifstream in(filename);
+  std::ostringstream out;
+  out << in.rdbuf();
+  return out.str();
+}
+
+BOOST_AUTO_TEST_CASE(test_checkpoint)
+{
+  std::string spec(
+    "act a; b: Nat;\n"
+    "proc P(m, n: Nat) = (m < 10) -> a . P(m = m + 1)\n"
+    "                  + (n < 10) -> b(n) . P(n = n + 1);\n"
+    "init P(0, 0);\n"
+  );
+  lps::specification lpsspec = parse_linear_process_specification(spec);
+  for (lps::exploration_strategy estrategy: { lps::es_breadth, lps::es_depth })
+  {
+    lps::explorer_options options;
+    options.search_strategy = estrategy;
+    options.rewrite_actions = true;
+
+    lts::lts_aut_builder builder;
+    generate_state_space<false, false>(lpsspec, builder, "test_checkpoint_expected.aut", options);
+
+    options.checkpoint_file = "test_checkpoint.chk";
+    options.checkpoint_interval = 0;
+    interrupted_lts_aut_builder interrupted_builder(100);
+    lts::state_space_generator<false, false, lps::specification> interrupted_generator(lpsspec, options);
+    BOOST_CHECK_THROW(interrupted_generator.explore(interrupted_builder), mcrl2::runtime_error);
+
+    options.resume = true;
+    lts::lts_aut_builder resumed_builder;
+    generate_state_space<false, false>(lpsspec, resumed_builder, "test_checkpoint_resumed.aut", options);
+
+    BOOST_CHECK_EQUAL(read_file("test_checkpoint_expected.aut"), read_file("test_checkpoint_resumed.aut"));
+    std::remove("test_checkpoint_expected.aut");
+    std::remove("test_checkpoint_resumed.aut");
+    std::remove(options.checkpoint_file.c_str());
+  }
+}
+
+static lts::lts_aut_t generate_reduced_lts(const lps::specification& lpsspec, lps::partial_order_reduction reduction, lps::exploration_strategy estrategy, std::size_t number_of_threads = 1)
+{
+  lps::explorer_options options;
+  options.search_strategy = estrategy;
+  options.partial_order_reduction = reduction;
+  options.number_of_threads = number_of_threads;
+  lts::lts_aut_builder builder;
+  generate_state_space<false, false>(lpsspec, builder, "generate_reduced_lts.aut", options);
+  lts::lts_aut_t result;
+  result.load("generate_reduced_lts.aut");
+  std::remove("generate_reduced_lts.aut");
+  return result;
+}
+
+static std::size_t count_deadlocks(const lts::lts_aut_t& ltsspec)
+{
+  std::vector<bool> has_successor(ltsspec.num_states(), false);
+  for (const lts::transition& t: ltsspec.get_transitions())
+  {
+    has_successor[t.from()] = true;
+  }
+  return std::count(has_successor.begin(), has_successor.end(), false);
+}
+
+BOOST_AUTO_TEST_CASE(test_partial_order_reduction)
+{
+  // Three independent counters that deadlock when they are all 3.
+  lps::specification lpsspec = parse_linear_process_specification(
+    "proc P(x, y, z: Nat) = (x < 3) -> tau . P(x = x + 1)\n"
+    "                     + (y < 3) -> tau . P(y = y + 1)\n"
+    "                     + (z < 3) -> tau . P(z = z + 1);\n"
+    "init P(0, 0, 0);\n"
+  );
+  for (lps::exploration_strategy estrategy: { lps::es_breadth, lps::es_depth })
+  {
+    lts::lts_aut_t full = generate_reduced_lts(lpsspec, lps::partial_order_reduction::none, estrategy);
+    BOOST_CHECK_EQUAL(full.num_states(), 64u);
+    BOOST_CHECK_EQUAL(count_deadlocks(full), 1u);
+    for (lps::partial_order_reduction reduction: { lps::partial_order_reduction::deadlock, lps::partial_order_reduction::stutter })
+    {
+      lts::lts_aut_t reduced = generate_reduced_lts(lpsspec, reduction, estrategy);
+      BOOST_CHECK_EQUAL(reduced.num_states(), 10u);
+      BOOST_CHECK_EQUAL(count_deadlocks(reduced), 1u);
+    }
+  }
+
+  // An invisible cycle that is independent of a visible cycle. The cycle proviso forces the visible
+  // actions to be explored, such that the reduced state space is still weak trace equivalent.
+  lpsspec = parse_linear_process_specification(
+    "act a, b;\n"
+    "proc P(m, n: Nat) = (m < 3) -> tau . P(m = m + 1)\n"
+    "                  + (m == 3) -> tau . P(m = 0)\n"
+    "                  + (n < 3) -> a . P(n = n + 1)\n"
+    "                  + (n == 3) -> b . P(n = 0);\n"
+    "init P(0, 0);\n"
+  );
+  for (std::size_t number_of_threads: { 1, 2 })
+  {
+    lts::lts_aut_t full = generate_reduced_lts(lpsspec, lps::partial_order_reduction::none, lps::es_breadth, number_of_threads);
+    lts::lts_aut_t reduced = generate_reduced_lts(lpsspec, lps::partial_order_reduction::stutter, lps::es_breadth, number_of_threads);
+    BOOST_CHECK(reduced.num_transitions() < full.num_transitions());
+    BOOST_CHECK(lts::compare(full, reduced, lts::lts_eq_weak_trace));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_cached)
+{
+  lps::specification lpsspec = parse_linear_process_specification(
+    "act a: Nat;\n"
+    "proc P(m, n: Nat) = sum k: Nat. (k < m) -> a(k) . P(m = (m + 1) mod 20)\n"
+    "                  + sum k: Nat. (k < n && n < 20) -> a(k) . P(n = n + 1);\n"
+    "init P(1, 1);\n"
+  );
+  lps::explorer_options options;
+  options.search_strategy = lps::es_breadth;
+  lps::explorer<false, false, lps::specification> explorer(lpsspec, options);
+  explorer.generate_state_space(false);
+
+  for (bool global_cache: { false, true })
+  {
+    for (std::size_t number_of_threads: { 1, 4 })
+    {
+      lps::explorer_options cached_options = options;
+      cached_options.cached = true;
+      cached_options.global_cache = global_cache;
+      cached_options.cache_size = 1;
+      cached_options.number_of_threads = number_of_threads;
+      lps::explorer<false, false, lps::specification> cached_explorer(lpsspec, cached_options);
+      cached_explorer.generate_state_space(false);
+      BOOST_CHECK_EQUAL(cached_explorer.state_map().size(), explorer.state_map().size());
+      BOOST_CHECK(cached_explorer.cache_statistics().hits > 0);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(test_confluence)
 {
   std::string spec(
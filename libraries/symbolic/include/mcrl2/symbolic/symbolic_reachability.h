@@ -28,7 +28,7 @@ namespace mcrl2::symbolic {
 struct symbolic_reachability_options
 {
   data::rewrite_strategy rewrite_strategy = data::jitty;
-  std::size_t max_workers = 0;
+  std::size_t max_workers = 0; // The number of threads that learn transitions in parallel, 0 or 1 for none.
   std::size_t max_iterations = 0;
   bool cached = false;
   bool chaining = false;
@@ -52,6 +52,7 @@ inline
 std::ostream& operator<<(std::ostream& out, const symbolic_reachability_options& options)
 {
   out << "rewrite-strategy = " << options.rewrite_strategy << std::endl;
+  out << "max-workers = " << options.max_workers << std::endl;
   out << "cached = " << std::boolalpha << options.cached << std::endl;
   out << "chaining = " << std::boolalpha << options.chaining << std::endl;
   out << "detect_deadlocks = " << std::boolalpha << options.detect_deadlocks << std::endl;
@@ -175,10 +176,9 @@ void learn_successors_callback(WorkerP*, Task*, std::uint32_t* x, std::size_t, v
                            },
                            data::is_false
       );
-
-      ++i;
     }
     data::remove_assignments(sigma, smd.variables);
+    ++i;
   }
   data::remove_assignments(sigma, group.read_parameters);
   group.learn_calls += 1;
@@ -10,8 +10,12 @@
 #ifndef MCRL2_UTILITIES_BITSTREAM_H
 #define MCRL2_UTILITIES_BITSTREAM_H
 
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
 #include <vector>
-#include <bitset>
 
 namespace mcrl2
 {
@@ -36,8 +40,25 @@ public:
 
   /// \brief Write the num_of_bits least significant bits in descending order from value.
   /// @param value Variable that contains the bits.
-  /// @param num_of_bits Number of bits to write to the output stream.
-  void write_bits(std::size_t value, unsigned int num_of_bits);
+  /// @param num_of_bits Number of bits to write to the output stream, at most 64.
+  void write_bits(std::size_t value, unsigned int num_of_bits)
+  {
+    assert(num_of_bits <= 64);
+    if (num_of_bits != 0 && bits_in_buffer + num_of_bits < 64)
+    {
+      // The bits fit in the buffer, put them at the left-most free position.
+      write_buffer |= (value & ((std::uint64_t(1) << num_of_bits) - 1)) << (64 - bits_in_buffer - num_of_bits);
+      bits_in_buffer += num_of_bits;
+    }
+    else
+    {
+      write_bits_slow(value, num_of_bits);
+    }
+  }
+
+  /// \brief Write the num_of_bits least significant bits of each of the count given values.
+  /// \details Writes the same bits as calling write_bits(value, num_of_bits) for every value in order.
+  void write_bits(const std::size_t* values, std::size_t count, unsigned int num_of_bits);
 
   /// \brief Write the given string to the output stream.
   /// \details Encoded in bits using <length, string>
@@ -47,20 +68,33 @@ public:
   /// \details Uses most significant bit encoding.
   void write_integer(std::size_t value);
 
+  /// \brief Writes size bytes from the given buffer.
+  void write(const std::uint8_t* buffer, std::size_t size);
+
 private:
   /// \brief Flush the remaining bits in the buffer to the output stream.
-  /// \details Note that this aligns it to the next byte, e.g. when bits_in_buffer is 6 then two zero bits are added redundantly.
+  /// \details Note that this aligns it to the next word, e.g. when bits_in_buffer is 6 then 58 zero bits are added
+  ///          redundantly, and a full word of zero bits when the buffer is empty.
   void flush();
 
-  /// \brief Writes size bytes from the given buffer.
-  void write(const std::uint8_t* buffer, std::size_t size);
+  /// \brief Writes the bits that do not fit in the buffer, which must then be written to the output.
+  void write_bits_slow(std::size_t value, unsigned int num_of_bits);
+
+  /// \brief Appends the given word to the output in big endian byte order.
+  void write_word(std::uint64_t word);
+
+  /// \brief Writes the words in the output buffer to the stream.
+  void write_output();
 
   std::ostream& stream;
 
-  /// \brief Buffer that is filled starting from bit 127 when writing
-  std::bitset<128> write_buffer = 0;
+  /// \brief Buffer that is filled starting from bit 63 when writing.
+  std::uint64_t write_buffer = 0;
 
-  unsigned int bits_in_buffer = 0; ///< how many bits in are used in the buffer.
+  unsigned int bits_in_buffer = 0; ///< how many bits in are used in the buffer, always less than 64.
+
+  std::array<char, 4096> m_output; ///< The bytes that have not yet been written to the stream.
+  std::size_t m_output_size = 0;   ///< The number of bytes in m_output.
 
   std::uint8_t integer_buffer[integer_encoding_size<std::size_t>()]; ///< Reserved space to store an n byte integer.
 };
@@ -74,8 +108,24 @@ public:
   ibitstream(std::istream& stream);
 
   /// \brief Reads an num_of_bits bits from the input stream and stores them in the least significant part (in descending order) of the return value.
-  /// \param num_of_bits Number of bits to read from the input stream.
-  std::size_t read_bits(unsigned int num_of_bits);
+  /// \param num_of_bits Number of bits to read from the input stream, at most 64.
+  std::size_t read_bits(unsigned int num_of_bits)
+  {
+    assert(num_of_bits <= 64);
+    if (num_of_bits != 0 && num_of_bits < bits_in_buffer)
+    {
+      // Shift the bits to the least significant bits, and the next bit to the first position in the buffer.
+      std::size_t value = read_buffer >> (64 - num_of_bits);
+      read_buffer <<= num_of_bits;
+      bits_in_buffer -= num_of_bits;
+      return value;
+    }
+
+    return read_bits_slow(num_of_bits);
+  }
+
+  /// \brief Reads count values of num_of_bits bits each, as written by the corresponding obitstream::write_bits.
+  void read_bits(std::size_t* values, std::size_t count, unsigned int num_of_bits);
 
   /// \returns A pointer to the read string.
   /// \details Remains valid until the next call to read_string.
@@ -84,14 +134,21 @@ public:
   /// \returns A natural number that was read from the binary stream encoded in most significant bit encoding.
   std::size_t read_integer();
 
-private:
   /// \brief Read size bytes into the provided buffer.
   void read(std::size_t size, std::uint8_t* buffer);
 
+private:
+
+  /// \brief Reads the bits that are not all in the buffer, which must then be read from the input.
+  std::size_t read_bits_slow(unsigned int num_of_bits);
+
+  /// \brief Fills the empty buffer with the next word of the input.
+  void read_word();
+
   std::istream& stream;
 
-  /// \brief Buffer that is filled starting from bit 127 when reading.
-  std::bitset<128> read_buffer = 0;
+  /// \brief Buffer that is filled starting from bit 63 when reading.
+  std::uint64_t read_buffer = 0;
 
   unsigned int bits_in_buffer = 0; ///< how many bits in the buffer are used.
 
@@ -0,0 +1,36 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef MCRL2_UTILITIES_BLOCK_COMPRESSION_H
+#define MCRL2_UTILITIES_BLOCK_COMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mcrl2
+{
+namespace utilities
+{
+
+/// \brief Compresses a block of bytes with a fast dictionary codec, which favours speed over the compression ratio.
+/// \details The block is encoded as a sequence of literal bytes and back references of at least four bytes into the
+///          preceding 64KiB, in the style of LZ4. Incompressible input grows by less than one percent.
+/// \returns The compressed bytes, which do not include the size of the input.
+std::vector<std::uint8_t> compress_block(const std::uint8_t* input, std::size_t size);
+
+/// \brief Decompresses a block that was compressed by compress_block.
+/// \param output The decompressed bytes, of which the number must be known.
+/// \exception mcrl2::runtime_error When the input is not a block of output_size compressed bytes.
+void decompress_block(const std::uint8_t* input, std::size_t size, std::uint8_t* output, std::size_t output_size);
+
+} // namespace utilities
+} // namespace mcrl2
+
+#endif // MCRL2_UTILITIES_BLOCK_COMPRESSION_H
@@ -237,6 +237,23 @@ public:
     m_head.set_next(new_node);
   }
 
+  /// \brief The offset of the key in a node, see push_front_external.
+  static constexpr std::size_t key_offset = sizeof(node_base);
+
+  /// \brief Inserts the given key in the front, where the key has been constructed key_offset bytes after the start of
+  ///        memory that is not owned by the allocator. The first key_offset bytes of this memory become the node.
+  void push_front_external(Key& key)
+  {
+    static_assert(alignof(Key) <= alignof(node_base), "The key must directly follow the node_base in a node.");
+    node_base* new_node = new (reinterpret_cast<char*>(&key) - key_offset) node_base();
+
+    // Ensure that the previous front is set behind this node.
+    new_node->set_next(m_head.next());
+
+    // Change the head to the new node.
+    m_head.set_next(new_node);
+  }
+
   /// \brief Constructs an element using the allocator with the given arguments and insert it in the front of the bucket iff it does not already exist.
   /// \returns True iff the insertion took place.
   /// \threadsafe
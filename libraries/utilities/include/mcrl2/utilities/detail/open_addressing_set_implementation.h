@@ -0,0 +1,498 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef MCRL2_UTILITIES_OPEN_ADDRESSING_SET_IMPLEMENTATION_H
+#define MCRL2_UTILITIES_OPEN_ADDRESSING_SET_IMPLEMENTATION_H
+#pragma once
+
+#define MCRL2_OPEN_ADDRESSING_SET_TEMPLATES template<typename Key, typename Hash, typename Equals, typename Allocator, bool ThreadSafe, bool Resize>
+#define MCRL2_OPEN_ADDRESSING_SET_CLASS open_addressing_set<Key, Hash, Equals, Allocator, ThreadSafe, Resize>
+
+#include "mcrl2/utilities/open_addressing_set.h"
+
+#include "mcrl2/utilities/power_of_two.h"
+
+namespace mcrl2::utilities
+{
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+MCRL2_OPEN_ADDRESSING_SET_CLASS::open_addressing_set(const open_addressing_set& set)
+  : m_overflow(0, overflow_hash{set.m_hash}, overflow_equals{set.m_equals}),
+    m_hash(set.m_hash),
+    m_equals(set.m_equals)
+{
+  reserve(set.size());
+
+  for (auto& element : set)
+  {
+    emplace(element);
+  }
+}
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+MCRL2_OPEN_ADDRESSING_SET_CLASS& MCRL2_OPEN_ADDRESSING_SET_CLASS::operator=(const open_addressing_set& set)
+{
+  clear();
+  reserve(set.size());
+
+  for (auto& element : set)
+  {
+    emplace(element);
+  }
+
+  return *this;
+}
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+MCRL2_OPEN_ADDRESSING_SET_CLASS::~open_addressing_set()
+{
+  // This open_addressing_set is not moved-from.
+  if (m_control != nullptr)
+  {
+    clear();
+  }
+}
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+auto MCRL2_OPEN_ADDRESSING_SET_CLASS::cbegin() const -> const_iterator
+{
+  const_iterator it(this, 0, typename overflow_set::const_iterator());
+  it.goto_next_element();
+  return it;
+}
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+void MCRL2_OPEN_ADDRESSING_SET_CLASS::clear()
+{
+  for (size_type index = 0; index < m_number_of_slots; ++index)
+  {
+    if (is_full(m_control[index].load(std::memory_order_relaxed)))
+    {
+      destroy(m_slots[index].load(std::memory_order_relaxed));
+      m_slots[index].store(nullptr, std::memory_order_relaxed);
+    }
+    m_control[index].store(Empty, std::memory_order_relaxed);
+  }
+
+  for (Key* key : m_overflow)
+  {
+    destroy(key);
+  }
+  m_overflow.clear();
+
+  m_number_of_elements = 0;
+  m_number_of_deleted = 0;
+}
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+template<typename ...Args>
+auto MCRL2_OPEN_ADDRESSING_SET_CLASS::emplace(Args&&... args) -> std::pair<iterator, bool>
+{
+  if constexpr (Resize) { rehash_if_needed(); }
+
+  if constexpr (allow_transparent)
+  {
+    return emplace_impl(hash(args...), [&]() { return construct(std::forward<Args>(args)...); }, args...);
+  }
+  else
+  {
+    // The element is needed to compute the hash, so it is constructed beforehand.
+    Key* key = construct(std::forward<Args>(args)...);
+    bool inserted = false;
+    auto result = emplace_impl(hash(*key), [&]() { inserted = true; return key; }, *key);
+
+    if (!inserted)
+    {
+      destroy(key);
+    }
+    return result;
+  }
+}
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+auto MCRL2_OPEN_ADDRESSING_SET_CLASS::erase(const_iterator it) -> iterator
+{
+  if (it.m_index < m_number_of_slots)
+  {
+    erase_slot(it.m_index);
+
+    iterator next(this, it.m_index + 1, typename overflow_set::const_iterator());
+    next.goto_next_element();
+    return next;
+  }
+  else
+  {
+    destroy(*it.m_overflow_it);
+    return iterator(this, m_number_of_slots, m_overflow.erase(it.m_overflow_it));
+  }
+}
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+template<typename ...Args>
+std::size_t MCRL2_OPEN_ADDRESSING_SET_CLASS::count(const Args&... args) const
+{
+  return find(args...) != end();
+}
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+template<typename ...Args>
+void MCRL2_OPEN_ADDRESSING_SET_CLASS::erase(const Args&... args)
+{
+  if constexpr (allow_transparent)
+  {
+    erase_impl(args...);
+  }
+  else
+  {
+    erase_impl(Key(args...));
+  }
+}
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+template<typename ...Args>
+auto MCRL2_OPEN_ADDRESSING_SET_CLASS::find(const Args&... args) const -> const_iterator
+{
+  if constexpr (allow_transparent)
+  {
+    return find_impl(hash(args...), args...);
+  }
+  else
+  {
+    Key element(args...);
+    return find_impl(hash(element), element);
+  }
+}
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+void MCRL2_OPEN_ADDRESSING_SET_CLASS::rehash(std::size_t number_of_slots)
+{
+  // The number of slots is a power of two, which is at least large enough to contain the current elements.
+  number_of_slots = std::max(number_of_slots, size() + size() / 7 + 1);
+  number_of_slots = std::max(utilities::round_up_to_power_of_two(number_of_slots), detail::GroupSize);
+
+  std::unique_ptr<control_type[]> old_control = std::move(m_control);
+  std::unique_ptr<slot_type[]> old_slots = std::move(m_slots);
+  const size_type old_number_of_slots = m_number_of_slots;
+
+  m_control.reset(new control_type[number_of_slots + detail::GroupSize - 1]);
+  m_slots.reset(new slot_type[number_of_slots]);
+  for (size_type index = 0; index < number_of_slots; ++index)
+  {
+    m_control[index].store(Empty, std::memory_order_relaxed);
+    m_slots[index].store(nullptr, std::memory_order_relaxed);
+  }
+
+  for (size_type index = number_of_slots; index < number_of_slots + detail::GroupSize - 1; ++index)
+  {
+    m_control[index].store(Deleted, std::memory_order_relaxed);
+  }
+
+  m_number_of_slots = number_of_slots;
+  m_slots_mask = number_of_slots - 1;
+  m_number_of_elements = 0;
+  m_number_of_deleted = 0;
+
+  // The overflow set cannot be resized while it is used, so it is given enough buckets beforehand.
+  std::vector<Key*> overflow(m_overflow.begin(), m_overflow.end());
+  m_overflow.clear();
+  m_overflow.rehash(number_of_slots / detail::GroupSize);
+
+  // Put the elements in the new table, including the ones that were stored in the overflow set.
+  for (size_type index = 0; index < old_number_of_slots; ++index)
+  {
+    if (is_full(old_control[index].load(std::memory_order_relaxed)))
+    {
+      insert_unique(old_slots[index].load(std::memory_order_relaxed));
+    }
+  }
+
+  for (Key* key : overflow)
+  {
+    insert_unique(key);
+  }
+}
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+void MCRL2_OPEN_ADDRESSING_SET_CLASS::reserve(size_type count)
+{
+  if (count > capacity())
+  {
+    rehash(count + count / 7 + 1);
+  }
+}
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+void MCRL2_OPEN_ADDRESSING_SET_CLASS::rehash_if_needed()
+{
+  // Tombstones and the overflow set make probing slower as well, so they count towards the load.
+  if (size() + m_number_of_deleted >= capacity())
+  {
+    // When most of the load consists of tombstones the table is only cleaned up.
+    rehash(size() >= m_number_of_slots / 2 ? m_number_of_slots * 2 : m_number_of_slots);
+  }
+}
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+std::size_t MCRL2_OPEN_ADDRESSING_SET_CLASS::probe_length(const key_type& key) const
+{
+  const std::uint64_t hash_value = hash(key);
+  size_type position = first_position(hash_value);
+
+  for (size_type i = 0; i < maximum_probe_length(); ++i)
+  {
+    for (std::uint32_t mask = detail::match_group(&m_control[position], hash_fragment(hash_value)); mask != 0; mask &= mask - 1)
+    {
+      if (m_slots[position + detail::lowest_bit(mask)].load(std::memory_order_relaxed) == &key)
+      {
+        return i + 1;
+      }
+    }
+
+    position = next_position(position, i);
+  }
+
+  return 0;
+}
+
+template<typename Key, typename Hash, typename Equals, typename Allocator, bool ThreadSafe, bool Resize>
+void print_performance_statistics(const open_addressing_set<Key, Hash, Equals, Allocator, ThreadSafe, Resize>& set)
+{
+  // Calculate a histogram of the number of groups that must be probed to find each key.
+  std::vector<std::size_t> histogram;
+
+  for (const Key& key : set)
+  {
+    std::size_t length = set.probe_length(key);
+    histogram.resize(std::max(histogram.size(), length + 1));
+    ++histogram[length];
+  }
+
+  mCRL2log(mcrl2::log::info, "Performance") << "Table stores " << set.size() << " keys in " << set.bucket_count() << " slots, "
+                                            << set.deleted_count() << " slots are deleted and " << set.overflow_count() << " keys overflowed.\n";
+
+  for (std::size_t i = 1; i < histogram.size(); ++i)
+  {
+    mCRL2log(mcrl2::log::debug, "Performance") << "There are " << histogram[i] << " keys that are found in group " << i << " of their probe sequence.\n";
+  }
+}
+
+/// Private functions
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+template<typename ...Args>
+auto MCRL2_OPEN_ADDRESSING_SET_CLASS::find_impl(std::uint64_t hash, const Args&... args) const -> const_iterator
+{
+  const std::uint8_t fragment = hash_fragment(hash);
+  size_type position = first_position(hash);
+
+  for (size_type i = 0; i < maximum_probe_length(); ++i)
+  {
+    for (std::uint32_t mask = detail::match_group(&m_control[position], fragment); mask != 0; mask &= mask - 1)
+    {
+      // The acquire ensures that the element of a slot that was inserted concurrently is visible.
+      const size_type index = position + detail::lowest_bit(mask);
+      if (m_control[index].load(std::memory_order_acquire) == fragment
+          && m_equals(*m_slots[index].load(std::memory_order_relaxed), args...))
+      {
+        return const_iterator(this, index, typename overflow_set::const_iterator());
+      }
+    }
+
+    if (detail::match_group(&m_control[position], Empty) != 0)
+    {
+      // Elements are inserted in the first group with an empty slot, so the element does not exist.
+      return end();
+    }
+
+    position = next_position(position, i);
+  }
+
+  // All probed groups are full, so the element might have been put in the overflow set.
+  if (!m_overflow.empty())
+  {
+    auto it = m_overflow.find(args...);
+    if (it != m_overflow.end())
+    {
+      return const_iterator(this, m_number_of_slots, it);
+    }
+  }
+
+  return end();
+}
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+template<typename Construct, typename ...Args>
+auto MCRL2_OPEN_ADDRESSING_SET_CLASS::emplace_impl(std::uint64_t hash, Construct construct_key, const Args&... args) -> std::pair<iterator, bool>
+{
+  const std::uint8_t fragment = hash_fragment(hash);
+  size_type position = first_position(hash);
+
+  for (size_type i = 0; i < maximum_probe_length(); ++i)
+  {
+    // First compare the elements in this group, including the ones that are being inserted.
+    for (std::uint32_t mask = detail::match_group(&m_control[position], fragment) | detail::match_group(&m_control[position], Busy); mask != 0; mask &= mask - 1)
+    {
+      const size_type index = position + detail::lowest_bit(mask);
+      if (wait_until_inserted(index) == fragment
+          && m_equals(*m_slots[index].load(std::memory_order_relaxed), args...))
+      {
+        return std::make_pair(iterator(this, index, typename overflow_set::const_iterator()), false);
+      }
+    }
+
+    // Then claim the first empty slot. A slot that is claimed by another thread in the meantime might contain
+    // the same element, so it is compared after that insertion has finished.
+    for (std::uint32_t mask = detail::match_group(&m_control[position], Empty); mask != 0; mask &= mask - 1)
+    {
+      const size_type index = position + detail::lowest_bit(mask);
+
+      std::uint8_t control = Empty;
+      while (control == Empty && !m_control[index].compare_exchange_weak(control, Busy, std::memory_order_acquire, std::memory_order_relaxed))
+      {}
+
+      if (control == Empty)
+      {
+        Key* key;
+        try
+        {
+          key = construct_key();
+        }
+        catch (...)
+        {
+          m_control[index].store(Deleted, std::memory_order_release);
+          ++m_number_of_deleted;
+          throw;
+        }
+
+        // Publish the element, which is visible to threads that observe the control byte with an acquire.
+        m_slots[index].store(key, std::memory_order_relaxed);
+        m_control[index].store(fragment, std::memory_order_release);
+        if constexpr (ThreadSafe)
+        {
+          m_number_of_elements.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+          ++m_number_of_elements;
+        }
+        return std::make_pair(iterator(this, index, typename overflow_set::const_iterator()), true);
+      }
+
+      if ((control == Busy ? wait_until_inserted(index) : control) == fragment
+          && m_equals(*m_slots[index].load(std::memory_order_relaxed), args...))
+      {
+        return std::make_pair(iterator(this, index, typename overflow_set::const_iterator()), false);
+      }
+    }
+
+    position = next_position(position, i);
+  }
+
+  // The probed groups are full, which only happens when the table could not be resized in time.
+  Key* key = construct_key();
+  auto [it, added] = m_overflow.emplace(key);
+  if (!added)
+  {
+    destroy(key);
+  }
+
+  return std::make_pair(iterator(this, m_number_of_slots, it), added);
+}
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+std::uint8_t MCRL2_OPEN_ADDRESSING_SET_CLASS::wait_until_inserted(size_type index) const
+{
+  std::uint8_t control = m_control[index].load(std::memory_order_acquire);
+  while (control == Busy)
+  {
+    control = m_control[index].load(std::memory_order_acquire);
+  }
+
+  return control;
+}
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+template<typename ...Args>
+void MCRL2_OPEN_ADDRESSING_SET_CLASS::erase_impl(const Args&... args)
+{
+  const_iterator it = find(args...);
+  if (it != end())
+  {
+    erase(it);
+  }
+}
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+void MCRL2_OPEN_ADDRESSING_SET_CLASS::erase_slot(size_type index)
+{
+  assert(is_full(m_control[index].load(std::memory_order_relaxed)));
+  destroy(m_slots[index].load(std::memory_order_relaxed));
+  m_slots[index].store(nullptr, std::memory_order_relaxed);
+  --m_number_of_elements;
+
+  // The slot cannot become empty, because probe sequences that pass this slot must continue. The tombstones are
+  // removed when the table is rehashed.
+  m_control[index].store(Deleted, std::memory_order_relaxed);
+  ++m_number_of_deleted;
+}
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+template<typename ...Args>
+Key* MCRL2_OPEN_ADDRESSING_SET_CLASS::construct(Args&&... args)
+{
+  Key* key = detail::allocate(m_allocator, args...);
+  try
+  {
+    std::allocator_traits<allocator_type>::construct(m_allocator, key, std::forward<Args>(args)...);
+  }
+  catch (...)
+  {
+    std::allocator_traits<allocator_type>::deallocate(m_allocator, key, 1);
+    throw;
+  }
+
+  return key;
+}
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+void MCRL2_OPEN_ADDRESSING_SET_CLASS::destroy(Key* key)
+{
+  std::allocator_traits<allocator_type>::destroy(m_allocator, key);
+  std::allocator_traits<allocator_type>::deallocate(m_allocator, key, 1);
+}
+
+MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+void MCRL2_OPEN_ADDRESSING_SET_CLASS::insert_unique(Key* key)
+{
+  const std::uint64_t hash_value = hash(*key);
+  size_type position = first_position(hash_value);
+
+  for (size_type i = 0; i < maximum_probe_length(); ++i)
+  {
+    std::uint32_t mask = detail::match_group(&m_control[position], Empty);
+    if (mask != 0)
+    {
+      const size_type index = position + detail::lowest_bit(mask);
+      m_slots[index].store(key, std::memory_order_relaxed);
+      m_control[index].store(hash_fragment(hash_value), std::memory_order_relaxed);
+      ++m_number_of_elements;
+      return;
+    }
+
+    position = next_position(position, i);
+  }
+
+  m_overflow.emplace(key);
+}
+
+#undef MCRL2_OPEN_ADDRESSING_SET_CLASS
+#undef MCRL2_OPEN_ADDRESSING_SET_TEMPLATES
+
+} // namespace mcrl2::utilities
+
+#endif // MCRL2_UTILITIES_OPEN_ADDRESSING_SET_IMPLEMENTATION_H
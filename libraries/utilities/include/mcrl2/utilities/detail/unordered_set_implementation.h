@@ -112,6 +112,14 @@ auto MCRL2_UNORDERED_SET_CLASS::emplace(Args&&... args) -> std::pair<iterator, b
   }
 }
 
+MCRL2_UNORDERED_SET_TEMPLATES
+void MCRL2_UNORDERED_SET_CLASS::insert_external(Key& key)
+{
+  assert(find(key) == end());
+  m_buckets[find_bucket_index(key)].push_front_external(key);
+  ++m_number_of_elements;
+}
+
 MCRL2_UNORDERED_SET_TEMPLATES
 auto MCRL2_UNORDERED_SET_CLASS::erase(typename MCRL2_UNORDERED_SET_CLASS::const_iterator it) -> iterator
 {
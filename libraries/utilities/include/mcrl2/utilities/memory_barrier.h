@@ -0,0 +1,53 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef MCRL2_UTILITIES_MEMORY_BARRIER_H_
+#define MCRL2_UTILITIES_MEMORY_BARRIER_H_
+
+#include <atomic>
+
+namespace mcrl2::utilities
+{
+
+namespace detail
+{
+
+/// \brief True iff heavy_memory_barrier() executes a memory barrier on all running threads of this process.
+/// \details This is constant initialised to false, and only set once during the initialisation of the utilities
+///          library, before any other threads exist.
+extern bool g_process_wide_barrier;
+
+} // namespace detail
+
+/// \brief A memory barrier that is cheap, but only orders a store before a subsequent load of this thread
+///        with respect to threads that execute a heavy_memory_barrier().
+/// \details This is the fast side of an asymmetric Dekker style protocol: the thread that stores to its own flag and
+///          then loads a flag of another thread uses the light barrier, and the other thread that stores and then
+///          loads in the opposite order uses the heavy barrier. If the operating system offers no process wide
+///          memory barrier this is a sequentially consistent fence.
+inline void light_memory_barrier()
+{
+  if (detail::g_process_wide_barrier)
+  {
+    // Only prevent the compiler from reordering, the heavy barrier orders the processor.
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+  }
+  else
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+}
+
+/// \brief A memory barrier that is expensive, because it interrupts all threads of the process, which pairs with
+///        light_memory_barrier().
+void heavy_memory_barrier();
+
+} // namespace mcrl2::utilities
+
+#endif // MCRL2_UTILITIES_MEMORY_BARRIER_H_
@@ -0,0 +1,457 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef MCRL2_UTILITIES_OPEN_ADDRESSING_SET_H
+#define MCRL2_UTILITIES_OPEN_ADDRESSING_SET_H
+
+#include "mcrl2/utilities/unordered_set.h"
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MCRL2_OPEN_ADDRESSING_SET_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace mcrl2::utilities
+{
+
+namespace detail
+{
+
+/// \brief The number of control bytes that are compared at once, which is the width of an SSE2 register.
+constexpr static std::size_t GroupSize = 16;
+
+/// \returns A mask in which bit i is set iff the i-th of the GroupSize control bytes starting at group is equal to value.
+/// \details The control bytes do not have to be aligned.
+inline std::uint32_t match_group(const std::atomic<std::uint8_t>* group, std::uint8_t value)
+{
+  static_assert(sizeof(std::atomic<std::uint8_t>) == 1, "The control bytes must be stored contiguously.");
+
+#ifdef MCRL2_OPEN_ADDRESSING_SET_SSE2
+  // Compare all bytes at once. Concurrent changes of individual bytes are checked again by the caller.
+  __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+  return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(value)))));
+#else
+  std::uint32_t mask = 0;
+  for (std::size_t i = 0; i < GroupSize; ++i)
+  {
+    if (group[i].load(std::memory_order_relaxed) == value)
+    {
+      mask |= std::uint32_t(1) << i;
+    }
+  }
+  return mask;
+#endif
+}
+
+/// \returns The index of the lowest bit that is set in the given non-zero mask.
+inline std::size_t lowest_bit(std::uint32_t mask)
+{
+  assert(mask != 0);
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return index;
+#else
+  return static_cast<std::size_t>(__builtin_ctz(mask));
+#endif
+}
+
+} // namespace detail
+
+/// \brief An unordered set with the interface of unordered_set, which uses open addressing instead of bucket lists.
+/// \details The table consists of slots that point to the elements, which are allocated individually such
+///          that they are never moved, and one control byte per slot. The control byte of a slot that contains
+///          an element stores seven bits of its hash. The table is probed in groups of GroupSize consecutive
+///          slots, whose control bytes are compared with a single SSE2 instruction if available. Only the elements
+///          whose hash fragment matches have to be compared, which avoids most of the cache misses that are
+///          caused by following the pointers of a bucket list. The groups are probed quadratically.
+///
+///          With ThreadSafe, emplace can be called concurrently. A new element is inserted by claiming an empty
+///          slot with a compare-and-swap on its control byte, after which the control byte is set to the hash
+///          fragment. As slots are claimed in the order of the probe sequence, two threads that insert the same
+///          element always meet in the same slot. All other operations require exclusive access.
+///
+///          When the table cannot be resized, because Resize is false, it can become full. Elements that do not
+///          fit in the first MaximumProbeLength groups of their probe sequence are stored in an overflow set,
+///          until the next call to rehash_if_needed moves them back into the table.
+template<typename Key,
+         typename Hash = std::hash<Key>,
+         typename Equals = std::equal_to<Key>,
+         typename Allocator = std::allocator<Key>,
+         bool ThreadSafe = false,
+         bool Resize = true>
+class open_addressing_set
+{
+  static_assert (!(ThreadSafe && Resize), "ThreadSafe cannot be enabled together with automatic resizing.");
+
+private:
+  using control_type = std::atomic<std::uint8_t>;
+  using slot_type = std::atomic<Key*>;
+
+  /// \brief The hash and equality of the elements in the overflow set, which stores pointers to the elements.
+  struct overflow_hash
+  {
+    using is_transparent = void;
+
+    std::size_t operator()(Key* const& key) const { return m_hash(*key); }
+
+    template<typename ...Args>
+    std::size_t operator()(const Args&... args) const { return m_hash(args...); }
+
+    Hash m_hash;
+  };
+
+  struct overflow_equals
+  {
+    using is_transparent = void;
+
+    bool operator()(Key* const& first, Key* const& second) const { return m_equals(*first, *second); }
+
+    template<typename ...Args>
+    bool operator()(Key* const& key, const Args&... args) const { return m_equals(*key, args...); }
+
+    Equals m_equals;
+  };
+
+  using overflow_set = unordered_set<Key*, overflow_hash, overflow_equals, std::allocator<Key*>, ThreadSafe, false>;
+  using counter_type = std::conditional_t<ThreadSafe, std::atomic<std::size_t>, std::size_t>;
+
+public:
+  /// \brief An iterator over all elements in the set, which visits the elements in the table before the elements in the overflow set.
+  template<bool Constant>
+  class open_addressing_set_iterator
+  {
+  private:
+    friend class open_addressing_set;
+
+  public:
+    using value_type = Key;
+    using reference = typename std::conditional<Constant, const Key&, Key&>::type;
+    using pointer = typename std::conditional<Constant, const Key*, Key*>::type;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::forward_iterator_tag;
+
+    open_addressing_set_iterator() = default;
+
+    open_addressing_set_iterator& operator++()
+    {
+      if (m_index < m_set->m_number_of_slots)
+      {
+        ++m_index;
+        goto_next_element();
+      }
+      else
+      {
+        ++m_overflow_it;
+      }
+      return *this;
+    }
+
+    open_addressing_set_iterator operator++(int)
+    {
+      open_addressing_set_iterator copy(*this);
+      ++(*this);
+      return copy;
+    }
+
+    reference operator*() const
+    {
+      return *operator->();
+    }
+
+    pointer operator->() const
+    {
+      if (m_index < m_set->m_number_of_slots)
+      {
+        return m_set->m_slots[m_index].load(std::memory_order_relaxed);
+      }
+      return *m_overflow_it;
+    }
+
+    bool operator==(const open_addressing_set_iterator& other) const
+    {
+      return m_index == other.m_index && (m_index < m_set->m_number_of_slots || m_overflow_it == other.m_overflow_it);
+    }
+
+    bool operator!=(const open_addressing_set_iterator& other) const
+    {
+      return !(*this == other);
+    }
+
+  private:
+    using overflow_iterator = typename overflow_set::const_iterator;
+
+    open_addressing_set_iterator(const open_addressing_set* set, std::size_t index, overflow_iterator overflow_it)
+      : m_set(set),
+        m_index(index),
+        m_overflow_it(overflow_it)
+    {}
+
+    /// \brief Moves to the first slot at or after the current index that contains an element, or to the overflow set.
+    void goto_next_element()
+    {
+      while (m_index < m_set->m_number_of_slots && !is_full(m_set->m_control[m_index].load(std::memory_order_relaxed)))
+      {
+        ++m_index;
+      }
+
+      if (m_index == m_set->m_number_of_slots)
+      {
+        m_overflow_it = m_set->m_overflow.begin();
+      }
+    }
+
+    const open_addressing_set* m_set = nullptr;
+    std::size_t m_index = 0;          ///< The current slot, or the number of slots when iterating over the overflow set.
+    overflow_iterator m_overflow_it;
+  };
+
+  using key_type = Key;
+  using value_type = Key;
+  using hasher = Hash;
+  using key_equal = Equals;
+  using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<Key>;
+
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = typename std::allocator_traits<Allocator>::pointer;
+  using const_pointer = typename std::allocator_traits<Allocator>::const_pointer;
+
+  using const_iterator = open_addressing_set_iterator<true>;
+  using iterator = const_iterator;
+
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  open_addressing_set() { rehash(0); }
+
+  /// \brief Constructs an open_addressing_set that can contain at least number_of_elements elements without resizing.
+  explicit open_addressing_set(size_type number_of_elements,
+    const hasher& hash = hasher(),
+    const key_equal& equals = key_equal())
+    : m_overflow(0, overflow_hash{hash}, overflow_equals{equals}),
+      m_hash(hash),
+      m_equals(equals)
+  {
+    reserve(number_of_elements);
+  }
+
+  // Copy operators.
+  open_addressing_set(const open_addressing_set& set);
+  open_addressing_set& operator=(const open_addressing_set& set);
+
+  // Default move operators.
+  open_addressing_set(open_addressing_set&& other) = default;
+  open_addressing_set& operator=(open_addressing_set&& other) = default;
+
+  ~open_addressing_set();
+
+  /// \returns A reference to the local node allocator.
+  const allocator_type& get_allocator() const noexcept { return m_allocator; }
+  allocator_type& get_allocator() noexcept { return m_allocator; }
+
+  /// \returns An iterator over all keys.
+  iterator begin() { return cbegin(); }
+  iterator end() { return cend(); }
+
+  /// \returns A const iterator over all keys.
+  const_iterator begin() const { return cbegin(); }
+  const_iterator end() const { return cend(); }
+
+  /// \returns A const iterator over all keys.
+  const_iterator cbegin() const;
+  const_iterator cend() const { return const_iterator(this, m_number_of_slots, m_overflow.end()); }
+
+  /// \returns True iff the set is empty.
+  bool empty() const noexcept { return size() == 0; }
+
+  /// \returns The amount of elements stored in this set.
+  size_type size() const noexcept { return m_number_of_elements + m_overflow.size(); }
+  size_type max_size() const noexcept { return std::numeric_limits<std::uint32_t>::max(); }
+
+  /// \brief Removes all elements from the set.
+  /// \details Does not free the table itself.
+  void clear();
+
+  /// \brief Inserts an element Key(args...) into the set if it did not already exist.
+  /// \returns A pair of the iterator pointing to the element and a boolean that is true iff
+  ///         a new element was inserted (as opposed to it already existing in the set).
+  /// \threadsafe
+  template<typename ...Args>
+  std::pair<iterator, bool> emplace(Args&&... args);
+
+  /// \brief The number of bytes before an element that is inserted by insert_external, which this set uses for its own
+  ///        administration.
+  static constexpr size_type external_key_offset = 0;
+
+  /// \brief Inserts an element that does not exist in the set yet, which has been constructed in memory that is owned
+  ///        by the caller.
+  /// \details The element is never destroyed or deallocated by the set, so it must not be erased. Not threadsafe.
+  void insert_external(Key& key) { insert_unique(&key); }
+
+  /// \brief Erases the given key_type(args...) from the set.
+  template<typename...Args>
+  void erase(const Args&... args);
+
+  /// \brief Erases the element pointed to by the iterator.
+  /// \returns An iterator to the next key.
+  iterator erase(const_iterator it);
+
+  /// \brief Counts the number of occurrences of the given key (1 when it exists and 0 otherwise).
+  template<typename ...Args>
+  size_type count(const Args&... args) const;
+
+  /// \brief Searches whether an object key_type(args...) occurs in the set.
+  /// \returns An iterator to the matching element or the end when this object does not exist.
+  template<typename...Args>
+  const_iterator find(const Args&... args) const;
+
+  /// \returns The number of slots.
+  size_type bucket_count() const noexcept { return m_number_of_slots; }
+
+  float load_factor() const { return static_cast<float>(size()) / bucket_count(); }
+  float max_load_factor() const { return 0.875f; }
+
+  /// \brief Resizes the table to at least the given number of slots, and removes the tombstones of erased elements.
+  void rehash(size_type number_of_slots);
+
+  /// \brief Resizes the set such that it can contain the given number of elements.
+  void reserve(size_type count);
+
+  hasher hash_function() const { return m_hash; }
+  key_equal key_eq() const { return m_equals; }
+
+  /// \returns The number of elements that can be present in the set before resizing.
+  /// \details Not standard.
+  size_type capacity() const noexcept { return m_number_of_slots - m_number_of_slots / 8; }
+
+  /// \brief Resizes the hash table if necessary, which also moves the elements of the overflow set into the table.
+  /// \details Not standard.
+  void rehash_if_needed();
+
+  /// \returns The number of slots that are occupied by the tombstones of erased elements.
+  /// \details Not standard.
+  size_type deleted_count() const noexcept { return m_number_of_deleted; }
+
+  /// \returns The number of elements that are stored in the overflow set.
+  /// \details Not standard.
+  size_type overflow_count() const noexcept { return m_overflow.size(); }
+
+  /// \returns The number of groups that must be probed to find the given element, or zero if it is stored in the overflow set.
+  /// \details Not standard.
+  size_type probe_length(const key_type& key) const;
+
+private:
+  /// \brief The control bytes of slots that do not contain an element, whose highest bit is set. The control
+  ///        byte of a slot that contains an element is the hash fragment of that element.
+  static constexpr std::uint8_t Empty = 0x80;
+  static constexpr std::uint8_t Deleted = 0xFE;
+  static constexpr std::uint8_t Busy = 0xFF; ///< The slot has been claimed by an insertion that is not finished.
+
+  /// \brief The number of groups of the probe sequence that are searched before the overflow set is used.
+  static constexpr size_type MaximumProbeLength = 8;
+
+  /// \returns True iff the given control byte belongs to a slot that contains an element.
+  static bool is_full(std::uint8_t control) { return (control & 0x80) == 0; }
+
+  /// \returns The hash of the given key.
+  template<typename ...Args>
+  std::uint64_t hash(const Args&... args) const { return static_cast<std::uint64_t>(m_hash(args...)); }
+
+  /// \returns The hash fragment that is stored in the control byte, which consists of seven bits of the hash after
+  ///          they have been spread by a multiplication.
+  static std::uint8_t hash_fragment(std::uint64_t hash) { return static_cast<std::uint8_t>((hash * 0x9E3779B97F4A7C15ull) >> 57); }
+
+  /// \returns The first slot of the first group of the probe sequence, where groups can start at any slot.
+  /// \details The hash is used directly, as for the bucket lists of unordered_set, because the hashes of terms that
+  ///          are created after each other are often close, which keeps their slots close together in memory.
+  size_type first_position(std::uint64_t hash) const { return static_cast<size_type>(hash) & m_slots_mask; }
+
+  /// \returns The first slot of the next group of the probe sequence.
+  size_type next_position(size_type position, size_type i) const { return (position + (i + 1) * detail::GroupSize) & m_slots_mask; }
+
+  /// \returns The number of groups of the probe sequence that are searched before the overflow set is used.
+  size_type maximum_probe_length() const { return std::min(MaximumProbeLength, m_number_of_slots / detail::GroupSize); }
+
+  /// \brief Searches for the element in the probe sequence of the given hash and in the overflow set.
+  template<typename ...Args>
+  const_iterator find_impl(std::uint64_t hash, const Args&... args) const;
+
+  /// \brief Searches for the element that is equal to args... in the probe sequence of the given hash, and
+  ///        otherwise inserts the element returned by construct_key() in the first empty slot or in the
+  ///        overflow set if the probed groups are full.
+  /// \details Calls construct_key at most once, and destroys the constructed element if it turns out to exist already.
+  /// \threadsafe
+  template<typename Construct, typename ...Args>
+  std::pair<iterator, bool> emplace_impl(std::uint64_t hash, Construct construct_key, const Args&... args);
+
+  /// \brief Waits until the insertion into the given slot has finished.
+  /// \returns The control byte of the slot, which is not Busy.
+  std::uint8_t wait_until_inserted(size_type index) const;
+
+  /// \brief Removes T(args...) from the set.
+  template<typename ...Args>
+  void erase_impl(const Args&... args);
+
+  /// \brief Removes the element in the given slot, and destroys it.
+  void erase_slot(size_type index);
+
+  /// \brief Allocates and constructs a new element from the given arguments.
+  template<typename ...Args>
+  Key* construct(Args&&... args);
+
+  /// \brief Destroys and deallocates the given element.
+  void destroy(Key* key);
+
+  /// \brief Puts an element in the first empty slot of its probe sequence, which requires exclusive access and
+  ///        that such a slot exists.
+  void insert_unique(Key* key);
+
+  /// \brief True iff the hash and equals functions allow transparent lookup,
+  static constexpr bool allow_transparent = detail::is_transparent<Hash>() && detail::is_transparent<Equals>();
+
+  /// \brief The control byte of every slot, followed by GroupSize - 1 control bytes that are always Deleted such
+  ///        that a group starting at the last slots can be compared at once.
+  std::unique_ptr<control_type[]> m_control;
+
+  /// \brief The element of every slot that is full.
+  std::unique_ptr<slot_type[]> m_slots;
+
+  size_type m_number_of_slots = 0;
+
+  /// \brief Always equal to m_number_of_slots - 1.
+  size_type m_slots_mask = 0;
+
+  /// \brief The number of elements stored in the table, excluding the overflow set.
+  counter_type m_number_of_elements = 0;
+
+  /// \brief The number of slots that are marked as deleted.
+  counter_type m_number_of_deleted = 0;
+
+  /// \brief The elements that did not fit in the table.
+  overflow_set m_overflow;
+
+  hasher m_hash = hasher();
+  key_equal m_equals = key_equal();
+  allocator_type m_allocator;
+};
+
+} // namespace mcrl2::utilities
+
+#include "mcrl2/utilities/detail/open_addressing_set_implementation.h"
+
+#endif // MCRL2_UTILITIES_OPEN_ADDRESSING_SET_H
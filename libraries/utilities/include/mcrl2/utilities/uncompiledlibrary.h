@@ -115,6 +115,15 @@ class uncompiled_library : public dynamic_library
       m_filename = m_tempfiles.back();
     }
 
+    /// \brief Uses a library that has been compiled before, instead of compiling the source file.
+    /// \details The source file and the library are removed by cleanup().
+    void use_precompiled(const std::string& filename, const std::string& library)
+    {
+      m_tempfiles.push_back(filename);
+      m_tempfiles.push_back(library);
+      m_filename = library;
+    }
+
     void leave_files()
     {
       m_tempfiles.clear();
@@ -285,6 +285,15 @@ public:
   template<typename ...Args>
   std::pair<iterator, bool> emplace(Args&&... args);
 
+  /// \brief The number of bytes before an element that is inserted by insert_external, which this set uses for its own
+  ///        administration.
+  static constexpr size_type external_key_offset = bucket_type::key_offset;
+
+  /// \brief Inserts an element that does not exist in the set yet, which has been constructed external_key_offset
+  ///        bytes after the start of memory that is owned by the caller.
+  /// \details The element is never destroyed or deallocated by the set, so it must not be erased. Not threadsafe.
+  void insert_external(Key& key);
+
   /// \brief Erases the given key_type(args...) from the unordered set.
   template<typename...Args>
   void erase(const Args&... args);
@@ -15,6 +15,9 @@
 #include "mcrl2/utilities/power_of_two.h"
 #include "mcrl2/utilities/platform.h"
 
+#include <algorithm>
+#include <iostream>
+
 #ifdef MCRL2_PLATFORM_WINDOWS
 #include <io.h>
 #include <fcntl.h>
@@ -70,7 +73,7 @@ int_t decode_variablesize_int(ibitstream& stream)
       // If the next-byte flag is not set then we are finished.
       break;
     }
-    else if (i == sizeof(int_t))
+    else if (i + 1 == integer_encoding_size<int_t>())
     {
       // The next-byte flag was set, but we cannot represent it using int_t.
       throw std::runtime_error("Fail to read an int from the input");
@@ -112,29 +115,31 @@ obitstream::obitstream(std::ostream& stream)
   }
 }
 
-void obitstream::write_bits(std::size_t value, unsigned int number_of_bits)
+void obitstream::write_bits_slow(std::size_t value, unsigned int number_of_bits)
 {
-  // Add val to the buffer by masking out additional bits and put them at left-most position free in the buffer.
-  write_buffer |= std::bitset<128>(value & ((static_cast<std::size_t>(1) << number_of_bits) - 1)) << ((128 - bits_in_buffer) - number_of_bits);
-  bits_in_buffer += number_of_bits;
+  if (number_of_bits == 0)
+  {
+    return;
+  }
 
-  // Write 8 bytes if available
-  if (bits_in_buffer >= 64)
+  // Mask out the additional bits, and determine how many of them do not fit in the buffer.
+  if (number_of_bits < 64)
   {
-    unsigned long long write_value = (write_buffer >> 64).to_ullong();
-    write_buffer <<= 64;
-    bits_in_buffer -= 64;
+    value &= (std::uint64_t(1) << number_of_bits) - 1;
+  }
+  unsigned int remaining_bits = bits_in_buffer + number_of_bits - 64;
 
-    for (int32_t i = 7; i >= 0; --i)
-    {
-      // Write the 8 * i most significant bits and mask out the other values.
-      stream.put(static_cast<char>((write_value >> (8 * i)) & 255));
+  // Complete the buffer with the most significant bits and start a new buffer with the remaining bits.
+  write_word(write_buffer | (value >> remaining_bits));
+  write_buffer = remaining_bits == 0 ? 0 : value << (64 - remaining_bits);
+  bits_in_buffer = remaining_bits;
+}
 
-      if (stream.fail())
-      {
-        throw mcrl2::runtime_error("Failed to write bytes to the output file/stream.");
-      }
-    }
+void obitstream::write_bits(const std::size_t* values, std::size_t count, unsigned int number_of_bits)
+{
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    write_bits(values[i], number_of_bits);
   }
 }
 
@@ -149,6 +154,13 @@ void obitstream::write_string(const std::string& string)
 
 void obitstream::write_integer(std::size_t val)
 {
+  if (val < 128)
+  {
+    // The encoding is a single byte without the next byte flag.
+    write_bits(val, 8);
+    return;
+  }
+
   std::size_t nr_bytes = encode_variablesize_int(val, integer_buffer);
 
   write(integer_buffer, nr_bytes);
@@ -184,40 +196,56 @@ const char* ibitstream::read_string()
   return m_text_buffer.data();
 }
 
-std::size_t ibitstream::read_bits(unsigned int number_of_bits)
+std::size_t ibitstream::read_bits_slow(unsigned int number_of_bits)
 {
-  // Read at most the number of bits of a std::size_t.
-  assert(number_of_bits <= std::numeric_limits<std::size_t>::digits);
-
-  while (bits_in_buffer < number_of_bits)
+  if (number_of_bits <= bits_in_buffer)
   {
-    // Read bytes until the buffer is sufficiently full.
-    int byte = stream.get();
-
-    if (stream.eof())
+    // Either no bits are read or exactly the bits in the buffer.
+    if (number_of_bits == 0)
     {
-      throw mcrl2::runtime_error("Unexpected end-of-file reached in the input file/stream.");
-    }
-    else if (stream.fail())
-    {
-      throw mcrl2::runtime_error("Failed to read bytes from the input file/stream.");
+      return 0;
     }
 
-    // Shift the 8 bits to the first free (120 - bits_in_buffer) position in the buffer.
-    read_buffer |= std::bitset<128>(static_cast<std::size_t>(byte)) << (56 + 64 - bits_in_buffer);
-    bits_in_buffer += 8;
+    std::size_t value = read_buffer >> (64 - number_of_bits);
+    read_buffer = number_of_bits == 64 ? 0 : read_buffer << number_of_bits;
+    bits_in_buffer -= number_of_bits;
+    return value;
   }
 
-  // Read nr_bits from the buffer by shifting them to the least significant bits and masking out the remaining bits.
-  std::size_t value = (read_buffer >> (128 - number_of_bits)).to_ullong();
+  // Take the bits that remain in the buffer, and the other bits from the next word.
+  std::size_t value = bits_in_buffer == 0 ? 0 : read_buffer >> (64 - bits_in_buffer);
+  unsigned int remaining_bits = number_of_bits - bits_in_buffer;
+  bits_in_buffer = 0;
+
+  read_word();
+  if (remaining_bits > bits_in_buffer)
+  {
+    throw mcrl2::runtime_error("Unexpected end-of-file reached in the input file/stream.");
+  }
 
-  // Shift the first bit to the first position in the buffer.
-  read_buffer <<= number_of_bits;
-  bits_in_buffer -= number_of_bits;
+  if (remaining_bits == 64)
+  {
+    value = read_buffer;
+    read_buffer = 0;
+  }
+  else
+  {
+    value = (value << remaining_bits) | (read_buffer >> (64 - remaining_bits));
+    read_buffer <<= remaining_bits;
+  }
+  bits_in_buffer -= remaining_bits;
 
   return value;
 }
 
+void ibitstream::read_bits(std::size_t* values, std::size_t count, unsigned int number_of_bits)
+{
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    values[i] = read_bits(number_of_bits);
+  }
+}
+
 std::size_t ibitstream::read_integer()
 {
   return decode_variablesize_int(*this);
@@ -227,9 +255,11 @@ std::size_t ibitstream::read_integer()
 
 void obitstream::flush()
 {
-  // Writing the buffer full to 64 bits should flush it internally, this also guarantees that the unnecessary bits are zeroed out.
-  write_bits(0, 64 - bits_in_buffer);
-  assert(bits_in_buffer == 0);
+  // The buffer is always written as a full word, which guarantees that the unnecessary bits are zeroed out.
+  write_word(write_buffer);
+  write_buffer = 0;
+  bits_in_buffer = 0;
+  write_output();
 
   stream.flush();
   if (stream.fail())
@@ -238,21 +268,83 @@ void obitstream::flush()
   }
 }
 
+void obitstream::write_word(std::uint64_t word)
+{
+  if (m_output_size == m_output.size())
+  {
+    write_output();
+  }
+
+  for (int i = 7; i >= 0; --i)
+  {
+    // Write the 8 * i most significant bits and mask out the other values.
+    m_output[m_output_size++] = static_cast<char>((word >> (8 * i)) & 255);
+  }
+}
+
+void obitstream::write_output()
+{
+  stream.write(m_output.data(), static_cast<std::streamsize>(m_output_size));
+  if (stream.fail())
+  {
+    throw mcrl2::runtime_error("Failed to write bytes to the output file/stream.");
+  }
+  m_output_size = 0;
+}
+
 void obitstream::write(const uint8_t* buffer, std::size_t size)
 {
-  for (std::size_t index = 0; index < size; ++index)
+  for (std::size_t index = 0; index < size; index += 8)
   {
-    // Write a single byte for every entry in the buffer that was filled (size).
-    write_bits(buffer[index], 8);
+    // Write up to eight bytes of the buffer at once.
+    std::size_t bytes = std::min<std::size_t>(size - index, 8);
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < bytes; ++i)
+    {
+      value = (value << 8) | buffer[index + i];
+    }
+    write_bits(value, static_cast<unsigned int>(8 * bytes));
   }
 }
 
+void ibitstream::read_word()
+{
+  assert(bits_in_buffer == 0);
+
+  // Read a single word, such that nothing is read from the stream beyond the words that have been written.
+  unsigned char bytes[8] = {};
+  stream.read(reinterpret_cast<char*>(bytes), 8);
+  std::streamsize count = stream.gcount();
+
+  if (count == 0)
+  {
+    if (stream.eof())
+    {
+      throw mcrl2::runtime_error("Unexpected end-of-file reached in the input file/stream.");
+    }
+
+    throw mcrl2::runtime_error("Failed to read bytes from the input file/stream.");
+  }
+
+  read_buffer = 0;
+  for (int i = 0; i < 8; ++i)
+  {
+    read_buffer = (read_buffer << 8) | bytes[i];
+  }
+  bits_in_buffer = static_cast<unsigned int>(8 * count);
+}
+
 void ibitstream::read(std::size_t size, std::uint8_t* buffer)
 {
-  for (std::size_t index = 0; index < size; ++index)
+  for (std::size_t index = 0; index < size; index += 8)
   {
-    // Read a single byte for every entry into the buffer that was filled (size).
-    std::size_t value = read_bits(8);
-    buffer[index] = static_cast<std::uint8_t>(value);
+    // Read up to eight bytes into the buffer at once.
+    std::size_t bytes = std::min<std::size_t>(size - index, 8);
+    std::uint64_t value = read_bits(static_cast<unsigned int>(8 * bytes));
+    for (std::size_t i = bytes; i > 0; --i)
+    {
+      buffer[index + i - 1] = static_cast<std::uint8_t>(value & 255);
+      value >>= 8;
+    }
   }
 }
@@ -0,0 +1,193 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "mcrl2/utilities/block_compression.h"
+
+#include "mcrl2/utilities/exception.h"
+
+#include <cstring>
+
+using namespace mcrl2::utilities;
+
+/// \details A compressed block consists of sequences. Every sequence starts with a token byte of which the four most
+///          significant bits are the number of literal bytes and the four least significant bits the length of the
+///          match minus four. A value of 15 is followed by bytes that are added to it, up to and including the first
+///          byte that is not 255. The literal bytes follow, and then the distance of the match as two bytes in little
+///          endian order. The last sequence has no match, and it ends the block.
+namespace
+{
+
+constexpr std::size_t MinimumMatch = 4;
+constexpr std::size_t MaximumDistance = 65535;
+constexpr unsigned int HashBits = 14;
+
+std::uint32_t load32(const std::uint8_t* pointer)
+{
+  std::uint32_t value;
+  std::memcpy(&value, pointer, sizeof(value));
+  return value;
+}
+
+std::uint32_t hash32(std::uint32_t value)
+{
+  return (value * 2654435761U) >> (32 - HashBits);
+}
+
+/// \brief Appends the part of a length that does not fit in the four bits of the token.
+void write_length(std::vector<std::uint8_t>& output, std::size_t length)
+{
+  if (length >= 15)
+  {
+    length -= 15;
+    while (length >= 255)
+    {
+      output.push_back(255);
+      length -= 255;
+    }
+    output.push_back(static_cast<std::uint8_t>(length));
+  }
+}
+
+/// \brief Appends a sequence of literals followed by a match, if the match length is not zero.
+void write_sequence(std::vector<std::uint8_t>& output,
+  const std::uint8_t* literals,
+  std::size_t number_of_literals,
+  std::size_t distance,
+  std::size_t match_length)
+{
+  const std::size_t match_code = match_length == 0 ? 0 : match_length - MinimumMatch;
+  output.push_back(static_cast<std::uint8_t>((std::min<std::size_t>(number_of_literals, 15) << 4) | std::min<std::size_t>(match_code, 15)));
+  write_length(output, number_of_literals);
+  output.insert(output.end(), literals, literals + number_of_literals);
+
+  if (match_length != 0)
+  {
+    output.push_back(static_cast<std::uint8_t>(distance & 255));
+    output.push_back(static_cast<std::uint8_t>(distance >> 8));
+    write_length(output, match_code);
+  }
+}
+
+} // namespace
+
+std::vector<std::uint8_t> mcrl2::utilities::compress_block(const std::uint8_t* input, std::size_t size)
+{
+  std::vector<std::uint8_t> output;
+  output.reserve(size + size / 255 + 16);
+
+  // The most recent position plus one of every hashed sequence of four bytes, or zero.
+  std::vector<std::size_t> table(std::size_t(1) << HashBits, 0);
+
+  std::size_t anchor = 0;
+  std::size_t position = 0;
+  while (position + MinimumMatch <= size)
+  {
+    const std::uint32_t sequence = load32(input + position);
+    std::size_t& entry = table[hash32(sequence)];
+    const std::size_t candidate = entry;
+    entry = position + 1;
+
+    if (candidate != 0 && position + 1 - candidate <= MaximumDistance && load32(input + candidate - 1) == sequence)
+    {
+      const std::size_t match = candidate - 1;
+      std::size_t length = MinimumMatch;
+      while (position + length < size && input[match + length] == input[position + length])
+      {
+        ++length;
+      }
+
+      write_sequence(output, input + anchor, position - anchor, position - match, length);
+      position += length;
+      anchor = position;
+    }
+    else
+    {
+      ++position;
+    }
+  }
+
+  write_sequence(output, input + anchor, size - anchor, 0, 0);
+  return output;
+}
+
+void mcrl2::utilities::decompress_block(const std::uint8_t* input, std::size_t size, std::uint8_t* output, std::size_t output_size)
+{
+  const std::uint8_t* end = input + size;
+  std::size_t position = 0;
+
+  auto read_length = [&](std::size_t length) -> std::size_t
+  {
+    if (length == 15)
+    {
+      std::uint8_t byte;
+      do
+      {
+        if (input == end)
+        {
+          throw mcrl2::runtime_error("The compressed block is truncated.");
+        }
+        byte = *input++;
+        length += byte;
+      }
+      while (byte == 255);
+    }
+    return length;
+  };
+
+  while (true)
+  {
+    if (input == end)
+    {
+      throw mcrl2::runtime_error("The compressed block is truncated.");
+    }
+
+    const std::uint8_t token = *input++;
+    const std::size_t number_of_literals = read_length(token >> 4);
+    if (static_cast<std::size_t>(end - input) < number_of_literals || output_size - position < number_of_literals)
+    {
+      throw mcrl2::runtime_error("The compressed block is corrupt.");
+    }
+
+    std::memcpy(output + position, input, number_of_literals);
+    input += number_of_literals;
+    position += number_of_literals;
+
+    if (input == end)
+    {
+      // The last sequence has no match.
+      break;
+    }
+
+    if (end - input < 2)
+    {
+      throw mcrl2::runtime_error("The compressed block is truncated.");
+    }
+    const std::size_t distance = input[0] | (static_cast<std::size_t>(input[1]) << 8);
+    input += 2;
+
+    const std::size_t length = read_length(token & 15) + MinimumMatch;
+    if (distance == 0 || distance > position || output_size - position < length)
+    {
+      throw mcrl2::runtime_error("The compressed block is corrupt.");
+    }
+
+    // The match can overlap with the bytes that it produces, so it is copied byte by byte.
+    const std::uint8_t* source = output + position - distance;
+    for (std::size_t i = 0; i < length; ++i)
+    {
+      output[position + i] = source[i];
+    }
+    position += length;
+  }
+
+  if (position != output_size)
+  {
+    throw mcrl2::runtime_error("The compressed block does not have the expected size.");
+  }
+}
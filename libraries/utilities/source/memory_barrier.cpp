@@ -0,0 +1,62 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "mcrl2/utilities/memory_barrier.h"
+#include "mcrl2/utilities/platform.h"
+
+#ifdef MCRL2_PLATFORM_LINUX
+  #include <linux/membarrier.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+#ifdef MCRL2_PLATFORM_WINDOWS
+  #include <windows.h>
+#endif
+
+using namespace mcrl2::utilities;
+
+namespace
+{
+
+/// \returns True iff the operating system offers a memory barrier on all running threads of this process.
+bool register_process_wide_barrier()
+{
+#if defined(MCRL2_PLATFORM_LINUX) && defined(SYS_membarrier)
+  // The expedited barrier only interrupts the processors that run threads of this process, but must be registered.
+  long commands = syscall(SYS_membarrier, MEMBARRIER_CMD_QUERY, 0);
+  return commands >= 0
+    && (commands & MEMBARRIER_CMD_PRIVATE_EXPEDITED) != 0
+    && syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0;
+#elif defined(MCRL2_PLATFORM_WINDOWS)
+  return true;
+#else
+  return false;
+#endif
+}
+
+} // namespace
+
+bool mcrl2::utilities::detail::g_process_wide_barrier = register_process_wide_barrier();
+
+void mcrl2::utilities::heavy_memory_barrier()
+{
+  if (detail::g_process_wide_barrier)
+  {
+#if defined(MCRL2_PLATFORM_LINUX) && defined(SYS_membarrier)
+    syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0);
+#elif defined(MCRL2_PLATFORM_WINDOWS)
+    FlushProcessWriteBuffers();
+#endif
+  }
+  else
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+}
@@ -43,3 +43,38 @@ BOOST_AUTO_TEST_CASE(fixed_sequence_test)
   BOOST_CHECK_EQUAL(strcmp(output.read_string(), "function_symbol"), 0);
   BOOST_CHECK_EQUAL(output.read_integer(), 5);
 }
+
+BOOST_AUTO_TEST_CASE(word_boundary_test)
+{
+  std::stringstream stream;
+  std::vector<std::size_t> indices = { 0, 1, 2, 3, 1000, 1023 };
+
+  {
+    obitstream input(stream);
+    input.write_bits(1, 1);
+    input.write_bits(0xFFFFFFFFFFFFFFFF, 64);
+    input.write_bits(indices.data(), indices.size(), 10);
+    input.write_integer(std::numeric_limits<std::size_t>::max());
+    input.write_bits(0, 0);
+    input.write_integer(127);
+    input.write_integer(128);
+
+    // The buffer is flushed here.
+  }
+
+  // The stream consists of whole words.
+  BOOST_CHECK_EQUAL(stream.str().size() % 8, 0);
+
+  ibitstream output(stream);
+  BOOST_CHECK_EQUAL(output.read_bits(1), 1);
+  BOOST_CHECK_EQUAL(output.read_bits(64), 0xFFFFFFFFFFFFFFFF);
+
+  std::vector<std::size_t> read_indices(indices.size());
+  output.read_bits(read_indices.data(), read_indices.size(), 10);
+  BOOST_CHECK(read_indices == indices);
+
+  BOOST_CHECK_EQUAL(output.read_integer(), std::numeric_limits<std::size_t>::max());
+  BOOST_CHECK_EQUAL(output.read_bits(0), 0);
+  BOOST_CHECK_EQUAL(output.read_integer(), 127);
+  BOOST_CHECK_EQUAL(output.read_integer(), 128);
+}
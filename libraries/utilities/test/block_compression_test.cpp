@@ -0,0 +1,64 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "mcrl2/utilities/block_compression.h"
+
+#define BOOST_AUTO_TEST_MAIN
+#include <boost/test/included/unit_test.hpp>
+
+#include <random>
+
+using namespace mcrl2::utilities;
+
+/// \brief Checks that the given bytes are decompressed to themselves.
+static std::size_t round_trip(const std::vector<std::uint8_t>& input)
+{
+  std::vector<std::uint8_t> compressed = compress_block(input.data(), input.size());
+  std::vector<std::uint8_t> output(input.size());
+  decompress_block(compressed.data(), compressed.size(), output.data(), output.size());
+  BOOST_CHECK(output == input);
+  return compressed.size();
+}
+
+BOOST_AUTO_TEST_CASE(test_round_trip)
+{
+  round_trip({});
+  round_trip({ 1, 2, 3 });
+
+  // Long runs of a single byte are matches that overlap with themselves.
+  std::vector<std::uint8_t> runs(100000, 7);
+  BOOST_CHECK(round_trip(runs) < 1000);
+
+  // Random bytes can not be compressed, but barely grow.
+  std::mt19937 generator(0);
+  std::vector<std::uint8_t> random(100000);
+  for (std::uint8_t& byte : random)
+  {
+    byte = static_cast<std::uint8_t>(generator());
+  }
+  BOOST_CHECK(round_trip(random) < random.size() + random.size() / 100);
+
+  // Repetitions of a random pattern at various distances, including beyond the largest distance.
+  std::vector<std::uint8_t> repeated;
+  for (std::size_t i = 0; i < 200000; ++i)
+  {
+    repeated.push_back(random[i % 70000] ^ static_cast<std::uint8_t>(i % 997 == 0));
+  }
+  round_trip(repeated);
+}
+
+BOOST_AUTO_TEST_CASE(test_corrupt_input)
+{
+  std::vector<std::uint8_t> input(1000, 3);
+  std::vector<std::uint8_t> compressed = compress_block(input.data(), input.size());
+  std::vector<std::uint8_t> output(input.size());
+
+  BOOST_CHECK_THROW(decompress_block(compressed.data(), compressed.size() - 1, output.data(), output.size()), std::exception);
+  BOOST_CHECK_THROW(decompress_block(compressed.data(), compressed.size(), output.data(), output.size() - 1), std::exception);
+}
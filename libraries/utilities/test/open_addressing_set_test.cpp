@@ -0,0 +1,282 @@
+// Author(s): mCRL2 team
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+
+#define BOOST_AUTO_TEST_MAIN
+#include <boost/test/included/unit_test.hpp>
+
+#include <numeric>
+#include <random>
+#include <thread>
+#include <unordered_set>
+
+#include "mcrl2/utilities/open_addressing_set.h"
+
+
+using namespace mcrl2::utilities;
+
+template<typename T>
+open_addressing_set<T> construct(std::initializer_list<T> list)
+{
+  open_addressing_set<T> set;
+
+  for (auto& element : list)
+  {
+    set.emplace(element);
+  }
+
+  return set;
+}
+
+BOOST_AUTO_TEST_CASE(test_small)
+{
+  // Test with inserting 5, 3, 2, 5 expected { 2,3,5 }
+  open_addressing_set<int> set = construct({5,3,2,5});
+
+  BOOST_CHECK(set.find(5) != set.end());
+  BOOST_CHECK(set.find(2) != set.end());
+  BOOST_CHECK(set.find(3) != set.end());
+  BOOST_CHECK(set.find(4) == set.end());
+
+  BOOST_CHECK(set.count(5) != 0);
+  BOOST_CHECK(set.count(2) != 0);
+  BOOST_CHECK(set.count(3) != 0);
+
+  BOOST_CHECK(set.size() == 3);
+  BOOST_CHECK(!set.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_large)
+{
+  // Test inserting and erasing a large number of elements (tests resize behaviour and tombstones).
+  std::random_device dev;
+  std::mt19937 rng(dev());
+  std::uniform_int_distribution<std::mt19937::result_type> dist(1,10000);
+
+  open_addressing_set<int> test;
+
+  // Here, we assume that the standard library implementation is correct.
+  std::unordered_set<int> correct;
+  for (std::size_t i = 0; i < 100000; ++i)
+  {
+    auto value = dist(rng);
+    if (i % 3 == 0)
+    {
+      test.erase(value);
+      correct.erase(value);
+    }
+    else
+    {
+      test.emplace(value);
+      correct.emplace(value);
+    }
+  }
+
+  // Check that both contain the same elements.
+  for (auto& value : correct)
+  {
+    BOOST_CHECK(test.find(value) != test.end());
+  }
+
+  BOOST_CHECK(test.size() == correct.size());
+
+  for (auto& value : test)
+  {
+    BOOST_CHECK(correct.find(value) != correct.end());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_copy)
+{
+  // Test the copy constructor.
+  open_addressing_set<int> set = construct({5,3,2,5});
+
+  open_addressing_set<int> copy(set);
+  set.clear();
+
+  BOOST_CHECK(copy.find(5) != copy.end());
+  BOOST_CHECK(copy.find(2) != copy.end());
+  BOOST_CHECK(copy.find(3) != copy.end());
+  BOOST_CHECK(set.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_move)
+{
+  // Test the move constructor.
+  open_addressing_set<int> set = construct({5,3,2,5});
+  open_addressing_set<int> moved = std::move(set);
+
+  BOOST_CHECK(moved.size() == 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_empty)
+{
+  open_addressing_set<int> set(0);
+
+  BOOST_CHECK(set.empty());
+  BOOST_CHECK(set.size() == 0);
+
+  for (auto it = set.begin(); it != set.end(); ++it)
+  {
+    BOOST_CHECK(false);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_find_erase)
+{
+  // Try to erase an element using the iterator returned by find.
+  open_addressing_set<int> set = construct({5,3,2,5});
+
+  auto it = set.find(3);
+  BOOST_CHECK(it != set.end());
+  set.erase(it);
+
+  BOOST_CHECK(set.find(3) == set.end());
+  BOOST_CHECK(set.size() == 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_erase_begin)
+{
+  // Erase all elements by repeatedly erasing the first one.
+  open_addressing_set<int> set = construct({5,3,2,5});
+
+  for (auto it = set.begin(); it != set.end(); )
+  {
+    it = set.erase(it);
+  }
+
+  BOOST_CHECK(set.empty());
+}
+
+class Object
+{
+public:
+  Object(std::vector<int>&& reference)
+    : m_vector(std::forward<std::vector<int>>(reference))
+  {}
+
+  bool operator==(const Object& other) const
+  {
+    return m_vector == other.m_vector;
+  }
+
+private:
+  std::vector<int> m_vector;
+};
+
+namespace std
+{
+
+template<>
+struct hash<Object>
+{
+  std::size_t operator()(const Object&) const
+  {
+    return 0;
+  }
+};
+
+}
+
+BOOST_AUTO_TEST_CASE(test_perfect_forwarding)
+{
+  open_addressing_set<Object> objects;
+
+  // Move it into the open_addressing_set.
+  std::vector<int> test;
+  objects.emplace(std::move(test));
+}
+
+/// \brief A hash function that maps all values to a few hashes, such that the probed groups become full.
+struct colliding_hash
+{
+  std::size_t operator()(std::size_t value) const
+  {
+    return value % 4;
+  }
+};
+
+BOOST_AUTO_TEST_CASE(test_overflow)
+{
+  // Without resizing the elements that do not fit are stored in the overflow set.
+  open_addressing_set<std::size_t, colliding_hash, std::equal_to<std::size_t>, std::allocator<std::size_t>, false, false> set(16);
+
+  for (std::size_t i = 0; i < 1000; ++i)
+  {
+    BOOST_CHECK(set.emplace(i).second);
+    BOOST_CHECK(!set.emplace(i).second);
+  }
+
+  BOOST_CHECK(set.size() == 1000);
+  BOOST_CHECK(set.overflow_count() > 0);
+
+  for (std::size_t i = 0; i < 1000; ++i)
+  {
+    BOOST_CHECK(set.find(i) != set.end());
+  }
+
+  std::size_t number_of_elements = 0;
+  for (auto it = set.begin(); it != set.end(); ++it)
+  {
+    ++number_of_elements;
+  }
+  BOOST_CHECK(number_of_elements == 1000);
+
+  // Resizing moves the elements back into the table when they fit in their probe sequence.
+  set.rehash_if_needed();
+  BOOST_CHECK(set.size() == 1000);
+  for (std::size_t i = 0; i < 1000; ++i)
+  {
+    BOOST_CHECK(set.find(i) != set.end());
+  }
+
+  for (std::size_t i = 0; i < 1000; i += 2)
+  {
+    set.erase(i);
+  }
+  BOOST_CHECK(set.size() == 500);
+  BOOST_CHECK(set.find(1) != set.end());
+  BOOST_CHECK(set.find(2) == set.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_concurrent_emplace)
+{
+  // All threads insert the same elements, and every element must be inserted exactly once.
+  open_addressing_set<std::size_t, std::hash<std::size_t>, std::equal_to<std::size_t>, std::allocator<std::size_t>, true, false> set(1000);
+
+  const std::size_t number_of_threads = 4;
+  std::vector<std::size_t> inserted(number_of_threads);
+  std::vector<std::thread> threads;
+  for (std::size_t id = 0; id < number_of_threads; ++id)
+  {
+    threads.emplace_back([&, id]()
+      {
+        for (std::size_t i = 0; i < 10000; ++i)
+        {
+          if (set.emplace(i).second)
+          {
+            ++inserted[id];
+          }
+        }
+      });
+  }
+
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  BOOST_CHECK(std::accumulate(inserted.begin(), inserted.end(), std::size_t(0)) == 10000);
+  BOOST_CHECK(set.size() == 10000);
+
+  for (std::size_t i = 0; i < 10000; ++i)
+  {
+    BOOST_CHECK(set.count(i) == 1);
+  }
+}
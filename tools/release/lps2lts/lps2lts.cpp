@@ -55,6 +55,9 @@ class lps2lts_tool: public parallel_tool<rewriter_tool<input_output_tool>>
       desc.add_option("no-probability-checking", "do not check if probabilities in stochastic specifications have sensible values");
       desc.add_hidden_option("dfs-recursive", "use recursive depth first search for divergence detection");
       desc.add_option("cached", "use enumeration caching techniques to speed up state space generation. ");
+      desc.add_option("cache-size", utilities::make_mandatory_argument("NUM"),
+                 "use at most NUM MB of memory for the caches of --cached, where entries that were not used recently "
+                 "are evicted first; 0 means that the caches are unbounded (default 0). ");
       desc.add_option("todo-max", utilities::make_mandatory_argument("NUM"),
                  "keep at most NUM states in the todo list; this option is only relevant for "
                  "highway search, where NUM is the maximum number of states per level per thread. ");
@@ -100,14 +103,49 @@ class lps2lts_tool: public parallel_tool<rewriter_tool<input_output_tool>>
       desc.add_option("out", utilities::make_mandatory_argument("FORMAT"), "save the output in the specified FORMAT. ", 'o');
       desc.add_option("tau", utilities::make_mandatory_argument("NAMES"),
                  "consider actions that occur in the comma-separated list of action names "
-                 "NAMES to be internal. This setting only affects the option --divergence.");
+                 "NAMES to be internal. This setting only affects the options --divergence and --por=stutter.");
       desc.add_option("strategy", utilities::make_enum_argument<lps::exploration_strategy>("NAME")
                    .add_value_short(lps::es_breadth, "b", true)
                    .add_value_short(lps::es_depth, "d")
                    .add_value_short(lps::es_highway, "h")
         , "explore the state space using strategy NAME:"
         , 's');
+      desc.add_option("state-storage", utilities::make_enum_argument<lps::state_storage>("NAME")
+                   .add_value(lps::state_storage::terms, true)
+                   .add_value(lps::state_storage::tree)
+                   .add_value(lps::state_storage::hash_compaction)
+                   .add_value(lps::state_storage::bitstate)
+                   .add_value(lps::state_storage::disk)
+        , "store the discovered states using method NAME:");
+      desc.add_option("por", utilities::make_enum_argument<lps::partial_order_reduction>("NAME")
+                   .add_value(lps::partial_order_reduction::none, true)
+                   .add_value(lps::partial_order_reduction::deadlock)
+                   .add_value(lps::partial_order_reduction::stutter)
+        , "apply partial order reduction NAME, which cannot be combined with --confluence and --divergence:");
+      desc.add_option("disk-directory", utilities::make_mandatory_argument("DIR"),
+                 "store the temporary files in directory DIR (default: the temporary directory of the system); "
+                 "this option is only relevant for the state storage disk. ");
+      desc.add_option("memory-budget", utilities::make_mandatory_argument("NUM"),
+                 "use at most NUM MB of memory for sorting the transitions of a level (default 1024); "
+                 "this option is only relevant for the state storage disk. ");
+      desc.add_option("fingerprint-bits", utilities::make_mandatory_argument("NUM"),
+                 "use fingerprints of NUM bits, with 1 <= NUM <= 64 (default 64); this option is only relevant for "
+                 "the state storage hash-compaction. ");
+      desc.add_option("bitstate-size", utilities::make_mandatory_argument("NUM"),
+                 "use a bit array of 2^NUM bits, with 6 <= NUM <= 40 (default 30); this option is only relevant for "
+                 "the state storage bitstate. ");
+      desc.add_option("hash-functions", utilities::make_mandatory_argument("NUM"),
+                 "set NUM bits per state in the bit array (default 3); this option is only relevant for "
+                 "the state storage bitstate. ");
       desc.add_option("suppress","in verbose mode, do not print progress messages indicating the number of visited states and transitions.");
+      desc.add_option("checkpoint", utilities::make_mandatory_argument("FILE"),
+                 "periodically save a checkpoint of the exploration to FILE, from which it can be resumed using --resume. "
+                 "This requires a single thread, breadth-first or depth-first search, and the state storage terms or tree. "
+                 "When the output is in .lts format, --save-at-end is required as well. ");
+      desc.add_option("checkpoint-interval", utilities::make_mandatory_argument("NUM"),
+                 "save a checkpoint every NUM seconds (default 600); this option is only relevant in combination with --checkpoint. ");
+      desc.add_option("resume", "resume the exploration from the checkpoint that is given by --checkpoint. "
+                 "The other options and the output file must be the same as those of the exploration that wrote the checkpoint. ");
       desc.add_option("save-at-end", "delay saving of the generated LTS until the end. "
                  "This option only applies to .aut and .lts files, which are by default saved on the fly.");
       desc.add_option("no-info", "do not add state label information to OUTFILE. This option only applies to .lts files.");
@@ -216,7 +254,37 @@ class lps2lts_tool: public parallel_tool<rewriter_tool<input_output_tool>>
       options.dfs_recursive                         = parser.has_option("dfs-recursive");
       options.discard_lts_state_labels              = parser.has_option("no-info");
       options.search_strategy = parser.option_argument_as<lps::exploration_strategy>("strategy");
+      options.state_storage = parser.option_argument_as<lps::state_storage>("state-storage");
+      options.partial_order_reduction = parser.option_argument_as<lps::partial_order_reduction>("por");
+      if (parser.has_option("fingerprint-bits"))
+      {
+        options.fingerprint_bits = parser.option_argument_as<std::size_t>("fingerprint-bits");
+      }
+      if (parser.has_option("bitstate-size"))
+      {
+        options.bitstate_bits = parser.option_argument_as<std::size_t>("bitstate-size");
+      }
+      if (parser.has_option("hash-functions"))
+      {
+        options.bitstate_hash_functions = parser.option_argument_as<std::size_t>("hash-functions");
+      }
+      if (parser.has_option("disk-directory"))
+      {
+        options.disk_directory = parser.option_argument("disk-directory");
+      }
+      if (parser.has_option("memory-budget"))
+      {
+        options.memory_budget = parser.option_argument_as<std::size_t>("memory-budget");
+      }
+      if (parser.has_option("cache-size"))
+      {
+        options.cache_size = parser.option_argument_as<std::size_t>("cache-size");
+      }
       options.number_of_threads = number_of_threads();
+      if (options.state_storage == lps::state_storage::disk && (options.search_strategy != lps::es_breadth || options.number_of_threads > 1))
+      {
+        parser.error("State storage 'disk' requires breadth-first search in a single thread.");
+      }
       // highway search
       if (parser.has_option("todo-max"))
       {
@@ -250,6 +318,11 @@ class lps2lts_tool: public parallel_tool<rewriter_tool<input_output_tool>>
         }
       }
 
+      if (lps::is_probabilistic(options.state_storage) && !output_filename().empty())
+      {
+        parser.error("An LTS cannot be generated with state storage '" + lps::print_state_storage(options.state_storage) + "'.");
+      }
+
       if (parser.has_option("action"))
       {
         options.detect_action = true;
@@ -278,9 +351,9 @@ class lps2lts_tool: public parallel_tool<rewriter_tool<input_output_tool>>
 
       if (parser.has_option("tau"))
       {
-        if (!parser.has_option("divergence"))
+        if (!parser.has_option("divergence") && options.partial_order_reduction != lps::partial_order_reduction::stutter)
         {
-          parser.error("Option --tau requires the option --divergence.");
+          parser.error("Option --tau requires the option --divergence or --por=stutter.");
         }
         std::list<std::string> actions = split_actions(parser.option_argument("tau"));
         for (const std::string& s: actions)
@@ -294,6 +367,18 @@ class lps2lts_tool: public parallel_tool<rewriter_tool<input_output_tool>>
         options.confluence_action = parser.option_argument("confluence");
       }
 
+      if (options.partial_order_reduction != lps::partial_order_reduction::none)
+      {
+        if (parser.has_option("confluence") || options.detect_divergence)
+        {
+          parser.error("Option '--por' cannot be combined with the options '--confluence' and '--divergence'.");
+        }
+        if (options.state_storage == lps::state_storage::disk)
+        {
+          parser.error("Option '--por' cannot be combined with the state storage disk.");
+        }
+      }
+
       if (2 < parser.arguments.size())
       {
         parser.error("Too many file arguments.");
@@ -310,6 +395,32 @@ class lps2lts_tool: public parallel_tool<rewriter_tool<input_output_tool>>
       {
         parser.error("Option '--no-info' requires that the output is in .lts format.");
       }
+
+      if (parser.has_option("checkpoint"))
+      {
+        options.checkpoint_file = parser.option_argument("checkpoint");
+        if (parser.has_option("checkpoint-interval"))
+        {
+          options.checkpoint_interval = parser.option_argument_as<std::size_t>("checkpoint-interval");
+        }
+        options.resume = parser.has_option("resume");
+        if (options.number_of_threads > 1 || options.search_strategy == lps::es_highway)
+        {
+          parser.error("Option '--checkpoint' requires breadth-first or depth-first search in a single thread.");
+        }
+        if (options.state_storage != lps::state_storage::terms && options.state_storage != lps::state_storage::tree)
+        {
+          parser.error("Option '--checkpoint' requires the state storage terms or tree.");
+        }
+        if (output_format == lts::lts_lts && !options.save_at_end)
+        {
+          parser.error("Option '--checkpoint' requires option '--save-at-end' when the output is in .lts format.");
+        }
+      }
+      else if (parser.has_option("resume") || parser.has_option("checkpoint-interval"))
+      {
+        parser.error("Options '--resume' and '--checkpoint-interval' require option '--checkpoint'.");
+      }
       if (options.number_of_threads>1)
       { 
          /* if (options.detect_divergence)
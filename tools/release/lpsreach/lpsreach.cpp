@@ -95,6 +95,7 @@ class lpsreach_tool: public parallel_tool<rewriter_tool<input_output_tool>>
       options.rewrite_strategy                      = rewrite_strategy();
       options.dot_file                              = parser.option_argument("dot");
       lace_n_workers = number_of_threads();
+      options.max_workers = number_of_threads();
       if (parser.has_option("lace-dqsize"))
       {
         lace_dqsize = parser.option_argument_as<int>("lace-dqsize");